@@ -781,28 +781,31 @@ cdef class CoreWorker:
             shared_ptr[CBuffer] metadata
             int64_t put_threshold
             c_bool put_small_object_in_memory_store
-            c_vector[CObjectID] c_object_id_vector
+            c_vector[CObjectID] contained_ids
 
         metadata = string_to_buffer(serialized_object.metadata)
         put_threshold = RayConfig.instance().max_direct_call_object_size()
         put_small_object_in_memory_store = (
             RayConfig.instance().put_small_object_in_memory_store())
         total_bytes = serialized_object.total_bytes
+        contained_ids = ObjectRefsToVector(
+            serialized_object.contained_object_refs)
         object_already_exists = self._create_put_buffer(
-            metadata, total_bytes, object_ref,
-            ObjectRefsToVector(serialized_object.contained_object_refs),
+            metadata, total_bytes, object_ref, contained_ids,
             &c_object_id, &data)
 
         if not object_already_exists:
             if total_bytes > 0:
                 (<SerializedObject>serialized_object).write_to(
                     Buffer.make(data))
+            # Objects with a pre-existing object ref are always created in
+            # plasma.
             if self.is_local_mode or (put_small_object_in_memory_store
-               and <int64_t>total_bytes < put_threshold):
-                c_object_id_vector.push_back(c_object_id)
+               and <int64_t>total_bytes < put_threshold
+               and object_ref is None):
                 check_status(CCoreWorkerProcess.GetCoreWorker().Put(
-                        CRayObject(data, metadata, c_object_id_vector),
-                        c_object_id_vector, c_object_id))
+                        CRayObject(data, metadata, contained_ids),
+                        contained_ids, c_object_id))
             else:
                 with nogil:
                     # Using custom object refs is not supported because we
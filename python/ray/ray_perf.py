@@ -93,6 +93,33 @@ def timeit(name, fn, multiplier=1):
           round(np.std(stats), 2))
 
 
+def timeit_put_get_by_size(suffix=""):
+    for size in [100, 1000, 10 * 1000, 100 * 1000]:
+        data = np.zeros(size, dtype=np.uint8)
+        value = ray.put(data)
+
+        def put():
+            ray.put(data)
+
+        def get():
+            ray.get(value)
+
+        timeit("single client put calls ({} B){}".format(size, suffix), put)
+        timeit("single client get calls ({} B){}".format(size, suffix), get)
+
+
+def timeit_actor_startup(suffix=""):
+    # Each actor needs a new worker process, so this measures how fast the
+    # raylet starts workers.
+    def start_actors():
+        actors = [Actor.remote() for _ in range(10)]
+        ray.get([a.small_value.remote() for a in actors])
+        for a in actors:
+            ray.kill(a)
+
+    timeit("actor creations{}".format(suffix), start_actors, 10)
+
+
 def check_optimized_build():
     if not ray._raylet.OPTIMIZED:
         msg = ("WARNING: Unoptimized build! "
@@ -137,6 +164,8 @@ def main():
 
     timeit("multi client put calls", put_multi_small, 1000)
 
+    timeit_put_get_by_size()
+
     ray.shutdown()
     ray.init(
         _internal_config=json.dumps({
@@ -152,6 +181,8 @@ def main():
 
     timeit("multi client put calls (Plasma Store)", put_multi_small, 1000)
 
+    timeit_put_get_by_size(" (Plasma Store)")
+
     def put_large():
         ray.put(arr)
 
@@ -285,6 +316,17 @@ def main():
 
     timeit("n:n async-actor calls async", async_actor_multi, m * n)
 
+    timeit_actor_startup()
+
+    ray.shutdown()
+    ray.init(
+        _internal_config=json.dumps({
+            "put_small_object_in_memory_store": True,
+            "worker_fork_server_enabled": True
+        }))
+
+    timeit_actor_startup(" (fork server)")
+
 
 if __name__ == "__main__":
     main()
@@ -685,6 +685,50 @@ def test_get_correct_node_ip():
         assert found_ip == "10.0.0.111"
 
 
+@pytest.mark.parametrize("put_small_object_in_memory_store", [True, False])
+def test_put_small_objects(shutdown_only, put_small_object_in_memory_store):
+    config = json.dumps({
+        "put_small_object_in_memory_store": put_small_object_in_memory_store
+    })
+    ray.init(num_cpus=2, _internal_config=config)
+
+    @ray.remote
+    def identity(x):
+        return x
+
+    @ray.remote
+    def get_nested(refs):
+        return ray.get(refs[0])
+
+    @ray.remote
+    class Borrower:
+        def set(self, refs):
+            self.ref = refs[0]
+
+        def get(self):
+            return ray.get(self.ref)
+
+    for value in [b"", b"x" * 100, list(range(100))]:
+        ref = ray.put(value)
+        assert ray.get(ref) == value
+        # Passed by value, the object is inlined into the task's arguments.
+        assert ray.get(identity.remote(ref)) == value
+        # Passed by reference, the borrower resolves the object from the owner.
+        assert ray.get(get_nested.remote([ref])) == value
+        borrower = Borrower.remote()
+        ray.get(borrower.set.remote([ref]))
+        del ref
+        # The borrower keeps the object alive once the owner's ref is gone.
+        assert ray.get(borrower.get.remote()) == value
+
+    # Small objects that contain refs keep the inner objects alive.
+    inner = ray.put(1)
+    outer = ray.put([inner])
+    del inner
+    assert ray.get(get_nested.remote(outer)) == 1
+    assert ray.get(ray.get(identity.remote(outer))[0]) == 1
+
+
 if __name__ == "__main__":
     import pytest
     sys.exit(pytest.main(["-v", __file__]))
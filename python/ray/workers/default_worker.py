@@ -1,5 +1,11 @@
 import argparse
 import json
+import os
+import select
+import signal
+import socket
+import struct
+import sys
 
 import ray
 import ray.actor
@@ -80,12 +86,71 @@ parser.add_argument(
     default=False,
     action="store_true",
     help="True if cloudpickle should be used for serialization.")
+parser.add_argument(
+    "--fork-server-socket",
+    required=False,
+    type=str,
+    default=None,
+    help="If set, run as a fork server that listens on this socket and "
+    "forks a new worker for each request from the raylet.")
+
+
+def run_fork_server(socket_name):
+    """Fork new workers on request from the raylet.
+
+    This process has already imported Ray, so forked workers skip the
+    interpreter startup and imports that dominate worker startup time. Each
+    request is a single byte and the reply is the pid of the new worker. This
+    function only returns in the forked workers, which then start up like a
+    worker started by the raylet. The fork server exits once the raylet is gone.
+
+    Args:
+        socket_name (str): The path of the Unix socket to listen on.
+    """
+    raylet_pid = os.getppid()
+    # The raylet does not wait for its workers, so neither do we.
+    signal.signal(signal.SIGCHLD, signal.SIG_IGN)
+    if os.path.exists(socket_name):
+        os.unlink(socket_name)
+    server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    server.bind(socket_name)
+    server.listen(1)
+    conn = None
+    while os.getppid() == raylet_pid:
+        ready, _, _ = select.select([conn or server], [], [], 1.0)
+        if not ready:
+            continue
+        if conn is None:
+            conn, _ = server.accept()
+            continue
+        if not conn.recv(1):
+            # The raylet closed the connection, so wait for it to reconnect.
+            conn.close()
+            conn = None
+            continue
+        pid = os.fork()
+        if pid == 0:
+            conn.close()
+            server.close()
+            signal.signal(signal.SIGCHLD, signal.SIG_DFL)
+            # Don't let workers share the random state of the fork server.
+            import random
+            random.seed()
+            if "numpy" in sys.modules:
+                sys.modules["numpy"].random.seed()
+            return
+        conn.sendall(struct.pack("i", pid))
+    sys.exit(0)
+
 
 if __name__ == "__main__":
     args = parser.parse_args()
 
     ray.utils.setup_logger(args.logging_level, args.logging_format)
 
+    if args.fork_server_socket is not None:
+        run_fork_server(args.fork_server_socket)
+
     internal_config = {}
     if args.config_list is not None:
         config_list = args.config_list.split(",")
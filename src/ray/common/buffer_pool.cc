@@ -0,0 +1,113 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/buffer_pool.h"
+
+#include <cstring>
+
+namespace ray {
+
+/// A buffer whose memory came from a BufferPool.
+class PooledBuffer : public Buffer {
+ public:
+  PooledBuffer(std::shared_ptr<BufferPool> pool, size_t size_class,
+               std::unique_ptr<uint8_t[]> data, size_t size)
+      : pool_(std::move(pool)),
+        size_class_(size_class),
+        data_(std::move(data)),
+        size_(size) {}
+
+  uint8_t *Data() const override { return data_.get(); }
+
+  size_t Size() const override { return size_; }
+
+  bool OwnsData() const override { return true; }
+
+  bool IsPlasmaBuffer() const override { return false; }
+
+  ~PooledBuffer() { pool_->Release(size_class_, std::move(data_)); }
+
+ private:
+  PooledBuffer &operator=(const PooledBuffer &) = delete;
+  PooledBuffer(const PooledBuffer &) = delete;
+
+  /// The pool to return the memory to.
+  std::shared_ptr<BufferPool> pool_;
+  /// The size class of the memory.
+  const size_t size_class_;
+  /// The memory, which is at least as large as the size class.
+  std::unique_ptr<uint8_t[]> data_;
+  /// The requested size of the buffer.
+  const size_t size_;
+};
+
+std::shared_ptr<BufferPool> BufferPool::Create(size_t max_buffer_size,
+                                               size_t max_pooled_bytes) {
+  return std::shared_ptr<BufferPool>(new BufferPool(max_buffer_size, max_pooled_bytes));
+}
+
+BufferPool::BufferPool(size_t max_buffer_size, size_t max_pooled_bytes)
+    : max_buffer_size_(max_buffer_size), max_pooled_bytes_(max_pooled_bytes) {
+  free_buffers_.resize(SizeClass(max_buffer_size) + 1);
+}
+
+size_t BufferPool::SizeClass(size_t size) const {
+  size_t size_class = 0;
+  while ((kMinBufferSize << size_class) < size) {
+    size_class++;
+  }
+  return size_class;
+}
+
+std::shared_ptr<Buffer> BufferPool::Allocate(size_t size) {
+  if (size > max_buffer_size_ || max_pooled_bytes_ == 0) {
+    return std::make_shared<LocalMemoryBuffer>(size);
+  }
+  const size_t size_class = SizeClass(size);
+  std::unique_ptr<uint8_t[]> data;
+  {
+    absl::MutexLock lock(&mu_);
+    auto &free_buffers = free_buffers_[size_class];
+    if (!free_buffers.empty()) {
+      data = std::move(free_buffers.back());
+      free_buffers.pop_back();
+      pooled_bytes_ -= kMinBufferSize << size_class;
+    }
+  }
+  if (!data) {
+    data.reset(new uint8_t[kMinBufferSize << size_class]);
+  }
+  // Zero the buffer like LocalMemoryBuffer does, so that a reused buffer does
+  // not leak the bytes of the object that it held before.
+  std::memset(data.get(), 0, size);
+  return std::make_shared<PooledBuffer>(shared_from_this(), size_class, std::move(data),
+                                        size);
+}
+
+void BufferPool::Release(size_t size_class, std::unique_ptr<uint8_t[]> data) {
+  const size_t class_size = kMinBufferSize << size_class;
+  absl::MutexLock lock(&mu_);
+  if (pooled_bytes_ + class_size <= max_pooled_bytes_) {
+    free_buffers_[size_class].push_back(std::move(data));
+    pooled_bytes_ += class_size;
+  }
+  // Otherwise, the memory is freed when data goes out of scope.
+}
+
+size_t BufferPool::PooledBytes() const {
+  absl::MutexLock lock(&mu_);
+  return pooled_bytes_;
+}
+
+}  // namespace ray
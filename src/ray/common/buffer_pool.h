@@ -0,0 +1,81 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "ray/common/buffer.h"
+
+namespace ray {
+
+/// A pool of local memory buffers for small objects. Buffers are grouped into
+/// power-of-two size classes, and the memory of a buffer is given back to the
+/// pool when the last reference to it is dropped. A later allocation of the
+/// same size class then reuses that memory instead of going to malloc.
+///
+/// This class is thread-safe.
+class BufferPool : public std::enable_shared_from_this<BufferPool> {
+ public:
+  /// Create a buffer pool.
+  ///
+  /// \param max_buffer_size The largest buffer that is allocated from the
+  /// pool. Larger buffers are allocated directly and never pooled.
+  /// \param max_pooled_bytes The maximum number of bytes of freed buffers to
+  /// keep for reuse.
+  static std::shared_ptr<BufferPool> Create(size_t max_buffer_size,
+                                            size_t max_pooled_bytes);
+
+  /// Allocate a buffer. Like LocalMemoryBuffer, the contents of the buffer
+  /// are zeroed.
+  ///
+  /// \param size The size of the buffer.
+  /// \return The buffer. It keeps the pool alive until it is destroyed.
+  std::shared_ptr<Buffer> Allocate(size_t size);
+
+  /// The number of bytes of freed buffers that are currently kept for reuse.
+  size_t PooledBytes() const;
+
+ private:
+  friend class PooledBuffer;
+
+  BufferPool(size_t max_buffer_size, size_t max_pooled_bytes);
+
+  /// Return the index of the smallest size class that fits the given size.
+  size_t SizeClass(size_t size) const;
+
+  /// Give the memory of a destroyed buffer back to the pool.
+  void Release(size_t size_class, std::unique_ptr<uint8_t[]> data);
+
+  /// The size of the smallest size class.
+  static constexpr size_t kMinBufferSize = 64;
+
+  /// The largest buffer that is allocated from the pool.
+  const size_t max_buffer_size_;
+
+  /// The maximum number of bytes of freed buffers to keep for reuse.
+  const size_t max_pooled_bytes_;
+
+  mutable absl::Mutex mu_;
+
+  /// The freed buffers of each size class.
+  std::vector<std::vector<std::unique_ptr<uint8_t[]>>> free_buffers_ GUARDED_BY(mu_);
+
+  /// The total size of the buffers in free_buffers_.
+  size_t pooled_bytes_ GUARDED_BY(mu_) = 0;
+};
+
+}  // namespace ray
@@ -32,10 +32,11 @@ class MessageWrapper {
   MessageWrapper() : message_(std::make_shared<Message>()) {}
 
   /// Construct from a protobuf message object.
-  /// The input message will be **copied** into this object.
+  /// The input message will be **copied** into this object, unless it is
+  /// passed as an rvalue.
   ///
   /// \param message The protobuf message.
-  explicit MessageWrapper(const Message message)
+  explicit MessageWrapper(Message message)
       : message_(std::make_shared<Message>(std::move(message))) {}
 
   /// Construct from a protobuf message shared_ptr.
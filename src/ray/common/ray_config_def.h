@@ -116,6 +116,11 @@ RAY_CONFIG(bool, new_scheduler_enabled, false)
 // Objects larger than this size will be spilled/promoted to plasma.
 RAY_CONFIG(int64_t, max_direct_call_object_size, 100 * 1024)
 
+// The maximum number of bytes of freed buffers that a worker keeps for reuse
+// when allocating objects smaller than max_direct_call_object_size, e.g. task
+// return values. Set to 0 to allocate a new buffer for every object.
+RAY_CONFIG(int64_t, local_buffer_pool_bytes, 8 * 1024 * 1024)
+
 // The max gRPC message size (the gRPC internal default is 4MB). We use a higher
 // limit in Ray to avoid crashing with many small inlined task arguments.
 RAY_CONFIG(int64_t, max_grpc_message_size, 100 * 1024 * 1024)
@@ -196,6 +201,27 @@ RAY_CONFIG(int64_t, kill_worker_timeout_milliseconds, 100)
 /// starting_worker_timeout_callback() is called.
 RAY_CONFIG(int64_t, worker_register_timeout_seconds, 30)
 
+/// Whether the raylet starts new Python workers by asking a fork server to fork
+/// them. The fork server is a Python worker process that has already imported
+/// Ray, so forked workers start much faster than new interpreters. Workers are
+/// started by exec'ing the worker command while the fork server starts up, for
+/// actors with dynamic worker options, and if the fork server fails.
+RAY_CONFIG(bool, worker_fork_server_enabled, false)
+
+/// The maximum number of idle workers per language that the worker pool starts
+/// ahead of demand. The pool sizes this buffer from the backlog reported with
+/// worker lease requests and from recent PopWorker misses. 0 disables
+/// prestarting.
+RAY_CONFIG(int64_t, max_prestarted_idle_workers, 0)
+
+/// The length of the periods in which the worker pool counts PopWorker misses
+/// to predict demand.
+RAY_CONFIG(int64_t, worker_demand_period_ms, 1000)
+
+/// Prestarted workers that have stayed idle this long without running a task
+/// are killed, unless recent demand calls for them.
+RAY_CONFIG(int64_t, prestarted_worker_idle_timeout_ms, 60000)
+
 /// This is a timeout used to cause failures in the plasma manager and raylet
 /// when certain event loop handlers take too long.
 RAY_CONFIG(int64_t, max_time_for_handler_milliseconds, 1000)
@@ -215,6 +241,18 @@ RAY_CONFIG(int64_t, L3_cache_size_bytes, 100000000)
 /// Constants for the spillback scheduling policy.
 RAY_CONFIG(int64_t, max_tasks_to_spillback, 10)
 
+/// When a task can run on several nodes, the raylet packs it onto a node whose
+/// utilization of the resources that the task needs is below this fraction: the
+/// local node if possible, otherwise the busiest such node. Utilization includes
+/// the tasks queued at each node. Once every candidate is at or above this
+/// fraction, the raylet spreads tasks instead. If 0, tasks are always spread.
+RAY_CONFIG(float, scheduler_spread_threshold, 0.5)
+
+/// When spreading tasks, the raylet samples this many candidate nodes at random
+/// and places the task on the least utilized of them. If 1, tasks are spread
+/// uniformly at random.
+RAY_CONFIG(int64_t, scheduler_spread_num_samples, 2)
+
 /// Every time an actor creation task has been spilled back a number of times
 /// that is a multiple of this quantity, a warning will be pushed to the
 /// corresponding driver. Since spillback currently occurs on a 100ms timer,
@@ -239,6 +277,34 @@ RAY_CONFIG(int, object_manager_push_timeout_ms, 10000)
 /// same object again to a specific object manager.
 RAY_CONFIG(int, object_manager_repeated_push_delay_ms, 60000)
 
+/// The maximum number of object chunks that an object manager sends to a single
+/// remote object manager before waiting for acknowledgements. This bounds the
+/// memory used to push large objects.
+RAY_CONFIG(int, object_manager_max_chunks_in_flight_per_node, 16)
+
+/// The maximum number of remote object managers that a single object is pulled
+/// from in parallel. Each of them sends a disjoint subset of the chunks.
+RAY_CONFIG(int, object_manager_max_pull_sources, 4)
+
+/// If positive, pull requests for the same object that arrive within this many
+/// milliseconds are served as one broadcast: the object is pushed to a few of
+/// the requesting nodes, which forward each chunk to the others as it arrives.
+/// If 0, every pull request is served with its own push.
+RAY_CONFIG(int, object_manager_broadcast_batch_ms, 0)
+
+/// The number of nodes that each node forwards chunks to in a broadcast. A
+/// value of 1 forwards the object along a chain.
+RAY_CONFIG(int, object_manager_broadcast_fan_out, 2)
+
+/// The codec that the object manager compresses object chunks with before
+/// sending them to other nodes: "zlib", or "" for no compression. This is
+/// useful when the network between nodes is slow.
+RAY_CONFIG(std::string, object_manager_compression_codec, "")
+
+/// A chunk is only sent compressed if a sample of it compresses to less than
+/// this fraction of its size. Other chunks are sent as they are.
+RAY_CONFIG(float, object_manager_compression_min_ratio, 0.8)
+
 /// Default chunk size for multi-chunk transfers to use in the object manager.
 /// In the object manager, no single thread is permitted to transfer more
 /// data than what is specified by the chunk size unless the number of object
@@ -293,6 +359,57 @@ RAY_CONFIG(int32_t, object_store_full_max_retries, 5)
 /// This will be exponentially increased for each retry.
 RAY_CONFIG(uint32_t, object_store_full_initial_delay_ms, 1000)
 
+/// Whether to touch every page of the plasma store's memory when it is mapped,
+/// so that page faults are taken at startup instead of when objects are first
+/// created. This commits all of the store's memory up front.
+RAY_CONFIG(bool, plasma_prefault_memory, false)
+/// The number of threads used to pre-fault the plasma store's memory.
+RAY_CONFIG(int, plasma_prefault_threads, 8)
+/// Whether to back the plasma store's memory with transparent huge pages when
+/// explicit huge pages are not used. On Linux this requires
+/// /sys/kernel/mm/transparent_hugepage/shmem_enabled to be "advise".
+RAY_CONFIG(bool, plasma_transparent_huge_pages, false)
+/// The NUMA placement of the plasma store's memory on Linux. If empty, pages
+/// are placed on the node that first touches them. "interleave" interleaves
+/// pages across all online nodes, and "interleave:<nodes>" or "bind:<nodes>"
+/// interleave across or bind to a node list such as "0-1".
+RAY_CONFIG(std::string, plasma_numa_policy, "")
+
+/// The number of messages in each ring of the shared memory channel that the
+/// plasma store creates for each client, which carries Release and Contains
+/// requests instead of the store's socket. 0 disables the channel. The
+/// channel is only supported on Linux.
+RAY_CONFIG(int64_t, plasma_channel_capacity, 0)
+
+/// The order in which the plasma store evicts objects that are not in use. One
+/// of "lru", "gdsf", "lfuda" or "cost_aware"; see plasma::ObjectCaches.
+RAY_CONFIG(std::string, plasma_eviction_policy, "lru")
+
+/// Whether the plasma store evicts unused objects in the background once the
+/// memory in use is above plasma_eviction_high_watermark, until it is below
+/// plasma_eviction_low_watermark. Creating an object then only evicts
+/// synchronously when the store is full. Ignored if objects are spilled.
+RAY_CONFIG(bool, plasma_background_eviction_enabled, false)
+RAY_CONFIG(float, plasma_eviction_high_watermark, 0.9)
+RAY_CONFIG(float, plasma_eviction_low_watermark, 0.8)
+/// The maximum number of bytes evicted in one background eviction step, so
+/// that client requests can be served between steps.
+RAY_CONFIG(int64_t, plasma_background_eviction_batch_bytes, 64 * 1024 * 1024)
+
+/// The directory that the plasma store spills objects to when it runs low on
+/// memory. Spilled objects are restored transparently when they are accessed.
+/// Spilling is disabled if this is empty.
+RAY_CONFIG(std::string, object_spilling_directory, "")
+/// Once the fraction of plasma memory in use exceeds this value, the plasma
+/// store starts spilling unused objects in the background.
+RAY_CONFIG(float, object_spilling_high_watermark, 0.8)
+/// Background spilling stops once the fraction of plasma memory in use drops
+/// below this value.
+RAY_CONFIG(float, object_spilling_low_watermark, 0.6)
+/// The maximum number of bytes to spill in a single batch. All objects in a
+/// batch are written to the same file.
+RAY_CONFIG(int64_t, object_spilling_max_batch_bytes, 256 * 1024 * 1024)
+
 /// Duration to wait between retries for failed tasks.
 RAY_CONFIG(uint32_t, task_retry_delay_ms, 5000)
 
@@ -322,8 +439,12 @@ RAY_CONFIG(int64_t, metrics_report_batch_size, 100)
 /// Whether or not we enable metrics collection.
 RAY_CONFIG(int64_t, enable_metrics_collection, true)
 
-/// Whether start the Plasma Store as a Raylet thread.
-RAY_CONFIG(bool, put_small_object_in_memory_store, false)
+/// Whether to store the values of ray.put calls that are smaller than
+/// max_direct_call_object_size in the owner's memory store instead of plasma.
+/// These objects are inlined into the arguments of tasks that depend on them
+/// and into the replies to GetObjectStatus, and are only promoted to plasma if
+/// their reference is serialized.
+RAY_CONFIG(bool, put_small_object_in_memory_store, true)
 
 /// Metric agent port for reporting, default -1 means no such agent will be
 /// listening.
@@ -333,3 +454,46 @@ RAY_CONFIG(int, metrics_agent_port, -1)
 /// the owner has been granted a lease. A value >1 is used when we want to enable
 /// pipelining task submission.
 RAY_CONFIG(uint32_t, max_tasks_in_flight_per_worker, 1)
+
+/// If nonzero, the owner adjusts the number of tasks in flight to each leased worker
+/// based on the measured execution time and RPC latency of each scheduling class, up
+/// to this many tasks. This replaces max_tasks_in_flight_per_worker.
+RAY_CONFIG(uint32_t, max_adaptive_tasks_in_flight_per_worker, 0)
+
+/// Tasks of a scheduling class that take longer than this on average are not
+/// pipelined by the adaptive mode, so that they cannot block shorter tasks queued
+/// behind them on the same worker.
+RAY_CONFIG(int64_t, adaptive_pipelining_max_task_duration_us, 10000)
+
+/// The maximum number of tasks that an owner sends to a worker in one PushTasks
+/// request. Tasks for the same worker that are submitted close together are
+/// coalesced into one request, and the worker replies once all of them have
+/// finished. A value of 1 disables batching.
+RAY_CONFIG(int64_t, max_push_task_batch_size, 1)
+
+/// The maximum estimated size in bytes of a batch of tasks sent in one request.
+RAY_CONFIG(int64_t, max_push_task_batch_bytes, 1024 * 1024)
+
+/// How long to wait for more tasks before sending a batch that is not full, in
+/// microseconds. If 0, the batch is sent on the next turn of the event loop.
+RAY_CONFIG(int64_t, push_task_batch_linger_us, 100)
+
+/// The number of shards that a worker's in-memory object store is split into. Each
+/// shard has its own lock.
+RAY_CONFIG(int64_t, memory_store_num_shards, 32)
+
+/// The number of queued tasks from each caller whose arguments an actor fetches
+/// ahead of time, while the tasks ahead of them execute. If 0, the arguments of all
+/// queued tasks are fetched as soon as the tasks arrive.
+RAY_CONFIG(int64_t, actor_task_args_prefetch_depth, 10)
+
+/// The number of local reference removals from the language frontend that a thread
+/// buffers before applying them to the worker's reference table at once. Buffered
+/// removals are also applied when a task finishes and periodically. If 0, removals
+/// are applied immediately.
+RAY_CONFIG(int64_t, local_reference_batch_size, 0)
+
+/// Maximum number of worker lease requests that an owner keeps in flight for each
+/// scheduling class. The owner never has more lease requests in flight than it has
+/// tasks queued for that class.
+RAY_CONFIG(int64_t, max_pending_lease_requests_per_scheduling_class, 10)
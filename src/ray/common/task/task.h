@@ -2,6 +2,8 @@
 
 #include <inttypes.h>
 
+#include <unordered_map>
+
 #include "ray/common/task/task_common.h"
 #include "ray/common/task/task_execution_spec.h"
 #include "ray/common/task/task_spec.h"
@@ -62,6 +64,12 @@ class Task {
     on_cancellation_ = callback;
   }
 
+  /// Set the number of bytes of the task's arguments that are stored on each
+  /// node, as reported by the task's owner.
+  void SetArgBytesByNode(std::unordered_map<ClientID, int64_t> arg_bytes_by_node) {
+    arg_bytes_by_node_ = std::move(arg_bytes_by_node);
+  }
+
   /// Get the mutable specification for the task. This specification may be
   /// updated at runtime.
   ///
@@ -95,6 +103,12 @@ class Task {
   /// Returns the cancellation task callback, or nullptr.
   const CancelTaskCallback &OnCancellation() const { return on_cancellation_; }
 
+  /// Returns the number of bytes of the task's arguments that are stored on
+  /// each node. Nodes that are not in the map are not known to store any.
+  const std::unordered_map<ClientID, int64_t> &ArgBytesByNode() const {
+    return arg_bytes_by_node_;
+  }
+
   std::string DebugString() const;
 
  private:
@@ -121,6 +135,9 @@ class Task {
   /// For direct task calls, overrides the cancellation behaviour to send an
   /// RPC back to the submitting worker.
   mutable CancelTaskCallback on_cancellation_ = nullptr;
+  /// For direct task calls, the number of bytes of the task's arguments that
+  /// the owner knows to be stored on each node.
+  std::unordered_map<ClientID, int64_t> arg_bytes_by_node_;
 };
 
 }  // namespace ray
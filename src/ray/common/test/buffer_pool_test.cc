@@ -0,0 +1,97 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/common/buffer_pool.h"
+
+#include <cstring>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+TEST(BufferPoolTest, TestReuse) {
+  auto pool = BufferPool::Create(/*max_buffer_size=*/1024, /*max_pooled_bytes=*/4096);
+  auto buffer = pool->Allocate(100);
+  ASSERT_EQ(buffer->Size(), 100);
+  ASSERT_FALSE(buffer->IsPlasmaBuffer());
+  uint8_t *data = buffer->Data();
+  ASSERT_EQ(pool->PooledBytes(), 0);
+  buffer.reset();
+  // The buffer's memory is rounded up to the next size class.
+  ASSERT_EQ(pool->PooledBytes(), 128);
+
+  // A buffer of the same size class reuses the memory.
+  buffer = pool->Allocate(120);
+  ASSERT_EQ(buffer->Size(), 120);
+  ASSERT_EQ(buffer->Data(), data);
+  ASSERT_EQ(pool->PooledBytes(), 0);
+
+  // A buffer of a different size class does not.
+  auto other = pool->Allocate(10);
+  ASSERT_NE(other->Data(), data);
+  buffer.reset();
+  other.reset();
+  ASSERT_EQ(pool->PooledBytes(), 128 + 64);
+}
+
+TEST(BufferPoolTest, TestReusedBufferIsZeroed) {
+  auto pool = BufferPool::Create(/*max_buffer_size=*/1024, /*max_pooled_bytes=*/4096);
+  auto buffer = pool->Allocate(100);
+  uint8_t *data = buffer->Data();
+  std::memset(data, 0xff, buffer->Size());
+  buffer.reset();
+
+  // The reused memory does not hold the bytes of the earlier buffer.
+  buffer = pool->Allocate(120);
+  ASSERT_EQ(buffer->Data(), data);
+  for (size_t i = 0; i < buffer->Size(); i++) {
+    ASSERT_EQ(buffer->Data()[i], 0) << i;
+  }
+}
+
+TEST(BufferPoolTest, TestLimits) {
+  auto pool = BufferPool::Create(/*max_buffer_size=*/1024, /*max_pooled_bytes=*/2048);
+  // Buffers larger than the maximum size are not pooled.
+  pool->Allocate(2000).reset();
+  ASSERT_EQ(pool->PooledBytes(), 0);
+
+  // Only up to the maximum number of bytes are kept.
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  for (int i = 0; i < 3; i++) {
+    buffers.push_back(pool->Allocate(1024));
+  }
+  buffers.clear();
+  ASSERT_EQ(pool->PooledBytes(), 2048);
+
+  // Pooling is disabled if the maximum number of bytes is 0.
+  auto disabled = BufferPool::Create(/*max_buffer_size=*/1024, /*max_pooled_bytes=*/0);
+  disabled->Allocate(100).reset();
+  ASSERT_EQ(disabled->PooledBytes(), 0);
+}
+
+TEST(BufferPoolTest, TestBufferOutlivesPool) {
+  auto pool = BufferPool::Create(/*max_buffer_size=*/1024, /*max_pooled_bytes=*/4096);
+  auto buffer = pool->Allocate(100);
+  pool.reset();
+  buffer->Data()[99] = 1;
+  buffer.reset();
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -364,7 +364,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       RayConfig::instance().lineage_pinning_enabled(), [this](const rpc::Address &addr) {
         return std::shared_ptr<rpc::CoreWorkerClient>(
             new rpc::CoreWorkerClient(addr, *client_call_manager_));
-      });
+      },
+      RayConfig::instance().local_reference_batch_size());
 
   if (options_.worker_type == ray::WorkerType::WORKER) {
     death_check_timer_.expires_from_now(boost::asio::chrono::milliseconds(
@@ -392,6 +393,8 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
       },
       options_.ref_counting_enabled ? reference_counter_ : nullptr, local_raylet_client_,
       options_.check_signals));
+  buffer_pool_ = BufferPool::Create(RayConfig::instance().max_direct_call_object_size(),
+                                    RayConfig::instance().local_buffer_pool_bytes());
 
   auto check_node_alive_fn = [this](const ClientID &node_id) {
     auto node = gcs_client_->Nodes().Get(node_id);
@@ -477,7 +480,12 @@ CoreWorker::CoreWorker(const CoreWorkerOptions &options, const WorkerID &worker_
           memory_store_, task_manager_, local_raylet_id,
           RayConfig::instance().worker_lease_timeout_milliseconds(),
           RayConfig::instance().max_tasks_in_flight_per_worker(),
-          std::move(actor_creator), boost::asio::steady_timer(io_service_)));
+          std::move(actor_creator), boost::asio::steady_timer(io_service_),
+          RayConfig::instance().max_pending_lease_requests_per_scheduling_class(),
+          RayConfig::instance().max_adaptive_tasks_in_flight_per_worker(),
+          [this](const std::vector<ObjectID> &object_ids) {
+            return reference_counter_->GetPinnedBytesByNode(object_ids);
+          }));
   future_resolver_.reset(new FutureResolver(memory_store_, client_factory, rpc_address_));
   // Unfortunately the raylet client has to be constructed after the receivers.
   if (direct_task_receiver_ != nullptr) {
@@ -712,6 +720,14 @@ void CoreWorker::InternalHeartbeat(const boost::system::error_code &error) {
     return;
   }
 
+  // Drivers do not execute tasks, so also apply the reference removals that the
+  // frontend buffered periodically.
+  std::vector<ObjectID> deleted;
+  reference_counter_->FlushLocalReferences(&deleted);
+  if (options_.ref_counting_enabled && !options_.is_local_mode) {
+    memory_store_->Delete(deleted);
+  }
+
   absl::MutexLock lock(&mutex_);
   while (!to_resubmit_.empty() && current_time_ms() > to_resubmit_.front().first) {
     auto &spec = to_resubmit_.front().second;
@@ -864,7 +880,7 @@ Status CoreWorker::Create(const std::shared_ptr<Buffer> &metadata, const size_t
       (RayConfig::instance().put_small_object_in_memory_store() &&
        static_cast<int64_t>(data_size) <
            RayConfig::instance().max_direct_call_object_size())) {
-    *data = std::make_shared<LocalMemoryBuffer>(data_size);
+    *data = buffer_pool_->Allocate(data_size);
   } else {
     RAY_RETURN_NOT_OK(
         plasma_store_provider_->Create(metadata, data_size, *object_id, data));
@@ -913,6 +929,36 @@ Status CoreWorker::Seal(const ObjectID &object_id, bool pin_object,
   return Status::OK();
 }
 
+Status CoreWorker::SealBatch(const std::vector<ObjectID> &object_ids, bool pin_object,
+                             const absl::optional<rpc::Address> &owner_address) {
+  if (object_ids.empty()) {
+    return Status::OK();
+  }
+  RAY_RETURN_NOT_OK(plasma_store_provider_->SealBatch(object_ids));
+  if (pin_object) {
+    // Tell the raylet to pin the objects **after** they are created.
+    RAY_LOG(DEBUG) << "Pinning " << object_ids.size() << " sealed objects";
+    RAY_CHECK_OK(local_raylet_client_->PinObjectIDs(
+        owner_address.has_value() ? *owner_address : rpc_address_, object_ids,
+        [this, object_ids](const Status &status, const rpc::PinObjectIDsReply &reply) {
+          // Only release the objects once the raylet has responded to avoid the race
+          // condition that they could be evicted before the raylet pins them.
+          if (!plasma_store_provider_->ReleaseBatch(object_ids).ok()) {
+            RAY_LOG(ERROR) << "Failed to release " << object_ids.size()
+                           << " objects, might cause a leak in plasma.";
+          }
+        }));
+  } else {
+    RAY_RETURN_NOT_OK(plasma_store_provider_->ReleaseBatch(object_ids));
+    reference_counter_->FreePlasmaObjects(object_ids);
+  }
+  for (const auto &object_id : object_ids) {
+    RAY_CHECK(
+        memory_store_->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), object_id));
+  }
+  return Status::OK();
+}
+
 Status CoreWorker::Get(const std::vector<ObjectID> &ids, const int64_t timeout_ms,
                        std::vector<std::shared_ptr<RayObject>> *results) {
   results->resize(ids.size(), nullptr);
@@ -1472,9 +1518,14 @@ Status CoreWorker::AllocateReturnObjects(
                                  ? rpc::Address()
                                  : worker_context_.GetCurrentTask()->CallerAddress());
 
+  std::vector<std::shared_ptr<Buffer>> data_buffers(object_ids.size());
+  // The return objects that go to plasma, which are all created with a single
+  // request to the store.
+  std::vector<size_t> plasma_indices;
+  std::vector<ObjectID> plasma_object_ids;
+  std::vector<size_t> plasma_data_sizes;
+  std::vector<std::shared_ptr<Buffer>> plasma_metadatas;
   for (size_t i = 0; i < object_ids.size(); i++) {
-    bool object_already_exists = false;
-    std::shared_ptr<Buffer> data_buffer;
     if (data_sizes[i] > 0) {
       RAY_LOG(DEBUG) << "Creating return object " << object_ids[i];
       // Mark this object as containing other object IDs. The ref counter will
@@ -1488,17 +1539,32 @@ Status CoreWorker::AllocateReturnObjects(
       if (options_.is_local_mode ||
           static_cast<int64_t>(data_sizes[i]) <
               RayConfig::instance().max_direct_call_object_size()) {
-        data_buffer = std::make_shared<LocalMemoryBuffer>(data_sizes[i]);
+        data_buffers[i] = buffer_pool_->Allocate(data_sizes[i]);
       } else {
-        RAY_RETURN_NOT_OK(
-            Create(metadatas[i], data_sizes[i], object_ids[i], &data_buffer));
-        object_already_exists = !data_buffer;
+        plasma_indices.push_back(i);
+        plasma_object_ids.push_back(object_ids[i]);
+        plasma_data_sizes.push_back(data_sizes[i]);
+        plasma_metadatas.push_back(metadatas[i]);
       }
     }
+  }
+
+  std::vector<bool> object_already_exists(object_ids.size(), false);
+  if (!plasma_object_ids.empty()) {
+    std::vector<std::shared_ptr<Buffer>> plasma_buffers;
+    RAY_RETURN_NOT_OK(plasma_store_provider_->CreateBatch(
+        plasma_metadatas, plasma_data_sizes, plasma_object_ids, &plasma_buffers));
+    for (size_t j = 0; j < plasma_indices.size(); j++) {
+      data_buffers[plasma_indices[j]] = plasma_buffers[j];
+      object_already_exists[plasma_indices[j]] = !plasma_buffers[j];
+    }
+  }
+
+  for (size_t i = 0; i < object_ids.size(); i++) {
     // Leave the return object as a nullptr if the object already exists.
-    if (!object_already_exists) {
-      return_objects->at(i) =
-          std::make_shared<RayObject>(data_buffer, metadatas[i], contained_object_ids[i]);
+    if (!object_already_exists[i]) {
+      return_objects->at(i) = std::make_shared<RayObject>(data_buffers[i], metadatas[i],
+                                                          contained_object_ids[i]);
     }
   }
 
@@ -1567,6 +1633,7 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
   absl::optional<rpc::Address> caller_address(
       options_.is_local_mode ? absl::optional<rpc::Address>()
                              : worker_context_.GetCurrentTask()->CallerAddress());
+  std::vector<ObjectID> plasma_return_ids;
   for (size_t i = 0; i < return_objects->size(); i++) {
     // The object is nullptr if it already existed in the object store.
     if (!return_objects->at(i)) {
@@ -1574,12 +1641,19 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
     }
     if (return_objects->at(i)->GetData() != nullptr &&
         return_objects->at(i)->GetData()->IsPlasmaBuffer()) {
-      if (!Seal(return_ids[i], /*pin_object=*/true, caller_address).ok()) {
-        RAY_LOG(FATAL) << "Task " << task_spec.TaskId() << " failed to seal object "
-                       << return_ids[i] << " in store: " << status.message();
-      }
+      plasma_return_ids.push_back(return_ids[i]);
     }
   }
+  if (!SealBatch(plasma_return_ids, /*pin_object=*/true, caller_address).ok()) {
+    RAY_LOG(FATAL) << "Task " << task_spec.TaskId() << " failed to seal "
+                   << plasma_return_ids.size() << " return objects in store: "
+                   << status.message();
+  }
+
+  // Apply the reference removals that the frontend buffered during the task, so
+  // that the reference counts below are up to date.
+  std::vector<ObjectID> deleted;
+  reference_counter_->FlushLocalReferences(&deleted);
 
   // Get the reference counts for any IDs that we borrowed during this task and
   // return them to the caller. This will notify the caller of any IDs that we
@@ -1590,7 +1664,6 @@ Status CoreWorker::ExecuteTask(const TaskSpecification &task_spec,
     reference_counter_->GetAndClearLocalBorrowers(borrowed_ids, borrowed_refs);
   }
   // Unpin the borrowed IDs.
-  std::vector<ObjectID> deleted;
   for (const auto &borrowed_id : borrowed_ids) {
     RAY_LOG(DEBUG) << "Decrementing ref for borrowed ID " << borrowed_id;
     reference_counter_->RemoveLocalReference(borrowed_id, &deleted);
@@ -1770,6 +1843,37 @@ void CoreWorker::HandlePushTask(const rpc::PushTaskRequest &request,
   });
 }
 
+void CoreWorker::HandlePushTasks(const rpc::PushTasksRequest &request,
+                                 rpc::PushTasksReply *reply,
+                                 rpc::SendReplyCallback send_reply_callback) {
+  if (request.requests_size() == 0) {
+    send_reply_callback(Status::OK(), nullptr, nullptr);
+    return;
+  }
+  // Handle each task as if it had been pushed on its own, in order, so that actor
+  // tasks are still queued by their sequence numbers. The batch is replied to once
+  // the last task is done.
+  for (int i = 0; i < request.requests_size(); i++) {
+    reply->add_results();
+  }
+  auto num_pending = std::make_shared<std::atomic<int>>(request.requests_size());
+  for (int i = 0; i < request.requests_size(); i++) {
+    auto result = reply->mutable_results(i);
+    HandlePushTask(request.requests(i), result->mutable_reply(),
+                   [result, num_pending, send_reply_callback](
+                       Status status, std::function<void()> success,
+                       std::function<void()> failure) {
+                     result->set_status_code(static_cast<int>(status.code()));
+                     if (!status.ok()) {
+                       result->set_status_message(status.message());
+                     }
+                     if (--(*num_pending) == 0) {
+                       send_reply_callback(Status::OK(), nullptr, nullptr);
+                     }
+                   });
+  }
+}
+
 void CoreWorker::HandleDirectActorCallArgWaitComplete(
     const rpc::DirectActorCallArgWaitCompleteRequest &request,
     rpc::DirectActorCallArgWaitCompleteReply *reply,
@@ -1822,13 +1926,27 @@ void CoreWorker::HandleGetObjectStatus(const rpc::GetObjectStatusRequest &reques
     }
     // Send the reply once the value has become available. The value is
     // guaranteed to become available eventually because we own the object and
-    // its ref count is > 0.
-    // TODO(swang): We could probably just send the object value if it is small
-    // enough and we have it local.
-    memory_store_->GetAsync(object_id,
-                            [send_reply_callback](std::shared_ptr<RayObject> obj) {
-                              send_reply_callback(Status::OK(), nullptr, nullptr);
-                            });
+    // its ref count is > 0. If the value is small and stored in our memory
+    // store, we send it with the reply so that the caller does not need to
+    // fetch it from plasma. Objects that contain other object IDs are not
+    // sent, since the caller would need to track the nested references.
+    memory_store_->GetAsync(object_id, [reply, send_reply_callback](
+                                           std::shared_ptr<RayObject> obj) {
+      if (!obj->IsInPlasmaError() && obj->GetNestedIds().empty() &&
+          static_cast<int64_t>(obj->GetSize()) <
+              RayConfig::instance().max_direct_call_object_size()) {
+        reply->set_inlined(true);
+        if (obj->HasData()) {
+          const auto &data = obj->GetData();
+          reply->set_data(data->Data(), data->Size());
+        }
+        if (obj->HasMetadata()) {
+          const auto &metadata = obj->GetMetadata();
+          reply->set_metadata(metadata->Data(), metadata->Size());
+        }
+      }
+      send_reply_callback(Status::OK(), nullptr, nullptr);
+    });
   }
 
   RemoveLocalReference(object_id);
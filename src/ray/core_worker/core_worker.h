@@ -17,6 +17,7 @@
 #include "absl/base/optimization.h"
 #include "absl/container/flat_hash_map.h"
 #include "ray/common/buffer.h"
+#include "ray/common/buffer_pool.h"
 #include "ray/common/placement_group.h"
 #include "ray/core_worker/actor_handle.h"
 #include "ray/core_worker/actor_manager.h"
@@ -336,7 +337,7 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// \param[in] object_id The object ID to decrease the reference count for.
   void RemoveLocalReference(const ObjectID &object_id) {
     std::vector<ObjectID> deleted;
-    reference_counter_->RemoveLocalReference(object_id, &deleted);
+    reference_counter_->RemoveLocalReferenceBatched(object_id, &deleted);
     // TOOD(ilr): better way of keeping an object from being deleted
     if (options_.ref_counting_enabled && !options_.is_local_mode) {
       memory_store_->Delete(deleted);
@@ -479,6 +480,18 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   Status Seal(const ObjectID &object_id, bool pin_object,
               const absl::optional<rpc::Address> &owner_address = absl::nullopt);
 
+  /// Finalize placing many objects into the object store, with a single request to
+  /// the object store and to the local raylet. This is equivalent to calling Seal()
+  /// for each object.
+  ///
+  /// \param[in] object_ids Object IDs corresponding to the objects.
+  /// \param[in] pin_object Whether or not to pin the objects at the local raylet.
+  /// \param[in] owner_address Address of the owner of the objects who will be contacted
+  /// by the raylet if the objects are pinned. If not provided, defaults to this worker.
+  /// \return Status.
+  Status SealBatch(const std::vector<ObjectID> &object_ids, bool pin_object,
+                   const absl::optional<rpc::Address> &owner_address = absl::nullopt);
+
   /// Get a list of objects from the object store. Objects that failed to be retrieved
   /// will be returned as nullptrs.
   ///
@@ -739,6 +752,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   void HandlePushTask(const rpc::PushTaskRequest &request, rpc::PushTaskReply *reply,
                       rpc::SendReplyCallback send_reply_callback) override;
 
+  /// Implements gRPC server handler.
+  void HandlePushTasks(const rpc::PushTasksRequest &request, rpc::PushTasksReply *reply,
+                       rpc::SendReplyCallback send_reply_callback) override;
+
   /// Implements gRPC server handler.
   void HandleDirectActorCallArgWaitComplete(
       const rpc::DirectActorCallArgWaitCompleteRequest &request,
@@ -1011,6 +1028,10 @@ class CoreWorker : public rpc::CoreWorkerServiceHandler {
   /// In-memory store for return objects.
   std::shared_ptr<CoreWorkerMemoryStore> memory_store_;
 
+  /// Pool of buffers for objects that are stored in local memory, such as
+  /// small return values.
+  std::shared_ptr<BufferPool> buffer_pool_;
+
   /// Plasma store interface.
   std::shared_ptr<CoreWorkerPlasmaStoreProvider> plasma_store_provider_;
 
@@ -111,7 +111,7 @@ class FiberState {
   }
 
   void EnqueueFiber(std::function<void()> &&callback) {
-    auto op_status = channel_.push([this, callback]() {
+    auto op_status = channel_.push([this, callback = std::move(callback)]() {
       rate_limiter_.Acquire();
       callback();
       rate_limiter_.Release();
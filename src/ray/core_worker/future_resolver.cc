@@ -50,6 +50,28 @@ void FutureResolver::ResolveFutureAsync(const ObjectID &object_id,
           // thrown immediately when the worker tries to get the value.
           RAY_UNUSED(in_memory_store_->Put(
               RayObject(rpc::ErrorType::OBJECT_UNRECONSTRUCTABLE), object_id));
+        } else if (reply.inlined()) {
+          // The owner sent us the value of the object, so we do not need to
+          // fetch it from plasma.
+          // The memory store copies the buffers, so they can point into the
+          // reply.
+          std::shared_ptr<LocalMemoryBuffer> data_buffer;
+          if (reply.data().size() > 0) {
+            data_buffer = std::make_shared<LocalMemoryBuffer>(
+                const_cast<uint8_t *>(
+                    reinterpret_cast<const uint8_t *>(reply.data().data())),
+                reply.data().size());
+          }
+          std::shared_ptr<LocalMemoryBuffer> metadata_buffer;
+          if (reply.metadata().size() > 0) {
+            metadata_buffer = std::make_shared<LocalMemoryBuffer>(
+                const_cast<uint8_t *>(
+                    reinterpret_cast<const uint8_t *>(reply.metadata().data())),
+                reply.metadata().size());
+          }
+          RAY_UNUSED(in_memory_store_->Put(
+              RayObject(data_buffer, metadata_buffer, std::vector<ObjectID>()),
+              object_id));
         } else {
           // We can now try to fetch the object via plasma. If the owner later
           // fails or the object is released, the raylet will eventually store
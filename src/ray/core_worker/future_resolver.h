@@ -35,8 +35,9 @@ class FutureResolver {
 
   /// Resolve the value for a future. This will periodically contact the given
   /// owner until the owner dies or the owner has finished creating the object.
-  /// In either case, this will put an OBJECT_IN_PLASMA error as the future's
-  /// value.
+  /// If the owner replies with the object's value, this will put the value in
+  /// the memory store. Otherwise, this will put an OBJECT_IN_PLASMA error as
+  /// the future's value.
   ///
   /// \param[in] object_id The ID of the future to resolve.
   /// \param[in] owner_address The address of the task or actor that owns the
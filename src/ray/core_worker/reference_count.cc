@@ -14,16 +14,20 @@
 
 #include "ray/core_worker/reference_count.h"
 
+#include <thread>
+
 #define PRINT_REF_COUNT(it)                                                              \
-  RAY_LOG(DEBUG) << "REF " << it->first << " borrowers: " << it->second.borrowers.size() \
+  RAY_LOG(DEBUG) << "REF " << it->first                                                  \
+                 << " borrowers: " << it->second.GetBorrowInfo().borrowers.size()        \
                  << " local_ref_count: " << it->second.local_ref_count                   \
                  << " submitted_count: " << it->second.submitted_task_ref_count          \
-                 << " contained_in_owned: " << it->second.contained_in_owned.size()      \
+                 << " contained_in_owned: "                                              \
+                 << it->second.GetBorrowInfo().contained_in_owned.size()                 \
                  << " contained_in_borrowed: "                                           \
-                 << (it->second.contained_in_borrowed_id.has_value()                     \
-                         ? *it->second.contained_in_borrowed_id                          \
+                 << (it->second.GetBorrowInfo().contained_in_borrowed_id.has_value()     \
+                         ? *it->second.GetBorrowInfo().contained_in_borrowed_id          \
                          : ObjectID::Nil())                                              \
-                 << " contains: " << it->second.contains.size()                          \
+                 << " contains: " << it->second.GetBorrowInfo().contains.size()          \
                  << " lineage_ref_count: " << it->second.lineage_ref_count;
 
 namespace {}  // namespace
@@ -91,16 +95,16 @@ bool ReferenceCounter::AddBorrowedObjectInternal(const ObjectID &object_id,
     return false;
   }
 
-  it->second.owner_address = owner_address;
+  it->second.owner_address = InternOwnerAddress(owner_address);
 
   if (!outer_id.IsNil()) {
     auto outer_it = object_id_refs_.find(outer_id);
     if (outer_it != object_id_refs_.end() && !outer_it->second.owned_by_us) {
       RAY_LOG(DEBUG) << "Setting borrowed inner ID " << object_id
                      << " contained_in_borrowed: " << outer_id;
-      RAY_CHECK(!it->second.contained_in_borrowed_id.has_value());
-      it->second.contained_in_borrowed_id = outer_id;
-      outer_it->second.contains.insert(object_id);
+      RAY_CHECK(!it->second.GetBorrowInfo().contained_in_borrowed_id.has_value());
+      it->second.MutableBorrowInfo()->contained_in_borrowed_id = outer_id;
+      outer_it->second.MutableBorrowInfo()->contains.insert(object_id);
     }
   }
   return true;
@@ -113,7 +117,7 @@ void ReferenceCounter::AddObjectRefStats(
   for (const auto &ref : object_id_refs_) {
     auto ref_proto = stats->add_object_refs();
     ref_proto->set_object_id(ref.first.Binary());
-    ref_proto->set_call_site(ref.second.call_site);
+    ref_proto->set_call_site(ref.second.CallSite());
     ref_proto->set_object_size(ref.second.object_size);
     ref_proto->set_local_ref_count(ref.second.local_ref_count);
     ref_proto->set_submitted_task_ref_count(ref.second.submitted_task_ref_count);
@@ -124,11 +128,11 @@ void ReferenceCounter::AddObjectRefStats(
       if (ref.second.object_size <= 0) {
         ref_proto->set_object_size(it->second.first);
       }
-      if (ref.second.call_site.empty()) {
+      if (ref.second.CallSite().empty()) {
         ref_proto->set_call_site(it->second.second);
       }
     }
-    for (const auto &obj_id : ref.second.contained_in_owned) {
+    for (const auto &obj_id : ref.second.GetBorrowInfo().contained_in_owned) {
       ref_proto->add_contained_in_owned(obj_id.Binary());
     }
   }
@@ -156,8 +160,9 @@ void ReferenceCounter::AddOwnedObject(
   // If the entry doesn't exist, we initialize the direct reference count to zero
   // because this corresponds to a submitted task whose return ObjectID will be created
   // in the frontend language, incrementing the reference count.
-  object_id_refs_.emplace(object_id, Reference(owner_address, call_site, object_size,
-                                               is_reconstructable, pinned_at_raylet_id));
+  object_id_refs_.emplace(
+      object_id, Reference(InternOwnerAddress(owner_address), InternCallSite(call_site),
+                           object_size, is_reconstructable, pinned_at_raylet_id));
   if (!inner_ids.empty()) {
     // Mark that this object ID contains other inner IDs. Then, we will not GC
     // the inner objects until the outer object ID goes out of scope.
@@ -175,11 +180,26 @@ void ReferenceCounter::UpdateObjectSize(const ObjectID &object_id, int64_t objec
 
 void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
                                          const std::string &call_site) {
+  if (local_reference_batch_size_ > 0) {
+    // If this thread has a removal buffered for the object, the reference table
+    // still counts that reference, so we can cancel the removal instead.
+    auto &stripe = CurrentStripe();
+    absl::MutexLock lock(&stripe.mu);
+    auto it = stripe.removals.find(object_id);
+    if (it != stripe.removals.end()) {
+      if (--it->second == 0) {
+        stripe.removals.erase(it);
+      }
+      stripe.num_removals--;
+      return;
+    }
+  }
   absl::MutexLock lock(&mutex_);
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     // NOTE: ownership info for these objects must be added later via AddBorrowedObject.
-    it = object_id_refs_.emplace(object_id, Reference(call_site, -1)).first;
+    it = object_id_refs_.emplace(object_id, Reference(InternCallSite(call_site), -1))
+             .first;
   }
   it->second.local_ref_count++;
   RAY_LOG(DEBUG) << "Add local reference " << object_id;
@@ -189,6 +209,65 @@ void ReferenceCounter::AddLocalReference(const ObjectID &object_id,
 void ReferenceCounter::RemoveLocalReference(const ObjectID &object_id,
                                             std::vector<ObjectID> *deleted) {
   absl::MutexLock lock(&mutex_);
+  RemoveLocalReferenceInternal(object_id, 1, deleted);
+}
+
+void ReferenceCounter::RemoveLocalReferenceBatched(const ObjectID &object_id,
+                                                   std::vector<ObjectID> *deleted) {
+  if (local_reference_batch_size_ <= 0) {
+    RemoveLocalReference(object_id, deleted);
+    return;
+  }
+  absl::flat_hash_map<ObjectID, int64_t> removals;
+  {
+    auto &stripe = CurrentStripe();
+    absl::MutexLock lock(&stripe.mu);
+    stripe.removals[object_id]++;
+    if (++stripe.num_removals < local_reference_batch_size_) {
+      return;
+    }
+    removals.swap(stripe.removals);
+    stripe.num_removals = 0;
+  }
+  ApplyLocalReferenceRemovals(removals, deleted);
+}
+
+void ReferenceCounter::FlushLocalReferences(std::vector<ObjectID> *deleted) {
+  if (local_reference_batch_size_ <= 0) {
+    return;
+  }
+  absl::flat_hash_map<ObjectID, int64_t> removals;
+  for (auto &stripe : local_reference_stripes_) {
+    absl::MutexLock lock(&stripe.mu);
+    for (const auto &removal : stripe.removals) {
+      removals[removal.first] += removal.second;
+    }
+    stripe.removals.clear();
+    stripe.num_removals = 0;
+  }
+  ApplyLocalReferenceRemovals(removals, deleted);
+}
+
+void ReferenceCounter::ApplyLocalReferenceRemovals(
+    const absl::flat_hash_map<ObjectID, int64_t> &removals,
+    std::vector<ObjectID> *deleted) {
+  if (removals.empty()) {
+    return;
+  }
+  absl::MutexLock lock(&mutex_);
+  for (const auto &removal : removals) {
+    RemoveLocalReferenceInternal(removal.first, removal.second, deleted);
+  }
+}
+
+ReferenceCounter::LocalReferenceStripe &ReferenceCounter::CurrentStripe() {
+  const size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+  return local_reference_stripes_[hash % kNumLocalReferenceStripes];
+}
+
+void ReferenceCounter::RemoveLocalReferenceInternal(const ObjectID &object_id,
+                                                    int64_t count,
+                                                    std::vector<ObjectID> *deleted) {
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     RAY_LOG(WARNING) << "Tried to decrease ref count for nonexistent object ID: "
@@ -201,8 +280,14 @@ void ReferenceCounter::RemoveLocalReference(const ObjectID &object_id,
         << ". This should only happen if ray.internal.free was called earlier.";
     return;
   }
-  it->second.local_ref_count--;
-  RAY_LOG(DEBUG) << "Remove local reference " << object_id;
+  if (it->second.local_ref_count < static_cast<size_t>(count)) {
+    RAY_LOG(WARNING)
+        << "Tried to decrease ref count for object ID below 0 " << object_id
+        << ". This should only happen if ray.internal.free was called earlier.";
+    count = it->second.local_ref_count;
+  }
+  it->second.local_ref_count -= count;
+  RAY_LOG(DEBUG) << "Remove " << count << " local reference(s) " << object_id;
   PRINT_REF_COUNT(it);
   if (it->second.RefCount() == 0) {
     DeleteReferenceInternal(it, deleted);
@@ -401,10 +486,10 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
                                                std::vector<ObjectID> *deleted) {
   const ObjectID id = it->first;
   RAY_LOG(DEBUG) << "Attempting to delete object " << id;
-  if (it->second.RefCount() == 0 && it->second.on_ref_removed) {
+  if (it->second.RefCount() == 0 && it->second.GetBorrowInfo().on_ref_removed) {
     RAY_LOG(DEBUG) << "Calling on_ref_removed for object " << id;
-    it->second.on_ref_removed(id);
-    it->second.on_ref_removed = nullptr;
+    it->second.GetBorrowInfo().on_ref_removed(id);
+    it->second.MutableBorrowInfo()->on_ref_removed = nullptr;
   }
   PRINT_REF_COUNT(it);
 
@@ -423,7 +508,7 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
     // If distributed ref counting is enabled, then delete the object once its
     // ref count across all processes is 0.
     should_delete_value = true;
-    for (const auto &inner_id : it->second.contains) {
+    for (const auto &inner_id : it->second.GetBorrowInfo().contains) {
       auto inner_it = object_id_refs_.find(inner_id);
       if (inner_it != object_id_refs_.end()) {
         RAY_LOG(DEBUG) << "Try to delete inner object " << inner_id;
@@ -431,12 +516,13 @@ void ReferenceCounter::DeleteReferenceInternal(ReferenceTable::iterator it,
           // If this object ID was nested in an owned object, make sure that
           // the outer object counted towards the ref count for the inner
           // object.
-          RAY_CHECK(inner_it->second.contained_in_owned.erase(id));
+          RAY_CHECK(inner_it->second.MutableBorrowInfo()->contained_in_owned.erase(id));
         } else {
           // If this object ID was nested in a borrowed object, make sure that
           // we have already returned this information through a previous
           // GetAndClearLocalBorrowers call.
-          RAY_CHECK(!inner_it->second.contained_in_borrowed_id.has_value())
+          RAY_CHECK(
+              !inner_it->second.GetBorrowInfo().contained_in_borrowed_id.has_value())
               << "Outer object " << id << ", inner object " << inner_id;
         }
         DeleteReferenceInternal(inner_it, deleted);
@@ -551,6 +637,21 @@ bool ReferenceCounter::IsPlasmaObjectPinned(const ObjectID &object_id,
   return false;
 }
 
+std::unordered_map<ClientID, int64_t> ReferenceCounter::GetPinnedBytesByNode(
+    const std::vector<ObjectID> &object_ids) const {
+  std::unordered_map<ClientID, int64_t> pinned_bytes;
+  absl::MutexLock lock(&mutex_);
+  for (const auto &object_id : object_ids) {
+    auto it = object_id_refs_.find(object_id);
+    if (it == object_id_refs_.end() || !it->second.owned_by_us ||
+        !it->second.pinned_at_raylet_id.has_value() || it->second.object_size < 0) {
+      continue;
+    }
+    pinned_bytes[*it->second.pinned_at_raylet_id] += it->second.object_size;
+  }
+  return pinned_bytes;
+}
+
 bool ReferenceCounter::HasReference(const ObjectID &object_id) const {
   absl::MutexLock lock(&mutex_);
   return object_id_refs_.find(object_id) != object_id_refs_.end();
@@ -626,21 +727,25 @@ bool ReferenceCounter::GetAndClearLocalBorrowersInternal(const ObjectID &object_
   // Clear the local list of borrowers that we have accumulated. The receiver
   // of the returned borrowed_refs must merge this list into their own list
   // until all active borrowers are merged into the owner.
-  it->second.borrowers.clear();
-  it->second.stored_in_objects.clear();
+  if (!it->second.borrow_info) {
+    return true;
+  }
+  auto borrow_info = it->second.MutableBorrowInfo();
+  borrow_info->borrowers.clear();
+  borrow_info->stored_in_objects.clear();
 
-  if (it->second.contained_in_borrowed_id.has_value()) {
+  if (borrow_info->contained_in_borrowed_id.has_value()) {
     /// This ID was nested in another ID that we (or a nested task) borrowed.
     /// Make sure that we also returned the ID that contained it.
-    RAY_CHECK(borrowed_refs->count(it->second.contained_in_borrowed_id.value()) > 0);
+    RAY_CHECK(borrowed_refs->count(borrow_info->contained_in_borrowed_id.value()) > 0);
     /// Clear the fact that this ID was nested because we are including it in
     /// the returned borrowed_refs. If the nested ID is not being borrowed by
     /// us, then it will be deleted recursively when deleting the outer ID.
-    it->second.contained_in_borrowed_id.reset();
+    borrow_info->contained_in_borrowed_id.reset();
   }
 
   // Attempt to pop children.
-  for (const auto &contained_id : it->second.contains) {
+  for (const auto &contained_id : borrow_info->contains) {
     GetAndClearLocalBorrowersInternal(contained_id, borrowed_refs);
   }
 
@@ -656,29 +761,30 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
     return;
   }
   const auto &borrower_ref = borrower_it->second;
+  const auto &borrower_info = borrower_ref.GetBorrowInfo();
   RAY_LOG(DEBUG) << "Borrower ref " << object_id << " has "
-                 << borrower_ref.borrowers.size() << " borrowers "
+                 << borrower_info.borrowers.size() << " borrowers "
                  << ", has local: " << borrower_ref.local_ref_count
                  << " submitted: " << borrower_ref.submitted_task_ref_count
-                 << " contained_in_owned " << borrower_ref.contained_in_owned.size();
+                 << " contained_in_owned " << borrower_info.contained_in_owned.size();
 
   auto it = object_id_refs_.find(object_id);
   if (it == object_id_refs_.end()) {
     it = object_id_refs_.emplace(object_id, Reference()).first;
   }
-  if (!it->second.owner_address && borrower_ref.contained_in_borrowed_id.has_value()) {
+  if (!it->second.owner_address && borrower_info.contained_in_borrowed_id.has_value()) {
     // We don't have owner information about this object ID yet and the worker
     // received it because it was nested in another ID that the worker was
     // borrowing. Copy this information to our local table.
     RAY_CHECK(borrower_ref.owner_address);
-    AddBorrowedObjectInternal(object_id, *borrower_it->second.contained_in_borrowed_id,
+    AddBorrowedObjectInternal(object_id, *borrower_info.contained_in_borrowed_id,
                               *borrower_ref.owner_address);
   }
   std::vector<rpc::WorkerAddress> new_borrowers;
 
   // The worker is still using the reference, so it is still a borrower.
   if (borrower_ref.RefCount() > 0) {
-    auto inserted = it->second.borrowers.insert(worker_addr).second;
+    auto inserted = it->second.MutableBorrowInfo()->borrowers.insert(worker_addr).second;
     // If we are the owner of id, then send WaitForRefRemoved to borrower.
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << worker_addr.ip_address << ":"
@@ -688,8 +794,9 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
   }
 
   // Add any other workers that this worker passed the ID to as new borrowers.
-  for (const auto &nested_borrower : borrower_ref.borrowers) {
-    auto inserted = it->second.borrowers.insert(nested_borrower).second;
+  for (const auto &nested_borrower : borrower_info.borrowers) {
+    auto inserted =
+        it->second.MutableBorrowInfo()->borrowers.insert(nested_borrower).second;
     if (inserted) {
       RAY_LOG(DEBUG) << "Adding borrower " << nested_borrower.ip_address << ":"
                      << nested_borrower.port << " to id " << object_id;
@@ -707,14 +814,14 @@ void ReferenceCounter::MergeRemoteBorrowers(const ObjectID &object_id,
 
   // If the borrower stored this object ID inside another object ID that it did
   // not own, then mark that the object ID is nested inside another.
-  for (const auto &stored_in_object : borrower_ref.stored_in_objects) {
+  for (const auto &stored_in_object : borrower_info.stored_in_objects) {
     AddNestedObjectIdsInternal(stored_in_object.first, {object_id},
                                stored_in_object.second);
   }
 
   // Recursively merge any references that were contained in this object, to
   // handle any borrowers of nested objects.
-  for (const auto &inner_id : borrower_ref.contains) {
+  for (const auto &inner_id : borrower_info.contains) {
     MergeRemoteBorrowers(inner_id, worker_addr, borrowed_refs);
   }
 }
@@ -757,7 +864,7 @@ void ReferenceCounter::WaitForRefRemoved(const ReferenceTable::iterator &ref_it,
         // Erase the previous borrower.
         auto it = object_id_refs_.find(object_id);
         RAY_CHECK(it != object_id_refs_.end());
-        RAY_CHECK(it->second.borrowers.erase(addr));
+        RAY_CHECK(it->second.MutableBorrowInfo()->borrowers.erase(addr));
         DeleteReferenceInternal(it, nullptr);
       }));
 }
@@ -783,12 +890,12 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       // contained in the outer object ID so we do not GC the inner objects
       // until the outer object goes out of scope.
       for (const auto &inner_id : inner_ids) {
-        it->second.contains.insert(inner_id);
+        it->second.MutableBorrowInfo()->contains.insert(inner_id);
         auto inner_it = object_id_refs_.find(inner_id);
         RAY_CHECK(inner_it != object_id_refs_.end());
         RAY_LOG(DEBUG) << "Setting inner ID " << inner_id
                        << " contained_in_owned: " << object_id;
-        inner_it->second.contained_in_owned.insert(object_id);
+        inner_it->second.MutableBorrowInfo()->contained_in_owned.insert(object_id);
       }
     }
   } else {
@@ -802,14 +909,16 @@ void ReferenceCounter::AddNestedObjectIdsInternal(
       RAY_CHECK(inner_it != object_id_refs_.end());
       // Add the task's caller as a borrower.
       if (inner_it->second.owned_by_us) {
-        auto inserted = inner_it->second.borrowers.insert(owner_address).second;
+        auto inserted =
+            inner_it->second.MutableBorrowInfo()->borrowers.insert(owner_address).second;
         if (inserted) {
           // Wait for it to remove its reference.
           WaitForRefRemoved(inner_it, owner_address, object_id);
         }
       } else {
-        auto inserted =
-            inner_it->second.stored_in_objects.emplace(object_id, owner_address).second;
+        auto inserted = inner_it->second.MutableBorrowInfo()
+                            ->stored_in_objects.emplace(object_id, owner_address)
+                            .second;
         // This should be the first time that we have stored this object ID
         // inside this return ID.
         RAY_CHECK(inserted);
@@ -824,8 +933,8 @@ void ReferenceCounter::HandleRefRemoved(const ObjectID &object_id,
   ReferenceTable borrowed_refs;
   RAY_UNUSED(GetAndClearLocalBorrowersInternal(object_id, &borrowed_refs));
   for (const auto &pair : borrowed_refs) {
-    RAY_LOG(DEBUG) << pair.first << " has " << pair.second.borrowers.size()
-                   << " borrowers";
+    RAY_LOG(DEBUG) << pair.first << " has "
+                   << pair.second.GetBorrowInfo().borrowers.size() << " borrowers";
   }
   auto it = object_id_refs_.find(object_id);
   if (it != object_id_refs_.end()) {
@@ -873,7 +982,7 @@ void ReferenceCounter::SetRefRemovedCallback(
   } else {
     // We are still borrowing the object ID. Respond to the owner once we have
     // stopped borrowing it.
-    if (it->second.on_ref_removed != nullptr) {
+    if (it->second.GetBorrowInfo().on_ref_removed != nullptr) {
       // TODO(swang): If the owner of an object dies and and is re-executed, it
       // is possible that we will receive a duplicate request to set
       // on_ref_removed. If messages are delayed and we overwrite the
@@ -883,7 +992,7 @@ void ReferenceCounter::SetRefRemovedCallback(
       RAY_LOG(WARNING) << "on_ref_removed already set for " << object_id
                        << ". The owner task must have died and been re-executed.";
     }
-    it->second.on_ref_removed = ref_removed_callback;
+    it->second.MutableBorrowInfo()->on_ref_removed = ref_removed_callback;
   }
 }
 
@@ -893,26 +1002,38 @@ void ReferenceCounter::SetReleaseLineageCallback(
   on_lineage_released_ = callback;
 }
 
+std::shared_ptr<const rpc::Address> ReferenceCounter::InternOwnerAddress(
+    const rpc::Address &address) {
+  return owner_addresses_.Intern(address.SerializeAsString(), address);
+}
+
+std::shared_ptr<const std::string> ReferenceCounter::InternCallSite(
+    const std::string &call_site) {
+  return call_sites_.Intern(call_site, call_site);
+}
+
 ReferenceCounter::Reference ReferenceCounter::Reference::FromProto(
     const rpc::ObjectReferenceCount &ref_count) {
   Reference ref;
-  ref.owner_address = ref_count.reference().owner_address();
+  ref.owner_address =
+      std::make_shared<const rpc::Address>(ref_count.reference().owner_address());
   ref.local_ref_count = ref_count.has_local_ref() ? 1 : 0;
 
   for (const auto &borrower : ref_count.borrowers()) {
-    ref.borrowers.insert(rpc::WorkerAddress(borrower));
+    ref.MutableBorrowInfo()->borrowers.insert(rpc::WorkerAddress(borrower));
   }
   for (const auto &object : ref_count.stored_in_objects()) {
     const auto &object_id = ObjectID::FromBinary(object.object_id());
-    ref.stored_in_objects.emplace(object_id, rpc::WorkerAddress(object.owner_address()));
+    ref.MutableBorrowInfo()->stored_in_objects.emplace(
+        object_id, rpc::WorkerAddress(object.owner_address()));
   }
   for (const auto &id : ref_count.contains()) {
-    ref.contains.insert(ObjectID::FromBinary(id));
+    ref.MutableBorrowInfo()->contains.insert(ObjectID::FromBinary(id));
   }
   const auto contained_in_borrowed_id =
       ObjectID::FromBinary(ref_count.contained_in_borrowed_id());
   if (!contained_in_borrowed_id.IsNil()) {
-    ref.contained_in_borrowed_id = contained_in_borrowed_id;
+    ref.MutableBorrowInfo()->contained_in_borrowed_id = contained_in_borrowed_id;
   }
   return ref;
 }
@@ -923,18 +1044,19 @@ void ReferenceCounter::Reference::ToProto(rpc::ObjectReferenceCount *ref) const
   }
   bool has_local_ref = RefCount() > 0;
   ref->set_has_local_ref(has_local_ref);
-  for (const auto &borrower : borrowers) {
+  const auto &borrow_info = GetBorrowInfo();
+  for (const auto &borrower : borrow_info.borrowers) {
     ref->add_borrowers()->CopyFrom(borrower.ToProto());
   }
-  for (const auto &object : stored_in_objects) {
+  for (const auto &object : borrow_info.stored_in_objects) {
     auto ref_object = ref->add_stored_in_objects();
     ref_object->set_object_id(object.first.Binary());
     ref_object->mutable_owner_address()->CopyFrom(object.second.ToProto());
   }
-  if (contained_in_borrowed_id.has_value()) {
-    ref->set_contained_in_borrowed_id(contained_in_borrowed_id->Binary());
+  if (borrow_info.contained_in_borrowed_id.has_value()) {
+    ref->set_contained_in_borrowed_id(borrow_info.contained_in_borrowed_id->Binary());
   }
-  for (const auto &contains_id : contains) {
+  for (const auto &contains_id : borrow_info.contains) {
     ref->add_contains(contains_id.Binary());
   }
 }
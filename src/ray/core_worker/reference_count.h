@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
 #include <boost/bind.hpp>
 
 #include "absl/base/thread_annotations.h"
@@ -49,6 +51,48 @@ class ReferenceCounterInterface {
   virtual ~ReferenceCounterInterface() {}
 };
 
+/// A table of shared immutable values, so that the references that have equal
+/// values can share a single copy. Values that are no longer used by anyone are
+/// dropped from the table when it has doubled in size. This class is not thread
+/// safe.
+template <typename T>
+class InternTable {
+ public:
+  /// Return the shared copy of the value.
+  ///
+  /// \param[in] key A key that identifies the value.
+  /// \param[in] value The value.
+  std::shared_ptr<const T> Intern(const std::string &key, const T &value) {
+    auto it = values_.find(key);
+    if (it != values_.end()) {
+      return it->second;
+    }
+    if (values_.size() >= prune_size_) {
+      for (auto prune_it = values_.begin(); prune_it != values_.end();) {
+        if (prune_it->second.use_count() == 1) {
+          values_.erase(prune_it++);
+        } else {
+          prune_it++;
+        }
+      }
+      prune_size_ = 2 * values_.size();
+      if (prune_size_ < kMinPruneSize) {
+        prune_size_ = kMinPruneSize;
+      }
+    }
+    auto shared_value = std::make_shared<const T>(value);
+    values_.emplace(key, shared_value);
+    return shared_value;
+  }
+
+ private:
+  static constexpr size_t kMinPruneSize = 1024;
+
+  absl::flat_hash_map<std::string, std::shared_ptr<const T>> values_;
+  /// The size at which to drop the unused values.
+  size_t prune_size_ = kMinPruneSize;
+};
+
 /// Class used by the core worker to keep track of ObjectID reference counts for garbage
 /// collection. This class is thread safe.
 class ReferenceCounter : public ReferenceCounterInterface {
@@ -62,11 +106,13 @@ class ReferenceCounter : public ReferenceCounterInterface {
   ReferenceCounter(const rpc::WorkerAddress &rpc_address,
                    bool distributed_ref_counting_enabled = true,
                    bool lineage_pinning_enabled = false,
-                   rpc::ClientFactoryFn client_factory = nullptr)
+                   rpc::ClientFactoryFn client_factory = nullptr,
+                   int64_t local_reference_batch_size = 0)
       : rpc_address_(rpc_address),
         distributed_ref_counting_enabled_(distributed_ref_counting_enabled),
         lineage_pinning_enabled_(lineage_pinning_enabled),
-        client_factory_(client_factory) {}
+        client_factory_(client_factory),
+        local_reference_batch_size_(local_reference_batch_size) {}
 
   ~ReferenceCounter() {}
 
@@ -90,6 +136,24 @@ class ReferenceCounter : public ReferenceCounterInterface {
   void RemoveLocalReference(const ObjectID &object_id, std::vector<ObjectID> *deleted)
       LOCKS_EXCLUDED(mutex_);
 
+  /// Decrease the local reference count for the ObjectID by one, without
+  /// taking the lock on the reference table if local reference batching is
+  /// enabled. The removal is buffered by the calling thread and applied once
+  /// the thread has buffered local_reference_batch_size removals, or on the
+  /// next call to FlushLocalReferences. Until then, the object stays in scope.
+  ///
+  /// \param[in] object_id The object to decrement the count for.
+  /// \param[out] deleted List to store objects that hit zero ref count, if
+  /// the buffered removals were applied.
+  void RemoveLocalReferenceBatched(const ObjectID &object_id,
+                                   std::vector<ObjectID> *deleted)
+      LOCKS_EXCLUDED(mutex_);
+
+  /// Apply the local reference removals that all threads have buffered.
+  ///
+  /// \param[out] deleted List to store objects that hit zero ref count.
+  void FlushLocalReferences(std::vector<ObjectID> *deleted) LOCKS_EXCLUDED(mutex_);
+
   /// Add references for the provided object IDs that correspond to them being
   /// dependencies to a submitted task. If lineage pinning is enabled, then
   /// this will also pin the Reference entry for each new argument until the
@@ -334,6 +398,16 @@ class ReferenceCounter : public ReferenceCounterInterface {
   bool IsPlasmaObjectPinned(const ObjectID &object_id, bool *pinned) const
       LOCKS_EXCLUDED(mutex_);
 
+  /// Get the total size of the given objects that is pinned on each node.
+  /// Only objects that we own and whose size and pinned location are known
+  /// are counted.
+  ///
+  /// \param[in] object_ids The objects to look up.
+  /// \return A map from node ID to the number of bytes of the objects that
+  /// are pinned on that node.
+  std::unordered_map<ClientID, int64_t> GetPinnedBytesByNode(
+      const std::vector<ObjectID> &object_ids) const LOCKS_EXCLUDED(mutex_);
+
   /// Get and reset the objects that were pinned on the given node.  This
   /// method should be called upon a node failure, to determine which plasma
   /// objects were lost. If a deletion callback was set for a lost object, it
@@ -357,21 +431,96 @@ class ReferenceCounter : public ReferenceCounterInterface {
       rpc::CoreWorkerStats *stats) const LOCKS_EXCLUDED(mutex_);
 
  private:
+  /// The state of a Reference that only objects that are nested in other
+  /// objects or borrowed by other processes have. Most objects have neither, so
+  /// this is kept out of line and only allocated when it is first needed.
+  struct BorrowInfo {
+    /// Object IDs that we own and that contain this object ID.
+    /// ObjectIDs are added to this field when we discover that this object
+    /// contains other IDs. This can happen in 2 cases:
+    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
+    ///  2. A task that we submitted returned an ID(s).
+    /// ObjectIDs are erased from this field when their Reference is deleted.
+    absl::flat_hash_set<ObjectID> contained_in_owned;
+    /// An Object ID that we (or one of our children) borrowed that contains
+    /// this object ID, which is also borrowed. This is used in cases where an
+    /// ObjectID is nested. We need to notify the owner of the outer ID of any
+    /// borrowers of this object, so we keep this field around until
+    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
+    /// is updated in 2 cases:
+    ///  1. We deserialize an ID that we do not own and that was stored in
+    ///     another object that we do not own.
+    ///  2. Case (1) occurred for a task that we submitted and we also do not
+    ///     own the inner or outer object. Then, we need to notify our caller
+    ///     that the task we submitted is a borrower for the inner ID.
+    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
+    /// called on contained_in_borrowed_id. For each borrower, this field is
+    /// set at most once during the reference's lifetime. If the object ID is
+    /// later found to be nested in a second object, we do not need to remember
+    /// the second ID because we will already have notified the owner of the
+    /// first outer object about our reference.
+    absl::optional<ObjectID> contained_in_borrowed_id;
+    /// The object IDs contained in this object. These could be objects that we
+    /// own or are borrowing. This field is updated in 2 cases:
+    ///  1. We call ray.put() on this ID and store the contained IDs.
+    ///  2. We call ray.get() on an ID whose contents we do not know and we
+    ///     discover that it contains these IDs.
+    absl::flat_hash_set<ObjectID> contains;
+    /// A list of processes that are we gave a reference to that are still
+    /// borrowing the ID. This field is updated in 2 cases:
+    ///  1. If we are a borrower of the ID, then we add a process to this list
+    ///     if we passed that process a copy of the ID via task submission and
+    ///     the process is still using the ID by the time it finishes its task.
+    ///     Borrowers are removed from the list when we recursively merge our
+    ///     list into the owner.
+    ///  2. If we are the owner of the ID, then either the above case, or when
+    ///     we hear from a borrower that it has passed the ID to other
+    ///     borrowers. A borrower is removed from the list when it responds
+    ///     that it is no longer using the reference.
+    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
+    /// When a process that is borrowing an object ID stores the ID inside the
+    /// return value of a task that it executes, the caller of the task is also
+    /// considered a borrower for as long as its reference to the task's return
+    /// ID stays in scope. Thus, the borrower must notify the owner that the
+    /// task's caller is also a borrower. The key is the task's return ID, and
+    /// the value is the task ID and address of the task's caller.
+    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
+    /// Callback that is called when this process is no longer a borrower
+    /// (RefCount() == 0).
+    std::function<void(const ObjectID &)> on_ref_removed;
+  };
+
   struct Reference {
     /// Constructor for a reference whose origin is unknown.
     Reference() {}
-    Reference(std::string call_site, const int64_t object_size)
-        : call_site(call_site), object_size(object_size) {}
+    Reference(std::shared_ptr<const std::string> call_site, const int64_t object_size)
+        : call_site(std::move(call_site)), object_size(object_size) {}
     /// Constructor for a reference that we created.
-    Reference(const rpc::Address &owner_address, std::string call_site,
-              const int64_t object_size, bool is_reconstructable,
+    Reference(std::shared_ptr<const rpc::Address> owner_address,
+              std::shared_ptr<const std::string> call_site, const int64_t object_size,
+              bool is_reconstructable,
               const absl::optional<ClientID> &pinned_at_raylet_id)
-        : call_site(call_site),
+        : call_site(std::move(call_site)),
           object_size(object_size),
           owned_by_us(true),
-          owner_address(owner_address),
-          pinned_at_raylet_id(pinned_at_raylet_id),
-          is_reconstructable(is_reconstructable) {}
+          is_reconstructable(is_reconstructable),
+          owner_address(std::move(owner_address)),
+          pinned_at_raylet_id(pinned_at_raylet_id) {}
+    Reference(Reference &&other) = default;
+    /// Copy constructor. The copy gets its own copy of the BorrowInfo.
+    Reference(const Reference &other)
+        : call_site(other.call_site),
+          object_size(other.object_size),
+          owned_by_us(other.owned_by_us),
+          is_reconstructable(other.is_reconstructable),
+          owner_address(other.owner_address),
+          pinned_at_raylet_id(other.pinned_at_raylet_id),
+          local_ref_count(other.local_ref_count),
+          submitted_task_ref_count(other.submitted_task_ref_count),
+          lineage_ref_count(other.lineage_ref_count),
+          on_delete(other.on_delete),
+          borrow_info(other.borrow_info ? new BorrowInfo(*other.borrow_info)
+                                        : nullptr) {}
 
     /// Constructor from a protobuf. This is assumed to be a message from
     /// another process, so the object defaults to not being owned by us.
@@ -385,7 +534,8 @@ class ReferenceCounter : public ReferenceCounterInterface {
     /// - ObjectIDs that we own, that contain this ObjectID, and that are still
     ///   in scope.
     size_t RefCount() const {
-      return local_ref_count + submitted_task_ref_count + contained_in_owned.size();
+      return local_ref_count + submitted_task_ref_count +
+             GetBorrowInfo().contained_in_owned.size();
     }
 
     /// Whether this reference is no longer in scope. A reference is in scope
@@ -396,9 +546,10 @@ class ReferenceCounter : public ReferenceCounterInterface {
     /// - We gave the reference to at least one other process.
     bool OutOfScope(bool lineage_pinning_enabled) const {
       bool in_scope = RefCount() > 0;
-      bool was_contained_in_borrowed_id = contained_in_borrowed_id.has_value();
-      bool has_borrowers = borrowers.size() > 0;
-      bool was_stored_in_objects = stored_in_objects.size() > 0;
+      bool was_contained_in_borrowed_id =
+          GetBorrowInfo().contained_in_borrowed_id.has_value();
+      bool has_borrowers = GetBorrowInfo().borrowers.size() > 0;
+      bool was_stored_in_objects = GetBorrowInfo().stored_in_objects.size() > 0;
 
       bool has_lineage_references = false;
       if (lineage_pinning_enabled && owned_by_us && !is_reconstructable) {
@@ -423,7 +574,29 @@ class ReferenceCounter : public ReferenceCounterInterface {
     }
 
     /// Description of the call site where the reference was created.
-    std::string call_site = "<unknown>";
+    const std::string &CallSite() const {
+      static const std::string unknown_call_site = "<unknown>";
+      return call_site ? *call_site : unknown_call_site;
+    }
+
+    /// The nesting and borrowing state of the reference. This is empty if it
+    /// was never set.
+    const BorrowInfo &GetBorrowInfo() const {
+      static const BorrowInfo empty_borrow_info;
+      return borrow_info ? *borrow_info : empty_borrow_info;
+    }
+
+    /// The nesting and borrowing state of the reference, for modification.
+    BorrowInfo *MutableBorrowInfo() {
+      if (!borrow_info) {
+        borrow_info.reset(new BorrowInfo());
+      }
+      return borrow_info.get();
+    }
+
+    /// Description of the call site where the reference was created. This is
+    /// interned, since many references are created at the same call site.
+    std::shared_ptr<const std::string> call_site;
     /// Object size if known, otherwise -1;
     int64_t object_size = -1;
 
@@ -431,74 +604,24 @@ class ReferenceCounter : public ReferenceCounterInterface {
     /// responsible for tracking the state of the task that creates the object
     /// (see task_manager.h).
     bool owned_by_us = false;
+    // Whether this object can be reconstructed via lineage. If false, then the
+    // object's value will be pinned as long as it is referenced by any other
+    // object's lineage.
+    const bool is_reconstructable = false;
     /// The object's owner's address, if we know it. If this process is the
     /// owner, then this is added during creation of the Reference. If this is
     /// process is a borrower, the borrower must add the owner's address before
-    /// using the ObjectID.
-    absl::optional<rpc::Address> owner_address;
+    /// using the ObjectID. This is interned, since there are few owners.
+    std::shared_ptr<const rpc::Address> owner_address;
     // If this object is owned by us and stored in plasma, and reference
     // counting is enabled, then some raylet must be pinning the object value.
     // This is the address of that raylet.
     absl::optional<ClientID> pinned_at_raylet_id;
-    // Whether this object can be reconstructed via lineage. If false, then the
-    // object's value will be pinned as long as it is referenced by any other
-    // object's lineage.
-    const bool is_reconstructable = false;
 
     /// The local ref count for the ObjectID in the language frontend.
     size_t local_ref_count = 0;
     /// The ref count for submitted tasks that depend on the ObjectID.
     size_t submitted_task_ref_count = 0;
-    /// Object IDs that we own and that contain this object ID.
-    /// ObjectIDs are added to this field when we discover that this object
-    /// contains other IDs. This can happen in 2 cases:
-    ///  1. We call ray.put() and store the inner ID(s) in the outer object.
-    ///  2. A task that we submitted returned an ID(s).
-    /// ObjectIDs are erased from this field when their Reference is deleted.
-    absl::flat_hash_set<ObjectID> contained_in_owned;
-    /// An Object ID that we (or one of our children) borrowed that contains
-    /// this object ID, which is also borrowed. This is used in cases where an
-    /// ObjectID is nested. We need to notify the owner of the outer ID of any
-    /// borrowers of this object, so we keep this field around until
-    /// GetAndClearLocalBorrowersInternal is called on the outer ID. This field
-    /// is updated in 2 cases:
-    ///  1. We deserialize an ID that we do not own and that was stored in
-    ///     another object that we do not own.
-    ///  2. Case (1) occurred for a task that we submitted and we also do not
-    ///     own the inner or outer object. Then, we need to notify our caller
-    ///     that the task we submitted is a borrower for the inner ID.
-    /// This field is reset to null once GetAndClearLocalBorrowersInternal is
-    /// called on contained_in_borrowed_id. For each borrower, this field is
-    /// set at most once during the reference's lifetime. If the object ID is
-    /// later found to be nested in a second object, we do not need to remember
-    /// the second ID because we will already have notified the owner of the
-    /// first outer object about our reference.
-    absl::optional<ObjectID> contained_in_borrowed_id;
-    /// The object IDs contained in this object. These could be objects that we
-    /// own or are borrowing. This field is updated in 2 cases:
-    ///  1. We call ray.put() on this ID and store the contained IDs.
-    ///  2. We call ray.get() on an ID whose contents we do not know and we
-    ///     discover that it contains these IDs.
-    absl::flat_hash_set<ObjectID> contains;
-    /// A list of processes that are we gave a reference to that are still
-    /// borrowing the ID. This field is updated in 2 cases:
-    ///  1. If we are a borrower of the ID, then we add a process to this list
-    ///     if we passed that process a copy of the ID via task submission and
-    ///     the process is still using the ID by the time it finishes its task.
-    ///     Borrowers are removed from the list when we recursively merge our
-    ///     list into the owner.
-    ///  2. If we are the owner of the ID, then either the above case, or when
-    ///     we hear from a borrower that it has passed the ID to other
-    ///     borrowers. A borrower is removed from the list when it responds
-    ///     that it is no longer using the reference.
-    absl::flat_hash_set<rpc::WorkerAddress> borrowers;
-    /// When a process that is borrowing an object ID stores the ID inside the
-    /// return value of a task that it executes, the caller of the task is also
-    /// considered a borrower for as long as its reference to the task's return
-    /// ID stays in scope. Thus, the borrower must notify the owner that the
-    /// task's caller is also a borrower. The key is the task's return ID, and
-    /// the value is the task ID and address of the task's caller.
-    absl::flat_hash_map<ObjectID, rpc::WorkerAddress> stored_in_objects;
     /// The number of tasks that depend on this object that may be retried in
     /// the future (pending execution or finished but retryable). If the object
     /// is inlined (not stored in plasma), then its lineage ref count is 0
@@ -508,9 +631,10 @@ class ReferenceCounter : public ReferenceCounterInterface {
     /// Callback that will be called when this ObjectID no longer has
     /// references.
     std::function<void(const ObjectID &)> on_delete;
-    /// Callback that is called when this process is no longer a borrower
-    /// (RefCount() == 0).
-    std::function<void(const ObjectID &)> on_ref_removed;
+
+    /// The nesting and borrowing state of the reference, or null if it was
+    /// never set.
+    std::unique_ptr<BorrowInfo> borrow_info;
   };
 
   using ReferenceTable = absl::flat_hash_map<ObjectID, Reference>;
@@ -617,6 +741,18 @@ class ReferenceCounter : public ReferenceCounterInterface {
                                  const rpc::Address &owner_address)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Helper method to decrease the local reference count for the ObjectID by
+  /// the given amount.
+  void RemoveLocalReferenceInternal(const ObjectID &object_id, int64_t count,
+                                    std::vector<ObjectID> *deleted)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Helper method to apply buffered local reference removals, with a single
+  /// acquisition of the lock on the reference table.
+  void ApplyLocalReferenceRemovals(
+      const absl::flat_hash_map<ObjectID, int64_t> &removals,
+      std::vector<ObjectID> *deleted) LOCKS_EXCLUDED(mutex_);
+
   /// Helper method to delete an entry from the reference map and run any necessary
   /// callbacks. Assumes that the entry is in object_id_refs_ and invalidates the
   /// iterator.
@@ -624,6 +760,14 @@ class ReferenceCounter : public ReferenceCounterInterface {
                                std::vector<ObjectID> *deleted)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  /// Return the shared copy of an owner address.
+  std::shared_ptr<const rpc::Address> InternOwnerAddress(const rpc::Address &address)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  /// Return the shared copy of a call site.
+  std::shared_ptr<const std::string> InternCallSite(const std::string &call_site)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   /// Helper method to decrement the lineage ref count for a list of objects.
   void ReleaseLineageReferencesInternal(const std::vector<ObjectID> &argument_ids)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -647,6 +791,26 @@ class ReferenceCounter : public ReferenceCounterInterface {
   /// Factory for producing new core worker clients.
   rpc::ClientFactoryFn client_factory_;
 
+  /// The number of local reference removals that a thread buffers before it
+  /// applies them. If 0, removals are applied immediately.
+  const int64_t local_reference_batch_size_;
+
+  /// Local reference removals that have not been applied to the reference
+  /// table yet. Threads are spread over the stripes by thread ID, so that
+  /// threads that remove references at the same time rarely share a lock.
+  struct LocalReferenceStripe {
+    absl::Mutex mu;
+    /// Map from object ID to the number of buffered removals.
+    absl::flat_hash_map<ObjectID, int64_t> removals GUARDED_BY(mu);
+    /// The total number of buffered removals.
+    int64_t num_removals GUARDED_BY(mu) = 0;
+  };
+  static constexpr size_t kNumLocalReferenceStripes = 16;
+  std::array<LocalReferenceStripe, kNumLocalReferenceStripes> local_reference_stripes_;
+
+  /// Return the stripe that the calling thread buffers its removals in.
+  LocalReferenceStripe &CurrentStripe();
+
   /// Map from worker address to core worker client. The owner of an object
   /// uses this client to request a notification from borrowers once the
   /// borrower's ref count for the ID goes to 0.
@@ -659,6 +823,11 @@ class ReferenceCounter : public ReferenceCounterInterface {
   /// Holds all reference counts and dependency information for tracked ObjectIDs.
   ReferenceTable object_id_refs_ GUARDED_BY(mutex_);
 
+  /// The owner addresses and call sites of the references in the table. Most
+  /// references share these with many others.
+  InternTable<rpc::Address> owner_addresses_ GUARDED_BY(mutex_);
+  InternTable<std::string> call_sites_ GUARDED_BY(mutex_);
+
   /// Objects whose values have been freed by the language frontend.
   /// The values in plasma will not be pinned. An object ID is
   /// removed from this set once its Reference has been deleted
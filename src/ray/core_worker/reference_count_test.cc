@@ -14,6 +14,7 @@
 
 #include "ray/core_worker/reference_count.h"
 
+#include <thread>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -50,6 +51,22 @@ class ReferenceCountLineageEnabledTest : public ::testing::Test {
   virtual void TearDown() {}
 };
 
+class ReferenceCountBatchingTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<ReferenceCounter> rc;
+  virtual void SetUp() {
+    rpc::Address addr;
+    rc = std::unique_ptr<ReferenceCounter>(
+        new ReferenceCounter(addr,
+                             /*distributed_ref_counting_enabled=*/true,
+                             /*lineage_pinning_enabled=*/false,
+                             /*client_factory=*/nullptr,
+                             /*local_reference_batch_size=*/3));
+  }
+
+  virtual void TearDown() {}
+};
+
 class MockWorkerClient : public rpc::CoreWorkerClientInterface {
  public:
   // Helper function to generate a random address.
@@ -348,6 +365,42 @@ TEST_F(ReferenceCountTest, TestOwnerAddress) {
   ASSERT_FALSE(rc->GetOwner(object_id3, &added_address));
 }
 
+// Tests that the owner addresses and call sites that objects share are kept
+// correctly as owners come and go.
+TEST_F(ReferenceCountTest, TestManyOwnerAddresses) {
+  const int num_owners = 5000;
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < num_owners; i++) {
+    rpc::Address address;
+    address.set_ip_address(std::to_string(i));
+    for (int j = 0; j < 2; j++) {
+      object_ids.push_back(ObjectID::FromRandom());
+      rc->AddLocalReference(object_ids.back(), "file.py:" + std::to_string(i % 10));
+      rc->AddBorrowedObject(object_ids.back(), ObjectID::Nil(), address);
+    }
+    // Remove the references from every other owner, so that their addresses
+    // are no longer used.
+    if (i % 2 == 0) {
+      rc->RemoveLocalReference(object_ids[2 * i], nullptr);
+      rc->RemoveLocalReference(object_ids[2 * i + 1], nullptr);
+    }
+  }
+
+  rpc::CoreWorkerStats stats;
+  rc->AddObjectRefStats({}, &stats);
+  ASSERT_EQ(stats.object_refs_size(), num_owners);
+  for (int i = 1; i < num_owners; i += 2) {
+    for (int j = 0; j < 2; j++) {
+      rpc::Address address;
+      ASSERT_TRUE(rc->GetOwner(object_ids[2 * i + j], &address));
+      ASSERT_EQ(address.ip_address(), std::to_string(i));
+    }
+  }
+  for (const auto &ref : stats.object_refs()) {
+    ASSERT_EQ(ref.call_site().substr(0, 8), "file.py:");
+  }
+}
+
 // Tests that the ref counts are properly integrated into the local
 // object memory store.
 TEST(MemoryStoreIntegrationTest, TestSimple) {
@@ -2057,6 +2110,125 @@ TEST_F(ReferenceCountTest, TestFree) {
   ASSERT_FALSE(rc->IsPlasmaObjectFreed(id));
 }
 
+// Tests that buffered local reference removals are only applied once the batch
+// is full or the buffer is flushed.
+TEST_F(ReferenceCountBatchingTest, TestBatchedRemoval) {
+  std::vector<ObjectID> out;
+  ObjectID id1 = ObjectID::FromRandom();
+  ObjectID id2 = ObjectID::FromRandom();
+
+  rc->AddLocalReference(id1, "");
+  rc->AddLocalReference(id2, "");
+  rc->RemoveLocalReferenceBatched(id1, &out);
+  rc->RemoveLocalReferenceBatched(id2, &out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 2);
+  ASSERT_EQ(out.size(), 0);
+  rc->FlushLocalReferences(&out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+  ASSERT_EQ(out.size(), 2);
+  out.clear();
+
+  // The third removal fills the batch.
+  rc->AddLocalReference(id1, "");
+  rc->AddLocalReference(id1, "");
+  rc->AddLocalReference(id2, "");
+  rc->RemoveLocalReferenceBatched(id1, &out);
+  rc->RemoveLocalReferenceBatched(id2, &out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 2);
+  rc->RemoveLocalReferenceBatched(id1, &out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+  ASSERT_EQ(out.size(), 2);
+  out.clear();
+
+  // Flushing an empty buffer does nothing.
+  rc->FlushLocalReferences(&out);
+  ASSERT_EQ(out.size(), 0);
+}
+
+// Tests that adding a reference cancels a buffered removal of the same object.
+TEST_F(ReferenceCountBatchingTest, TestAddCancelsBufferedRemoval) {
+  std::vector<ObjectID> out;
+  ObjectID id = ObjectID::FromRandom();
+
+  rc->AddLocalReference(id, "");
+  rc->RemoveLocalReferenceBatched(id, &out);
+  rc->AddLocalReference(id, "");
+  rc->FlushLocalReferences(&out);
+  ASSERT_TRUE(rc->HasReference(id));
+  ASSERT_EQ(out.size(), 0);
+
+  // The cancelled removal does not count towards the batch.
+  ObjectID id2 = ObjectID::FromRandom();
+  rc->AddLocalReference(id2, "");
+  rc->RemoveLocalReferenceBatched(id2, &out);
+  rc->AddLocalReference(id2, "");
+  rc->RemoveLocalReferenceBatched(id2, &out);
+  rc->RemoveLocalReferenceBatched(id, &out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 2);
+  rc->FlushLocalReferences(&out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+  ASSERT_EQ(out.size(), 2);
+}
+
+// Tests that batched removals are applied the same way as unbatched ones, when
+// the objects have other references too.
+TEST_F(ReferenceCountBatchingTest, TestBatchedRemovalWithSubmittedTasks) {
+  std::vector<ObjectID> out;
+  ObjectID id = ObjectID::FromRandom();
+
+  rc->AddLocalReference(id, "");
+  rc->UpdateSubmittedTaskReferences({id});
+  rc->RemoveLocalReferenceBatched(id, &out);
+  rc->FlushLocalReferences(&out);
+  ASSERT_TRUE(rc->HasReference(id));
+  ASSERT_EQ(out.size(), 0);
+  rc->UpdateFinishedTaskReferences({id}, false, empty_borrower, empty_refs, &out);
+  ASSERT_FALSE(rc->HasReference(id));
+  ASSERT_EQ(out.size(), 1);
+}
+
+// Tests that references added and removed by many threads at once are all
+// accounted for once the buffers are flushed.
+TEST_F(ReferenceCountBatchingTest, TestConcurrentAddAndRemove) {
+  const int num_threads = 8;
+  const int num_iterations = 1000;
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 10; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    rc->AddLocalReference(ids.back(), "");
+  }
+
+  std::vector<std::thread> threads;
+  std::vector<std::vector<ObjectID>> outs(num_threads);
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < num_iterations; i++) {
+        const auto &id = ids[(i + t) % ids.size()];
+        rc->AddLocalReference(id, "");
+        rc->AddLocalReference(id, "");
+        rc->RemoveLocalReferenceBatched(id, &outs[t]);
+        rc->RemoveLocalReferenceBatched(id, &outs[t]);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &out : outs) {
+    ASSERT_EQ(out.size(), 0);
+  }
+
+  std::vector<ObjectID> out;
+  rc->FlushLocalReferences(&out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), ids.size());
+  for (const auto &id : ids) {
+    rc->RemoveLocalReferenceBatched(id, &out);
+  }
+  rc->FlushLocalReferences(&out);
+  ASSERT_EQ(rc->NumObjectIDsInScope(), 0);
+  ASSERT_EQ(out.size(), ids.size());
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
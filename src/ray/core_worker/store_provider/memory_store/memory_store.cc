@@ -120,18 +120,25 @@ CoreWorkerMemoryStore::CoreWorkerMemoryStore(
     : store_in_plasma_(store_in_plasma),
       ref_counter_(counter),
       raylet_client_(raylet_client),
-      check_signals_(check_signals) {}
+      check_signals_(check_signals) {
+  const int64_t num_shards =
+      std::max<int64_t>(RayConfig::instance().memory_store_num_shards(), 1);
+  for (int64_t i = 0; i < num_shards; i++) {
+    shards_.emplace_back(new Shard());
+  }
+}
 
 void CoreWorkerMemoryStore::GetAsync(
     const ObjectID &object_id, std::function<void(std::shared_ptr<RayObject>)> callback) {
   std::shared_ptr<RayObject> ptr;
   {
-    absl::MutexLock lock(&mu_);
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       ptr = iter->second;
     } else {
-      object_async_get_requests_[object_id].push_back(callback);
+      shard.object_async_get_requests[object_id].push_back(callback);
     }
   }
   // It's important for performance to run the callback outside the lock.
@@ -142,9 +149,10 @@ void CoreWorkerMemoryStore::GetAsync(
 
 std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
     const ObjectID &object_id) {
-  absl::MutexLock lock(&mu_);
-  auto iter = objects_.find(object_id);
-  if (iter != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::MutexLock lock(&shard.mu);
+  auto iter = shard.objects.find(object_id);
+  if (iter != shard.objects.end()) {
     auto obj = iter->second;
     if (obj->IsInPlasmaError()) {
       return nullptr;
@@ -153,7 +161,7 @@ std::shared_ptr<RayObject> CoreWorkerMemoryStore::GetOrPromoteToPlasma(
   }
   RAY_CHECK(store_in_plasma_ != nullptr)
       << "Cannot promote object without plasma provider callback.";
-  promoted_to_plasma_.insert(object_id);
+  shard.promoted_to_plasma.insert(object_id);
   return nullptr;
 }
 
@@ -167,32 +175,33 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
   // plasma.
   bool should_put_in_plasma = false;
   {
-    absl::MutexLock lock(&mu_);
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
 
-    auto iter = objects_.find(object_id);
-    if (iter != objects_.end()) {
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
       return true;  // Object already exists in the store, which is fine.
     }
 
-    auto async_callback_it = object_async_get_requests_.find(object_id);
-    if (async_callback_it != object_async_get_requests_.end()) {
+    auto async_callback_it = shard.object_async_get_requests.find(object_id);
+    if (async_callback_it != shard.object_async_get_requests.end()) {
       auto &callbacks = async_callback_it->second;
       async_callbacks = std::move(callbacks);
-      object_async_get_requests_.erase(async_callback_it);
+      shard.object_async_get_requests.erase(async_callback_it);
     }
 
-    auto promoted_it = promoted_to_plasma_.find(object_id);
-    if (promoted_it != promoted_to_plasma_.end()) {
+    auto promoted_it = shard.promoted_to_plasma.find(object_id);
+    if (promoted_it != shard.promoted_to_plasma.end()) {
       RAY_CHECK(store_in_plasma_ != nullptr);
       // Only need to promote to plasma if it wasn't already put into plasma
       // by the task that created the object.
       should_put_in_plasma = !object.IsInPlasmaError();
-      promoted_to_plasma_.erase(promoted_it);
+      shard.promoted_to_plasma.erase(promoted_it);
     }
 
     bool should_add_entry = true;
-    auto object_request_iter = object_get_requests_.find(object_id);
-    if (object_request_iter != object_get_requests_.end()) {
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
       auto &get_requests = object_request_iter->second;
       for (auto &get_request : get_requests) {
         get_request->Set(object_id, object_entry);
@@ -209,7 +218,7 @@ bool CoreWorkerMemoryStore::Put(const RayObject &object, const ObjectID &object_
 
     if (should_add_entry) {
       // If there is no existing get request, then add the `RayObject` to map.
-      objects_.emplace(object_id, object_entry);
+      shard.objects.emplace(object_id, object_entry);
     }
   }
 
@@ -247,49 +256,62 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
   std::shared_ptr<GetRequest> get_request;
   int count = 0;
 
-  {
-    absl::flat_hash_set<ObjectID> remaining_ids;
-    absl::flat_hash_set<ObjectID> ids_to_remove;
-
-    absl::MutexLock lock(&mu_);
-    // Check for existing objects and see if this get request can be fullfilled.
-    for (size_t i = 0; i < object_ids.size() && count < num_objects; i++) {
-      const auto &object_id = object_ids[i];
-      auto iter = objects_.find(object_id);
-      if (iter != objects_.end()) {
-        (*results)[i] = iter->second;
-        if (remove_after_get) {
-          // Note that we cannot remove the object_id from `objects_` now,
-          // because `object_ids` might have duplicate ids.
-          ids_to_remove.insert(object_id);
-        }
-        count += 1;
-      } else {
-        remaining_ids.insert(object_id);
-      }
-    }
-    RAY_CHECK(count <= num_objects);
-
-    // Clean up the objects if ref counting is off.
-    if (ref_counter_ == nullptr) {
-      for (const auto &object_id : ids_to_remove) {
-        objects_.erase(object_id);
+  absl::flat_hash_set<ObjectID> remaining_ids;
+  absl::flat_hash_set<ObjectID> ids_to_remove;
+  // Check for existing objects and see if this get request can be fullfilled. This
+  // only needs shared access to the shards.
+  for (size_t i = 0; i < object_ids.size() && count < num_objects; i++) {
+    const auto &object_id = object_ids[i];
+    auto &shard = GetShard(object_id);
+    absl::ReaderMutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
+      (*results)[i] = iter->second;
+      if (remove_after_get) {
+        // Note that we cannot remove the object_id from `objects` now,
+        // because `object_ids` might have duplicate ids.
+        ids_to_remove.insert(object_id);
       }
+      count += 1;
+    } else {
+      remaining_ids.insert(object_id);
     }
-
-    // Return if all the objects are obtained.
-    if (remaining_ids.empty() || count >= num_objects) {
-      return Status::OK();
+  }
+  RAY_CHECK(count <= num_objects);
+
+  // Clean up the objects if ref counting is off.
+  if (ref_counter_ == nullptr) {
+    for (const auto &object_id : ids_to_remove) {
+      auto &shard = GetShard(object_id);
+      absl::MutexLock lock(&shard.mu);
+      shard.objects.erase(object_id);
     }
+  }
 
-    size_t required_objects = num_objects - (object_ids.size() - remaining_ids.size());
+  // Return if all the objects are obtained.
+  if (remaining_ids.empty() || count >= num_objects) {
+    return Status::OK();
+  }
 
-    // Otherwise, create a GetRequest to track remaining objects.
-    get_request =
-        std::make_shared<GetRequest>(std::move(remaining_ids), required_objects,
-                                     remove_after_get, abort_if_any_object_is_exception);
-    for (const auto &object_id : get_request->ObjectIds()) {
-      object_get_requests_[object_id].push_back(get_request);
+  size_t required_objects = num_objects - (object_ids.size() - remaining_ids.size());
+
+  // Otherwise, create a GetRequest to track remaining objects. An object may have been
+  // put since we checked for it, so check again while registering the request with
+  // the object's shard.
+  get_request =
+      std::make_shared<GetRequest>(std::move(remaining_ids), required_objects,
+                                   remove_after_get, abort_if_any_object_is_exception);
+  for (const auto &object_id : get_request->ObjectIds()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto iter = shard.objects.find(object_id);
+    if (iter != shard.objects.end()) {
+      get_request->Set(object_id, iter->second);
+      if (remove_after_get && ref_counter_ == nullptr) {
+        shard.objects.erase(iter);
+      }
+    } else {
+      shard.object_get_requests[object_id].push_back(get_request);
     }
   }
 
@@ -333,29 +355,28 @@ Status CoreWorkerMemoryStore::GetImpl(const std::vector<ObjectID> &object_ids,
     RAY_CHECK_OK(raylet_client_->NotifyDirectCallTaskUnblocked());
   }
 
-  {
-    absl::MutexLock lock(&mu_);
-    // Populate results.
-    for (size_t i = 0; i < object_ids.size(); i++) {
-      const auto &object_id = object_ids[i];
-      if ((*results)[i] == nullptr) {
-        (*results)[i] = get_request->Get(object_id);
-      }
+  // Populate results.
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    const auto &object_id = object_ids[i];
+    if ((*results)[i] == nullptr) {
+      (*results)[i] = get_request->Get(object_id);
     }
+  }
 
-    // Remove get request.
-    for (const auto &object_id : get_request->ObjectIds()) {
-      auto object_request_iter = object_get_requests_.find(object_id);
-      if (object_request_iter != object_get_requests_.end()) {
-        auto &get_requests = object_request_iter->second;
-        // Erase get_request from the vector.
-        auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
-        if (it != get_requests.end()) {
-          get_requests.erase(it);
-          // If the vector is empty, remove the object ID from the map.
-          if (get_requests.empty()) {
-            object_get_requests_.erase(object_request_iter);
-          }
+  // Remove get request.
+  for (const auto &object_id : get_request->ObjectIds()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto object_request_iter = shard.object_get_requests.find(object_id);
+    if (object_request_iter != shard.object_get_requests.end()) {
+      auto &get_requests = object_request_iter->second;
+      // Erase get_request from the vector.
+      auto it = std::find(get_requests.begin(), get_requests.end(), get_request);
+      if (it != get_requests.end()) {
+        get_requests.erase(it);
+        // If the vector is empty, remove the object ID from the map.
+        if (get_requests.empty()) {
+          shard.object_get_requests.erase(object_request_iter);
         }
       }
     }
@@ -419,30 +440,33 @@ Status CoreWorkerMemoryStore::Wait(const absl::flat_hash_set<ObjectID> &object_i
 
 void CoreWorkerMemoryStore::Delete(const absl::flat_hash_set<ObjectID> &object_ids,
                                    absl::flat_hash_set<ObjectID> *plasma_ids_to_delete) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    auto it = objects_.find(object_id);
-    if (it != objects_.end()) {
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    auto it = shard.objects.find(object_id);
+    if (it != shard.objects.end()) {
       if (it->second->IsInPlasmaError()) {
         plasma_ids_to_delete->insert(object_id);
       } else {
-        objects_.erase(it);
+        shard.objects.erase(it);
       }
     }
   }
 }
 
 void CoreWorkerMemoryStore::Delete(const std::vector<ObjectID> &object_ids) {
-  absl::MutexLock lock(&mu_);
   for (const auto &object_id : object_ids) {
-    objects_.erase(object_id);
+    auto &shard = GetShard(object_id);
+    absl::MutexLock lock(&shard.mu);
+    shard.objects.erase(object_id);
   }
 }
 
 bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma) {
-  absl::MutexLock lock(&mu_);
-  auto it = objects_.find(object_id);
-  if (it != objects_.end()) {
+  auto &shard = GetShard(object_id);
+  absl::ReaderMutexLock lock(&shard.mu);
+  auto it = shard.objects.find(object_id);
+  if (it != shard.objects.end()) {
     if (it->second->IsInPlasmaError()) {
       *in_plasma = true;
     }
@@ -451,15 +475,26 @@ bool CoreWorkerMemoryStore::Contains(const ObjectID &object_id, bool *in_plasma)
   return false;
 }
 
+int CoreWorkerMemoryStore::Size() {
+  int size = 0;
+  for (const auto &shard : shards_) {
+    absl::ReaderMutexLock lock(&shard->mu);
+    size += shard->objects.size();
+  }
+  return size;
+}
+
 MemoryStoreStats CoreWorkerMemoryStore::GetMemoryStoreStatisticalData() {
-  absl::MutexLock lock(&mu_);
   MemoryStoreStats item;
-  for (const auto &it : objects_) {
-    if (it.second->IsInPlasmaError()) {
-      item.num_in_plasma += 1;
-    } else {
-      item.num_local_objects += 1;
-      item.used_object_store_memory += it.second->GetSize();
+  for (const auto &shard : shards_) {
+    absl::ReaderMutexLock lock(&shard->mu);
+    for (const auto &it : shard->objects) {
+      if (it.second->IsInPlasmaError()) {
+        item.num_in_plasma += 1;
+      } else {
+        item.num_local_objects += 1;
+        item.used_object_store_memory += it.second->GetSize();
+      }
     }
   }
   return item;
@@ -138,6 +138,66 @@ Status CoreWorkerPlasmaStoreProvider::Create(const std::shared_ptr<Buffer> &meta
   return status;
 }
 
+Status CoreWorkerPlasmaStoreProvider::CreateBatch(
+    const std::vector<std::shared_ptr<Buffer>> &metadatas,
+    const std::vector<size_t> &data_sizes, const std::vector<ObjectID> &object_ids,
+    std::vector<std::shared_ptr<Buffer>> *data) {
+  RAY_CHECK(metadatas.size() == object_ids.size());
+  RAY_CHECK(data_sizes.size() == object_ids.size());
+  std::vector<int64_t> plasma_data_sizes;
+  std::vector<const uint8_t *> plasma_metadatas;
+  std::vector<int64_t> plasma_metadata_sizes;
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    plasma_data_sizes.push_back(data_sizes[i]);
+    plasma_metadatas.push_back(metadatas[i] ? metadatas[i]->Data() : nullptr);
+    plasma_metadata_sizes.push_back(metadatas[i] ? metadatas[i]->Size() : 0);
+  }
+  // If we cannot retry, then always evict on the first attempt.
+  bool evict_if_full =
+      RayConfig::instance().object_store_full_max_retries() == 0 ? true : evict_if_full_;
+  std::vector<std::shared_ptr<arrow::Buffer>> arrow_buffers;
+  std::vector<Status> plasma_statuses;
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.CreateBatch(
+        object_ids, plasma_data_sizes, plasma_metadatas, plasma_metadata_sizes,
+        &arrow_buffers, &plasma_statuses, evict_if_full));
+  }
+
+  data->assign(object_ids.size(), nullptr);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (plasma_statuses[i].ok()) {
+      (*data)[i] = std::make_shared<PlasmaBuffer>(PlasmaBuffer(arrow_buffers[i]));
+    }
+  }
+  Status status;
+  for (size_t i = 0; i < object_ids.size() && status.ok(); i++) {
+    if (plasma_statuses[i].IsObjectExists()) {
+      RAY_LOG(WARNING) << "Trying to put an object that already existed in plasma: "
+                       << object_ids[i] << ".";
+    } else if (plasma_statuses[i].IsObjectStoreFull()) {
+      // Fall back to creating the object on its own, which waits for space to
+      // free up.
+      status = Create(metadatas[i], data_sizes[i], object_ids[i], &(*data)[i]);
+    } else if (!plasma_statuses[i].ok()) {
+      status = plasma_statuses[i];
+    }
+  }
+  if (!status.ok()) {
+    // Abort the objects that were created, so that they do not stay unsealed in
+    // the store. Release the reference that Seal would have released first.
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    for (size_t i = 0; i < object_ids.size(); i++) {
+      if ((*data)[i] != nullptr) {
+        (*data)[i] = nullptr;
+        RAY_UNUSED(store_client_.Release(object_ids[i]));
+        RAY_UNUSED(store_client_.Abort(object_ids[i]));
+      }
+    }
+  }
+  return status;
+}
+
 Status CoreWorkerPlasmaStoreProvider::Seal(const ObjectID &object_id) {
   {
     std::lock_guard<std::mutex> guard(store_client_mutex_);
@@ -154,6 +214,23 @@ Status CoreWorkerPlasmaStoreProvider::Release(const ObjectID &object_id) {
   return Status::OK();
 }
 
+Status CoreWorkerPlasmaStoreProvider::SealBatch(const std::vector<ObjectID> &object_ids) {
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.SealBatch(object_ids));
+  }
+  return Status::OK();
+}
+
+Status CoreWorkerPlasmaStoreProvider::ReleaseBatch(
+    const std::vector<ObjectID> &object_ids) {
+  {
+    std::lock_guard<std::mutex> guard(store_client_mutex_);
+    RAY_RETURN_NOT_OK(store_client_.ReleaseBatch(object_ids));
+  }
+  return Status::OK();
+}
+
 Status CoreWorkerPlasmaStoreProvider::FetchAndGetFromPlasmaStore(
     absl::flat_hash_set<ObjectID> &remaining, const std::vector<ObjectID> &batch_ids,
     int64_t timeout_ms, bool fetch_only, bool in_direct_call, const TaskID &task_id,
@@ -67,6 +67,21 @@ class CoreWorkerPlasmaStoreProvider {
   Status Create(const std::shared_ptr<Buffer> &metadata, const size_t data_size,
                 const ObjectID &object_id, std::shared_ptr<Buffer> *data);
 
+  /// Create many objects in plasma with a single request to the store. This is
+  /// equivalent to calling Create() for each object. Objects that do not fit in the
+  /// store are retried one at a time, the same way as in Create().
+  ///
+  /// \param[in] metadatas The metadata of the objects.
+  /// \param[in] data_sizes The sizes of the objects.
+  /// \param[in] object_ids The IDs of the objects.
+  /// \param[out] data The mutable object buffers in plasma that can be written to. An
+  /// entry is nullptr if the object already existed.
+  /// \return Status. If this is not OK, none of the objects were created.
+  Status CreateBatch(const std::vector<std::shared_ptr<Buffer>> &metadatas,
+                     const std::vector<size_t> &data_sizes,
+                     const std::vector<ObjectID> &object_ids,
+                     std::vector<std::shared_ptr<Buffer>> *data);
+
   /// Seal an object buffer created with Create().
   ///
   /// NOTE: The caller must subsequently call Release() to release the first reference to
@@ -84,6 +99,20 @@ class CoreWorkerPlasmaStoreProvider {
   /// argument to Get to retrieve the object data.
   Status Release(const ObjectID &object_id);
 
+  /// Seal many object buffers created with Create() or CreateBatch() with a single
+  /// request to the store.
+  ///
+  /// NOTE: The caller must subsequently call ReleaseBatch() or Release() to release the
+  /// first reference to the created objects.
+  ///
+  /// \param[in] object_ids The IDs of the objects.
+  Status SealBatch(const std::vector<ObjectID> &object_ids);
+
+  /// Release the first reference to many objects with a single request to the store.
+  ///
+  /// \param[in] object_ids The IDs of the objects.
+  Status ReleaseBatch(const std::vector<ObjectID> &object_ids);
+
   Status Get(const absl::flat_hash_set<ObjectID> &object_ids, int64_t timeout_ms,
              const WorkerContext &ctx,
              absl::flat_hash_map<ObjectID, std::shared_ptr<RayObject>> *results,
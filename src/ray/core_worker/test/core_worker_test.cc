@@ -30,6 +30,7 @@
 #include "ray/common/test_util.h"
 #include "ray/core_worker/context.h"
 #include "ray/core_worker/store_provider/memory_store/memory_store.h"
+#include "ray/core_worker/store_provider/plasma_store_provider.h"
 #include "ray/core_worker/transport/direct_actor_transport.h"
 #include "ray/raylet_client/raylet_client.h"
 #include "ray/util/filesystem.h"
@@ -771,6 +772,115 @@ TEST_F(SingleNodeTest, TestMemoryStoreProvider) {
   }
 }
 
+TEST_F(SingleNodeTest, TestGetObjectStatusInlinesSmallObjects) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  ASSERT_TRUE(RayConfig::instance().put_small_object_in_memory_store());
+
+  uint8_t small_array[] = {1, 2, 3, 4, 5, 6, 7, 8};
+  const size_t large_size = 200 * 1024;
+  std::vector<uint8_t> large_array(large_size, 1);
+  ObjectID small_id, large_id, nested_id;
+  RAY_CHECK_OK(core_worker.Put(
+      RayObject(std::make_shared<LocalMemoryBuffer>(small_array, sizeof(small_array)),
+                std::make_shared<LocalMemoryBuffer>(small_array, 2),
+                std::vector<ObjectID>()),
+      {}, &small_id));
+  RAY_CHECK_OK(core_worker.Put(
+      RayObject(std::make_shared<LocalMemoryBuffer>(large_array.data(), large_size),
+                nullptr, std::vector<ObjectID>()),
+      {}, &large_id));
+  RAY_CHECK_OK(core_worker.Put(
+      RayObject(std::make_shared<LocalMemoryBuffer>(small_array, sizeof(small_array)),
+                nullptr, std::vector<ObjectID>({small_id})),
+      {small_id}, &nested_id));
+
+  auto get_object_status = [&core_worker](const ObjectID &object_id) {
+    rpc::GetObjectStatusRequest request;
+    request.set_object_id(object_id.Binary());
+    request.set_owner_worker_id(core_worker.GetWorkerID().Binary());
+    rpc::GetObjectStatusReply reply;
+    bool replied = false;
+    core_worker.HandleGetObjectStatus(
+        request, &reply,
+        [&replied](Status status, std::function<void()> success,
+                   std::function<void()> failure) { replied = true; });
+    RAY_CHECK(replied);
+    return reply;
+  };
+
+  // The small object is sent with the reply.
+  auto reply = get_object_status(small_id);
+  ASSERT_EQ(reply.status(), rpc::GetObjectStatusReply::CREATED);
+  ASSERT_TRUE(reply.inlined());
+  ASSERT_EQ(reply.data(),
+            std::string(reinterpret_cast<char *>(small_array), sizeof(small_array)));
+  ASSERT_EQ(reply.metadata(), std::string(reinterpret_cast<char *>(small_array), 2));
+  // The large object is in plasma, and the caller must fetch it from there.
+  ASSERT_FALSE(get_object_status(large_id).inlined());
+  // Objects that contain other objects are not sent, since the caller would
+  // not know about the nested references.
+  ASSERT_FALSE(get_object_status(nested_id).inlined());
+}
+
+TEST_F(SingleNodeTest, TestHandlePushTasks) {
+  auto &core_worker = CoreWorkerProcess::GetCoreWorker();
+  int num_replies = 0;
+  auto send_reply_callback = [&num_replies](Status status, std::function<void()> success,
+                                            std::function<void()> failure) {
+    ASSERT_TRUE(status.ok());
+    num_replies++;
+  };
+
+  // An empty batch is replied to right away.
+  rpc::PushTasksReply empty_reply;
+  core_worker.HandlePushTasks(rpc::PushTasksRequest(), &empty_reply,
+                              send_reply_callback);
+  ASSERT_EQ(num_replies, 1);
+  ASSERT_EQ(empty_reply.results_size(), 0);
+
+  // Tasks that are meant for another worker are rejected one by one, and the
+  // batch is replied to once with a result for each of them.
+  rpc::PushTasksRequest request;
+  for (int i = 0; i < 3; i++) {
+    request.add_requests()->set_intended_worker_id(WorkerID::FromRandom().Binary());
+  }
+  rpc::PushTasksReply reply;
+  core_worker.HandlePushTasks(request, &reply, send_reply_callback);
+  ASSERT_EQ(num_replies, 2);
+  ASSERT_EQ(reply.results_size(), 3);
+  for (const auto &result : reply.results()) {
+    ASSERT_EQ(result.status_code(), static_cast<int>(StatusCode::Invalid));
+    ASSERT_NE(result.status_message().find("Mismatched WorkerID"), std::string::npos);
+  }
+}
+
+TEST_F(SingleNodeTest, TestPlasmaCreateBatchPartialFailure) {
+  // Fail right away when an object does not fit in the store.
+  RayConfig::instance().initialize({{"object_store_full_max_retries", "0"}});
+  CoreWorkerPlasmaStoreProvider provider(
+      raylet_store_socket_names_[0], nullptr, nullptr,
+      []() { return Status::OK(); }, /*evict_if_full=*/true);
+
+  // The object in the middle is larger than the store.
+  std::vector<ObjectID> ids = {ObjectID::FromRandom(), ObjectID::FromRandom(),
+                               ObjectID::FromRandom()};
+  std::vector<std::shared_ptr<Buffer>> data;
+  ASSERT_TRUE(provider
+                  .CreateBatch({nullptr, nullptr, nullptr}, {100, 100 * 1000 * 1000, 100},
+                               ids, &data)
+                  .IsObjectStoreFull());
+
+  // The objects before and after it were aborted, so they can be created again.
+  for (const auto &id : {ids[0], ids[2]}) {
+    std::shared_ptr<Buffer> buffer;
+    RAY_CHECK_OK(provider.Create(nullptr, 100, id, &buffer));
+    ASSERT_NE(buffer, nullptr);
+    RAY_CHECK_OK(provider.Seal(id));
+    RAY_CHECK_OK(provider.Release(id));
+  }
+  RayConfig::instance().initialize({{"object_store_full_max_retries", "5"}});
+}
+
 TEST_F(SingleNodeTest, TestObjectInterface) {
   auto &core_worker = CoreWorkerProcess::GetCoreWorker();
 
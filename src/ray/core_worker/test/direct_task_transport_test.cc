@@ -38,7 +38,8 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     return Status::OK();
   }
 
-  bool ReplyPushTask(Status status = Status::OK(), bool exit = false) {
+  bool ReplyPushTask(Status status = Status::OK(), bool exit = false,
+                     int64_t execution_time_us = 0) {
     if (callbacks.size() == 0) {
       return false;
     }
@@ -47,6 +48,8 @@ class MockWorkerClient : public rpc::CoreWorkerClientInterface {
     if (exit) {
       reply.set_worker_exiting(true);
     }
+    reply.set_execution_time_us(execution_time_us);
+    reply.set_handling_time_us(execution_time_us);
     callback(status, reply);
     callbacks.pop_front();
     return true;
@@ -106,8 +109,12 @@ class MockRayletClient : public WorkerLeaseInterface {
 
   ray::Status RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
-      const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback) override {
+      const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
+      int64_t backlog_size,
+      const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) override {
     num_workers_requested += 1;
+    backlog_sizes.push_back(backlog_size);
+    arg_bytes_by_node_requested.push_back(arg_bytes_by_node);
     callbacks.push_back(callback);
     return Status::OK();
   }
@@ -170,6 +177,8 @@ class MockRayletClient : public WorkerLeaseInterface {
   int num_workers_returned = 0;
   int num_workers_disconnected = 0;
   int num_leases_canceled = 0;
+  std::vector<int64_t> backlog_sizes;
+  std::vector<std::unordered_map<ClientID, int64_t>> arg_bytes_by_node_requested;
   std::list<rpc::ClientCallback<rpc::RequestWorkerLeaseReply>> callbacks = {};
   std::list<rpc::ClientCallback<rpc::CancelWorkerLeaseReply>> cancel_callbacks = {};
 };
@@ -198,6 +207,54 @@ TEST(TestMemoryStore, TestPromoteToPlasma) {
   ASSERT_TRUE(num_plasma_puts == 1);
 }
 
+TEST(TestMemoryStore, TestConcurrentPutAndGet) {
+  auto mem = std::make_shared<CoreWorkerMemoryStore>();
+  WorkerContext ctx(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil());
+  // Enough objects that they are spread over many shards.
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 100; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+  }
+  auto data = GenerateRandomObject();
+
+  // Put half of the objects before the get, and the rest from other threads while
+  // it waits.
+  for (size_t i = 0; i < object_ids.size() / 2; i++) {
+    ASSERT_TRUE(mem->Put(*data, object_ids[i]));
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&, t]() {
+      for (size_t i = object_ids.size() / 2 + t; i < object_ids.size(); i += 4) {
+        RAY_CHECK(mem->Put(*data, object_ids[i]));
+      }
+    });
+  }
+  std::vector<std::shared_ptr<RayObject>> results;
+  ASSERT_TRUE(mem->Get(object_ids, object_ids.size(), -1, ctx,
+                       /*remove_after_get=*/false, &results)
+                  .ok());
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (const auto &result : results) {
+    ASSERT_TRUE(result != nullptr);
+  }
+  ASSERT_EQ(mem->Size(), object_ids.size());
+
+  // Waiting for some of the objects returns once enough are available.
+  absl::flat_hash_set<ObjectID> wait_ids(object_ids.begin(), object_ids.begin() + 10);
+  ObjectID missing_id = ObjectID::FromRandom();
+  wait_ids.insert(missing_id);
+  absl::flat_hash_set<ObjectID> ready;
+  ASSERT_TRUE(mem->Wait(wait_ids, 10, -1, ctx, &ready).ok());
+  ASSERT_EQ(ready.size(), 10);
+  ASSERT_FALSE(ready.contains(missing_id));
+
+  mem->Delete(object_ids);
+  ASSERT_EQ(mem->Size(), 0);
+}
+
 TEST(LocalDependencyResolverTest, TestNoDependencies) {
   auto store = std::make_shared<CoreWorkerMemoryStore>();
   auto task_finisher = std::make_shared<MockTaskFinisher>();
@@ -316,7 +373,8 @@ TaskSpecification BuildTaskSpec(const std::unordered_map<std::string, double> &r
                                 const ray::FunctionDescriptor &function_descriptor) {
   TaskSpecBuilder builder;
   rpc::Address empty_address;
-  builder.SetCommonTaskSpec(TaskID::Nil(), Language::PYTHON, function_descriptor,
+  // Give each task its own ID, since lease requests are identified by task ID.
+  builder.SetCommonTaskSpec(TaskID::ForFakeTask(), Language::PYTHON, function_descriptor,
                             JobID::Nil(), TaskID::Nil(), 0, TaskID::Nil(), empty_address,
                             1, resources, resources);
   return builder.Build();
@@ -391,7 +449,8 @@ TEST(DirectTaskTransportTest, TestConcurrentWorkerLeases) {
   auto factory = [&](const rpc::Address &addr) { return worker_client; };
   auto task_finisher = std::make_shared<MockTaskFinisher>();
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
-                                          task_finisher, ClientID::Nil(), kLongTimeout);
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1);
   std::unordered_map<std::string, double> empty_resources;
   ray::FunctionDescriptor empty_descriptor =
       ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
@@ -431,7 +490,51 @@ TEST(DirectTaskTransportTest, TestConcurrentWorkerLeases) {
   ASSERT_FALSE(raylet_client->ReplyCancelWorkerLease());
 }
 
-TEST(DirectTaskTransportTest, TestReuseWorkerLease) {
+TEST(DirectTaskTransportTest, TestMultipleLeaseRequestsInFlight) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto factory = [&](const rpc::Address &addr) { return worker_client; };
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 2);
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  TaskSpecification task1 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task2 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task3 = BuildTaskSpec(empty_resources, empty_descriptor);
+
+  // One request per queued task, up to the limit of 2.
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task3).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 2);
+  ASSERT_EQ(raylet_client->backlog_sizes, std::vector<int64_t>({1, 2}));
+
+  // Task 1 is pushed; another worker is requested for task 3.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, ClientID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+  ASSERT_EQ(raylet_client->backlog_sizes.back(), 2);
+
+  // Tasks 2 and 3 are pushed; no more workers requested.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1001, ClientID::Nil()));
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1002, ClientID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 3);
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+
+  while (!worker_client->callbacks.empty()) {
+    ASSERT_TRUE(worker_client->ReplyPushTask());
+  }
+  ASSERT_EQ(raylet_client->num_workers_returned, 3);
+  ASSERT_EQ(task_finisher->num_tasks_complete, 3);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 0);
+}
+
+TEST(DirectTaskTransportTest, TestSeveralPendingLeaseRequests) {
   rpc::Address address;
   auto raylet_client = std::make_shared<MockRayletClient>();
   auto worker_client = std::make_shared<MockWorkerClient>();
@@ -441,6 +544,89 @@ TEST(DirectTaskTransportTest, TestReuseWorkerLease) {
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
                                           task_finisher, ClientID::Nil(), kLongTimeout);
   std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  const int64_t max_pending =
+      RayConfig::instance().max_pending_lease_requests_per_scheduling_class();
+  ASSERT_GT(max_pending, 1);
+  const int64_t num_tasks = max_pending + 2;
+
+  // With the default limit, one request is sent per queued task until the
+  // limit is reached.
+  for (int64_t i = 0; i < num_tasks; i++) {
+    ASSERT_TRUE(
+        submitter.SubmitTask(BuildTaskSpec(empty_resources, empty_descriptor)).ok());
+    ASSERT_EQ(raylet_client->num_workers_requested, std::min(i + 1, max_pending));
+  }
+
+  // Every granted lease runs one task, and is replaced by another request
+  // while more tasks are queued than requests are in flight.
+  for (int64_t i = 0; i < num_tasks; i++) {
+    ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000 + i, ClientID::Nil()));
+    ASSERT_EQ(worker_client->callbacks.size(), i + 1);
+  }
+  ASSERT_EQ(raylet_client->num_workers_requested, num_tasks);
+
+  while (!worker_client->callbacks.empty()) {
+    ASSERT_TRUE(worker_client->ReplyPushTask());
+  }
+  ASSERT_EQ(raylet_client->num_workers_returned, num_tasks);
+  ASSERT_EQ(task_finisher->num_tasks_complete, num_tasks);
+  ASSERT_EQ(raylet_client->num_leases_canceled, 0);
+}
+
+TEST(DirectTaskTransportTest, TestCancelAllLeaseRequestsInFlight) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto factory = [&](const rpc::Address &addr) { return worker_client; };
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 10);
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  TaskSpecification task1 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task2 = BuildTaskSpec(empty_resources, empty_descriptor);
+  TaskSpecification task3 = BuildTaskSpec(empty_resources, empty_descriptor);
+
+  ASSERT_TRUE(submitter.SubmitTask(task1).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task2).ok());
+  ASSERT_TRUE(submitter.SubmitTask(task3).ok());
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+
+  // The first worker runs all of the tasks, so the other requests are canceled
+  // once the queue is empty.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, ClientID::Nil()));
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_leases_canceled, 0);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(raylet_client->num_leases_canceled, 2);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(task_finisher->num_tasks_complete, 3);
+
+  // The raylet drops both requests.
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->ReplyCancelWorkerLease());
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("", 0, ClientID::Nil(), /*cancel=*/true));
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("", 0, ClientID::Nil(), /*cancel=*/true));
+  ASSERT_EQ(raylet_client->num_workers_requested, 3);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+}
+
+TEST(DirectTaskTransportTest, TestReuseWorkerLease) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto factory = [&](const rpc::Address &addr) { return worker_client; };
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1);
+  std::unordered_map<std::string, double> empty_resources;
   ray::FunctionDescriptor empty_descriptor =
       ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
   TaskSpecification task1 = BuildTaskSpec(empty_resources, empty_descriptor);
@@ -494,7 +680,8 @@ TEST(DirectTaskTransportTest, TestRetryLeaseCancellation) {
   auto factory = [&](const rpc::Address &addr) { return worker_client; };
   auto task_finisher = std::make_shared<MockTaskFinisher>();
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
-                                          task_finisher, ClientID::Nil(), kLongTimeout);
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1);
   std::unordered_map<std::string, double> empty_resources;
   ray::FunctionDescriptor empty_descriptor =
       ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
@@ -597,7 +784,8 @@ TEST(DirectTaskTransportTest, TestWorkerNotReusedOnError) {
   auto factory = [&](const rpc::Address &addr) { return worker_client; };
   auto task_finisher = std::make_shared<MockTaskFinisher>();
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
-                                          task_finisher, ClientID::Nil(), kLongTimeout);
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1);
   std::unordered_map<std::string, double> empty_resources;
   ray::FunctionDescriptor empty_descriptor =
       ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
@@ -790,7 +978,8 @@ void TestSchedulingKey(const std::shared_ptr<CoreWorkerMemoryStore> store,
   auto factory = [&](const rpc::Address &addr) { return worker_client; };
   auto task_finisher = std::make_shared<MockTaskFinisher>();
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
-                                          task_finisher, ClientID::Nil(), kLongTimeout);
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1);
 
   ASSERT_TRUE(submitter.SubmitTask(same1).ok());
   ASSERT_TRUE(submitter.SubmitTask(same2).ok());
@@ -901,7 +1090,8 @@ TEST(DirectTaskTransportTest, TestWorkerLeaseTimeout) {
   auto task_finisher = std::make_shared<MockTaskFinisher>();
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
                                           task_finisher, ClientID::Nil(),
-                                          /*lease_timeout_ms=*/5);
+                                          /*lease_timeout_ms=*/5, 1, nullptr,
+                                          absl::nullopt, 1);
   std::unordered_map<std::string, double> empty_resources;
   ray::FunctionDescriptor empty_descriptor =
       ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
@@ -1057,7 +1247,8 @@ TEST(DirectTaskTransportTest, TestPipeliningConcurrentWorkerLeases) {
   uint32_t max_tasks_in_flight_per_worker = 10;
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
                                           task_finisher, ClientID::Nil(), kLongTimeout,
-                                          max_tasks_in_flight_per_worker);
+                                          max_tasks_in_flight_per_worker, nullptr,
+                                          absl::nullopt, 1);
 
   // Prepare 20 tasks and save them in a vector.
   std::unordered_map<std::string, double> empty_resources;
@@ -1125,7 +1316,8 @@ TEST(DirectTaskTransportTest, TestPipeliningReuseWorkerLease) {
   uint32_t max_tasks_in_flight_per_worker = 10;
   CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
                                           task_finisher, ClientID::Nil(), kLongTimeout,
-                                          max_tasks_in_flight_per_worker);
+                                          max_tasks_in_flight_per_worker, nullptr,
+                                          absl::nullopt, 1);
 
   // prepare 30 tasks and save them in a vector
   std::unordered_map<std::string, double> empty_resources;
@@ -1184,6 +1376,87 @@ TEST(DirectTaskTransportTest, TestPipeliningReuseWorkerLease) {
   ASSERT_FALSE(raylet_client->ReplyCancelWorkerLease());
 }
 
+TEST(DirectTaskTransportTest, TestAdaptivePipelining) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto factory = [&](const rpc::Address &addr) { return worker_client; };
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  CoreWorkerDirectTaskSubmitter submitter(address, raylet_client, factory, nullptr, store,
+                                          task_finisher, ClientID::Nil(), kLongTimeout,
+                                          1, nullptr, absl::nullopt, 1, 4);
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+  for (int i = 0; i < 10; i++) {
+    TaskSpecification task = BuildTaskSpec(empty_resources, empty_descriptor);
+    ASSERT_TRUE(submitter.SubmitTask(task).ok());
+  }
+
+  // Only one task is sent until we know how long the tasks take.
+  ASSERT_TRUE(raylet_client->GrantWorkerLease("localhost", 1000, ClientID::Nil()));
+  ASSERT_EQ(worker_client->callbacks.size(), 1);
+
+  // The task was much shorter than the round trip, so the pipeline is filled up to
+  // the limit.
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::OK(), false, 100));
+  ASSERT_EQ(worker_client->callbacks.size(), 4);
+
+  // A long task stops the pipelining, so that no more tasks are queued behind it.
+  ASSERT_TRUE(worker_client->ReplyPushTask(Status::OK(), false, 1000 * 1000));
+  ASSERT_EQ(worker_client->callbacks.size(), 3);
+  ASSERT_TRUE(worker_client->ReplyPushTask());
+  ASSERT_EQ(worker_client->callbacks.size(), 2);
+
+  while (!worker_client->callbacks.empty()) {
+    ASSERT_TRUE(worker_client->ReplyPushTask());
+  }
+  ASSERT_EQ(task_finisher->num_tasks_complete, 10);
+  ASSERT_EQ(raylet_client->num_workers_returned, 1);
+}
+
+TEST(DirectTaskTransportTest, TestLeaseRequestArgLocations) {
+  rpc::Address address;
+  auto raylet_client = std::make_shared<MockRayletClient>();
+  auto worker_client = std::make_shared<MockWorkerClient>();
+  auto store = std::make_shared<CoreWorkerMemoryStore>();
+  auto factory = [&](const rpc::Address &addr) { return worker_client; };
+  auto task_finisher = std::make_shared<MockTaskFinisher>();
+  ClientID node_id = ClientID::FromRandom();
+  std::vector<std::vector<ObjectID>> looked_up;
+  auto get_arg_bytes_by_node = [&](const std::vector<ObjectID> &object_ids) {
+    looked_up.push_back(object_ids);
+    return std::unordered_map<ClientID, int64_t>({{node_id, 1000}});
+  };
+  CoreWorkerDirectTaskSubmitter submitter(
+      address, raylet_client, factory, nullptr, store, task_finisher, ClientID::Nil(),
+      kLongTimeout, 1, nullptr, absl::nullopt, 1, 0, get_arg_bytes_by_node);
+  std::unordered_map<std::string, double> empty_resources;
+  ray::FunctionDescriptor empty_descriptor =
+      ray::FunctionDescriptorBuilder::BuildPython("", "", "", "");
+
+  // Tasks without plasma arguments are sent without locations.
+  TaskSpecification no_args_task = BuildTaskSpec(empty_resources, empty_descriptor);
+  ASSERT_TRUE(submitter.SubmitTask(no_args_task).ok());
+  ASSERT_EQ(raylet_client->arg_bytes_by_node_requested.size(), 1);
+  ASSERT_TRUE(raylet_client->arg_bytes_by_node_requested[0].empty());
+  ASSERT_TRUE(looked_up.empty());
+
+  // Tasks with plasma arguments are sent with the locations of the arguments.
+  ObjectID plasma_id = ObjectID::FromRandom();
+  ASSERT_TRUE(store->Put(RayObject(rpc::ErrorType::OBJECT_IN_PLASMA), plasma_id));
+  TaskSpecification task = BuildTaskSpec(empty_resources, empty_descriptor);
+  task.GetMutableMessage().add_args()->mutable_object_ref()->set_object_id(
+      plasma_id.Binary());
+  ASSERT_TRUE(submitter.SubmitTask(task).ok());
+  ASSERT_EQ(raylet_client->arg_bytes_by_node_requested.size(), 2);
+  ASSERT_EQ(raylet_client->arg_bytes_by_node_requested[1],
+            (std::unordered_map<ClientID, int64_t>({{node_id, 1000}})));
+  ASSERT_EQ(looked_up, std::vector<std::vector<ObjectID>>({{plasma_id}}));
+}
+
 }  // namespace ray
 
 int main(int argc, char **argv) {
@@ -0,0 +1,142 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/core_worker/future_resolver.h"
+
+#include "gtest/gtest.h"
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+#include "ray/rpc/worker/core_worker_client.h"
+
+namespace ray {
+
+class MockOwnerClient : public rpc::CoreWorkerClientInterface {
+ public:
+  ray::Status GetObjectStatus(
+      const rpc::GetObjectStatusRequest &request,
+      const rpc::ClientCallback<rpc::GetObjectStatusReply> &callback) override {
+    callbacks.push_back(callback);
+    return Status::OK();
+  }
+
+  bool Reply(const rpc::GetObjectStatusReply &reply, Status status = Status::OK()) {
+    if (callbacks.empty()) {
+      return false;
+    }
+    auto callback = callbacks.front();
+    callbacks.pop_front();
+    callback(status, reply);
+    return true;
+  }
+
+  std::list<rpc::ClientCallback<rpc::GetObjectStatusReply>> callbacks;
+};
+
+class FutureResolverTest : public ::testing::Test {
+ public:
+  FutureResolverTest()
+      : store_(std::make_shared<CoreWorkerMemoryStore>()),
+        owner_client_(std::make_shared<MockOwnerClient>()),
+        resolver_(store_, [this](const rpc::Address &) { return owner_client_; },
+                  rpc::Address()) {
+    owner_address_.set_worker_id(WorkerID::FromRandom().Binary());
+  }
+
+  /// Return the value of an object in the memory store, or nullptr if the
+  /// future has not been resolved yet.
+  std::shared_ptr<RayObject> GetValue(const ObjectID &object_id) {
+    std::shared_ptr<RayObject> value;
+    store_->GetAsync(object_id,
+                     [&value](std::shared_ptr<RayObject> obj) { value = obj; });
+    return value;
+  }
+
+ protected:
+  std::shared_ptr<CoreWorkerMemoryStore> store_;
+  std::shared_ptr<MockOwnerClient> owner_client_;
+  FutureResolver resolver_;
+  rpc::Address owner_address_;
+};
+
+TEST_F(FutureResolverTest, TestInlinedReply) {
+  const ObjectID object_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  ASSERT_EQ(owner_client_->callbacks.size(), 1);
+
+  rpc::GetObjectStatusReply reply;
+  reply.set_status(rpc::GetObjectStatusReply::CREATED);
+  reply.set_inlined(true);
+  reply.set_data("data");
+  reply.set_metadata("meta");
+  ASSERT_TRUE(owner_client_->Reply(reply));
+
+  // The value is stored as is, so it is not fetched from plasma.
+  auto value = GetValue(object_id);
+  ASSERT_NE(value, nullptr);
+  ASSERT_FALSE(value->IsInPlasmaError());
+  ASSERT_EQ(std::string(reinterpret_cast<const char *>(value->GetData()->Data()),
+                        value->GetData()->Size()),
+            "data");
+  ASSERT_EQ(std::string(reinterpret_cast<const char *>(value->GetMetadata()->Data()),
+                        value->GetMetadata()->Size()),
+            "meta");
+}
+
+TEST_F(FutureResolverTest, TestInlinedReplyWithoutData) {
+  const ObjectID object_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  rpc::GetObjectStatusReply reply;
+  reply.set_inlined(true);
+  reply.set_metadata("meta");
+  ASSERT_TRUE(owner_client_->Reply(reply));
+
+  auto value = GetValue(object_id);
+  ASSERT_NE(value, nullptr);
+  ASSERT_FALSE(value->IsInPlasmaError());
+  ASSERT_FALSE(value->HasData());
+  ASSERT_TRUE(value->HasMetadata());
+}
+
+TEST_F(FutureResolverTest, TestReplyWithoutValue) {
+  const ObjectID object_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  ASSERT_EQ(GetValue(object_id), nullptr);
+  ASSERT_TRUE(owner_client_->Reply(rpc::GetObjectStatusReply()));
+
+  // Without a value, the object is fetched from plasma.
+  auto value = GetValue(object_id);
+  ASSERT_NE(value, nullptr);
+  ASSERT_TRUE(value->IsInPlasmaError());
+}
+
+TEST_F(FutureResolverTest, TestOwnerFailed) {
+  const ObjectID object_id = ObjectID::FromRandom();
+  resolver_.ResolveFutureAsync(object_id, owner_address_);
+  rpc::GetObjectStatusReply reply;
+  reply.set_inlined(true);
+  reply.set_data("data");
+  ASSERT_TRUE(owner_client_->Reply(reply, Status::IOError("")));
+
+  auto value = GetValue(object_id);
+  ASSERT_NE(value, nullptr);
+  rpc::ErrorType error_type;
+  ASSERT_TRUE(value->IsException(&error_type));
+  ASSERT_EQ(error_type, rpc::ErrorType::OBJECT_UNRECONSTRUCTABLE);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,106 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the throughput of the in-memory object store as the number of threads
+// using it grows, the way the threads of a threaded actor would. Each thread puts,
+// gets and deletes its own objects, and reads objects that all threads share. The
+// store options in ray_config_def.h can be given on the command line, e.g.
+//
+//   memory_store_benchmark 16
+//   memory_store_benchmark 16 memory_store_num_shards=1
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ray/common/ray_config.h"
+#include "ray/common/test_util.h"
+#include "ray/core_worker/store_provider/memory_store/memory_store.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace ray {
+
+/// Run the workload on the given number of threads and return the number of store
+/// operations per second.
+double RunBenchmark(int num_threads) {
+  const int num_iterations = 20000;
+  const int num_shared_objects = 64;
+  CoreWorkerMemoryStore store;
+  WorkerContext ctx(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil());
+  auto data = GenerateRandomObject();
+  std::vector<ObjectID> shared_ids;
+  for (int i = 0; i < num_shared_objects; i++) {
+    shared_ids.push_back(ObjectID::FromRandom());
+    store.Put(*data, shared_ids.back());
+  }
+
+  std::vector<std::vector<ObjectID>> object_ids(num_threads);
+  for (auto &ids : object_ids) {
+    for (int i = 0; i < num_iterations; i++) {
+      ids.push_back(ObjectID::FromRandom());
+    }
+  }
+
+  auto start = Clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<std::shared_ptr<RayObject>> results;
+      bool in_plasma = false;
+      for (int i = 0; i < num_iterations; i++) {
+        const auto &object_id = object_ids[t][i];
+        store.Put(*data, object_id);
+        RAY_CHECK_OK(store.Get({object_id}, 1, -1, ctx, false, &results));
+        RAY_CHECK(store.Contains(shared_ids[i % num_shared_objects], &in_plasma));
+        RAY_CHECK_OK(store.Get({shared_ids[(i + t) % num_shared_objects]}, 1, -1, ctx,
+                               false, &results));
+        store.Delete(std::vector<ObjectID>{object_id});
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  // Each iteration does a put, two gets, a contains and a delete.
+  return 5.0 * num_iterations * num_threads / seconds;
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <max threads> [<config>=<value> ...]"
+              << std::endl;
+    return 1;
+  }
+  const int max_threads = std::stoi(argv[1]);
+  std::unordered_map<std::string, std::string> config;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    auto pos = arg.find('=');
+    config[arg.substr(0, pos)] = pos == std::string::npos ? "1" : arg.substr(pos + 1);
+  }
+  RayConfig::instance().initialize(config);
+
+  for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2) {
+    std::cout << num_threads << " threads: " << ray::RunBenchmark(num_threads) / 1e6
+              << " M ops/s" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,94 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how much memory the reference counter uses for each object that a
+// worker tracks, for objects that the worker owns (e.g. the results of ray.put
+// and of submitted tasks) and for objects that it borrows from other workers, e.g.
+//
+//   reference_count_benchmark 1000000
+
+#include <malloc.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ray/core_worker/reference_count.h"
+
+namespace ray {
+
+rpc::Address RandomAddress() {
+  rpc::Address address;
+  address.set_raylet_id(ClientID::FromRandom().Binary());
+  address.set_ip_address("10.0.0.1");
+  address.set_port(12345);
+  address.set_worker_id(WorkerID::FromRandom().Binary());
+  return address;
+}
+
+/// The number of bytes allocated on the heap, including large allocations that
+/// were mapped separately.
+size_t AllocatedBytes() {
+  const auto info = mallinfo();
+  return static_cast<size_t>(info.uordblks) + static_cast<size_t>(info.hblkhd);
+}
+
+/// Track the given number of objects and return the number of bytes allocated
+/// for each of them.
+double BytesPerObject(int num_objects, bool owned) {
+  const auto address = RandomAddress();
+  // Borrowed objects are owned by a handful of other workers.
+  std::vector<rpc::Address> owners;
+  for (int i = 0; i < 8; i++) {
+    owners.push_back(RandomAddress());
+  }
+  const std::string call_site = "(task call) /home/ray/app/driver.py:main:42";
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < num_objects; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+  }
+
+  const size_t start = AllocatedBytes();
+  {
+    ReferenceCounter rc{rpc::WorkerAddress(address)};
+    for (int i = 0; i < num_objects; i++) {
+      const auto &object_id = object_ids[i];
+      if (owned) {
+        rc.AddOwnedObject(object_id, {}, address, call_site, 100,
+                          /*is_reconstructable=*/true);
+        rc.AddLocalReference(object_id, call_site);
+      } else {
+        rc.AddLocalReference(object_id, call_site);
+        rc.AddBorrowedObject(object_id, ObjectID::Nil(), owners[i % owners.size()]);
+      }
+    }
+    const size_t end = AllocatedBytes();
+    return static_cast<double>(end - start) / num_objects;
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <number of objects>" << std::endl;
+    return 1;
+  }
+  const int num_objects = std::stoi(argv[1]);
+  std::cout << "owned objects: " << ray::BytesPerObject(num_objects, true)
+            << " bytes per object" << std::endl;
+  std::cout << "borrowed objects: " << ray::BytesPerObject(num_objects, false)
+            << " bytes per object" << std::endl;
+  return 0;
+}
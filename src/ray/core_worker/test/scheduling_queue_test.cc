@@ -31,6 +31,8 @@ class MockWaiter : public DependencyWaiter {
 
   void Complete(int index) { callbacks_[index](); }
 
+  size_t NumWaits() const { return callbacks_.size(); }
+
  private:
   std::vector<std::function<void()>> callbacks_;
 };
@@ -100,6 +102,56 @@ TEST(SchedulingQueueTest, TestWaitForObjectsNotSubjectToSeqTimeout) {
   ASSERT_EQ(n_ok, 2);
 }
 
+TEST(SchedulingQueueTest, TestInOrderBehindWaitingRequest) {
+  ObjectID obj1 = ObjectID::FromRandom();
+  boost::asio::io_service io_service;
+  MockWaiter waiter;
+  WorkerContext context(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil());
+  SchedulingQueue queue(io_service, waiter, context);
+  std::vector<int> accepted;
+  auto fn_rej = []() {};
+  queue.Add(0, -1, [&accepted]() { accepted.push_back(0); }, fn_rej);
+  queue.Add(1, -1, [&accepted]() { accepted.push_back(1); }, fn_rej,
+            ObjectIdsToRefs({obj1}));
+  // This request arrives in order, but must wait for the one ahead of it.
+  queue.Add(2, -1, [&accepted]() { accepted.push_back(2); }, fn_rej);
+  ASSERT_EQ(accepted, std::vector<int>({0}));
+  waiter.Complete(0);
+  ASSERT_EQ(accepted, std::vector<int>({0, 1, 2}));
+  queue.Add(3, -1, [&accepted]() { accepted.push_back(3); }, fn_rej);
+  ASSERT_EQ(accepted, std::vector<int>({0, 1, 2, 3}));
+}
+
+TEST(SchedulingQueueTest, TestPrefetchDepth) {
+  boost::asio::io_service io_service;
+  MockWaiter waiter;
+  WorkerContext context(WorkerType::WORKER, WorkerID::FromRandom(), JobID::Nil());
+  SchedulingQueue queue(io_service, waiter, context, /*prefetch_depth=*/2);
+  int n_ok = 0;
+  int n_rej = 0;
+  auto fn_ok = [&n_ok]() { n_ok++; };
+  auto fn_rej = [&n_rej]() { n_rej++; };
+  for (int i = 0; i < 4; i++) {
+    queue.Add(i, -1, fn_ok, fn_rej, ObjectIdsToRefs({ObjectID::FromRandom()}));
+  }
+  // Only the first two requests' dependencies are fetched.
+  ASSERT_EQ(waiter.NumWaits(), 2);
+
+  // A later request's dependencies may be fetched first.
+  waiter.Complete(1);
+  ASSERT_EQ(n_ok, 0);
+  ASSERT_EQ(waiter.NumWaits(), 2);
+  // Once the first request runs, the next request's dependencies are fetched.
+  waiter.Complete(0);
+  ASSERT_EQ(n_ok, 2);
+  ASSERT_EQ(waiter.NumWaits(), 4);
+  waiter.Complete(3);
+  ASSERT_EQ(n_ok, 2);
+  waiter.Complete(2);
+  ASSERT_EQ(n_ok, 4);
+  ASSERT_EQ(n_rej, 0);
+}
+
 TEST(SchedulingQueueTest, TestOutOfOrder) {
   boost::asio::io_service io_service;
   MockWaiter waiter;
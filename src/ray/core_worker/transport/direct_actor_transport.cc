@@ -14,6 +14,7 @@
 
 #include "ray/core_worker/transport/direct_actor_transport.h"
 
+#include <chrono>
 #include <thread>
 
 #include "ray/common/task/task.h"
@@ -332,7 +333,9 @@ void CoreWorkerDirectTaskReceiver::HandlePushTask(
     }
   }
 
-  auto accept_callback = [this, reply, send_reply_callback, task_spec, resource_ids]() {
+  const auto receive_time = std::chrono::steady_clock::now();
+  auto accept_callback = [this, reply, send_reply_callback, task_spec, resource_ids,
+                          receive_time]() {
     auto num_returns = task_spec.NumReturns();
     if (task_spec.IsActorCreationTask() || task_spec.IsActorTask()) {
       // Decrease to account for the dummy object id.
@@ -341,8 +344,10 @@ void CoreWorkerDirectTaskReceiver::HandlePushTask(
     RAY_CHECK(num_returns >= 0);
 
     std::vector<std::shared_ptr<RayObject>> return_objects;
+    const auto start_time = std::chrono::steady_clock::now();
     auto status = task_handler_(task_spec, resource_ids, &return_objects,
                                 reply->mutable_borrowed_refs());
+    const auto end_time = std::chrono::steady_clock::now();
 
     bool objects_valid = return_objects.size() == num_returns;
     if (objects_valid) {
@@ -378,6 +383,14 @@ void CoreWorkerDirectTaskReceiver::HandlePushTask(
         RAY_CHECK_OK(task_done_());
       }
     }
+    // Report how long the task took, so that the owner can decide how many tasks
+    // to pipeline to this worker.
+    reply->set_execution_time_us(
+        std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time)
+            .count());
+    reply->set_handling_time_us(std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::steady_clock::now() - receive_time)
+                                    .count());
     if (status.IsSystemExit()) {
       // Don't allow the worker to be reused, even though the reply status is OK.
       // The worker will be shutting down shortly.
@@ -409,7 +422,8 @@ void CoreWorkerDirectTaskReceiver::HandlePushTask(
   if (it == scheduling_queue_.end()) {
     auto result = scheduling_queue_.emplace(
         task_spec.CallerWorkerId(),
-        SchedulingQueue(task_main_io_service_, *waiter_, worker_context_));
+        SchedulingQueue(task_main_io_service_, *waiter_, worker_context_,
+                        RayConfig::instance().actor_task_args_prefetch_depth()));
     it = result.first;
   }
   auto dependencies = task_spec.GetDependencies();
@@ -419,7 +433,7 @@ void CoreWorkerDirectTaskReceiver::HandlePushTask(
     dependencies.pop_back();
   }
   it->second.Add(request.sequence_number(), request.client_processed_up_to(),
-                 accept_callback, reject_callback, dependencies);
+                 std::move(accept_callback), std::move(reject_callback), dependencies);
 }
 
 }  // namespace ray
@@ -239,19 +239,30 @@ class InboundRequest {
  public:
   InboundRequest(){};
   InboundRequest(std::function<void()> accept_callback,
-                 std::function<void()> reject_callback, bool has_dependencies)
-      : accept_callback_(accept_callback),
-        reject_callback_(reject_callback),
-        has_pending_dependencies_(has_dependencies) {}
+                 std::function<void()> reject_callback,
+                 std::vector<rpc::ObjectReference> dependencies)
+      : accept_callback_(std::move(accept_callback)),
+        reject_callback_(std::move(reject_callback)),
+        dependencies_(std::move(dependencies)),
+        has_pending_dependencies_(!dependencies_.empty()) {}
 
   void Accept() { accept_callback_(); }
   void Cancel() { reject_callback_(); }
+  /// Move the accept callback out of the request, to hand it off to the thread
+  /// that runs it without copying it.
+  std::function<void()> TakeAcceptCallback() { return std::move(accept_callback_); }
   bool CanExecute() const { return !has_pending_dependencies_; }
   void MarkDependenciesSatisfied() { has_pending_dependencies_ = false; }
+  /// Move the dependencies that we have not started waiting for yet out of
+  /// the request. This is empty once we have started waiting for them.
+  std::vector<rpc::ObjectReference> TakeDependencies() {
+    return std::move(dependencies_);
+  }
 
  private:
   std::function<void()> accept_callback_;
   std::function<void()> reject_callback_;
+  std::vector<rpc::ObjectReference> dependencies_;
   bool has_pending_dependencies_;
 };
 
@@ -303,7 +314,7 @@ class BoundedExecutor {
     mu_.LockWhen(absl::Condition(this, &BoundedExecutor::ThreadsAvailable));
     num_running_ += 1;
     mu_.Unlock();
-    boost::asio::post(pool_, [this, fn]() {
+    boost::asio::post(pool_, [this, fn = std::move(fn)]() {
       fn();
       absl::MutexLock lock(&mu_);
       num_running_ -= 1;
@@ -329,10 +340,14 @@ class BoundedExecutor {
 /// See direct_actor.proto for a description of the ordering protocol.
 class SchedulingQueue {
  public:
+  /// \param prefetch_depth The number of queued requests to fetch the
+  /// dependencies of ahead of time. If 0, the dependencies of all queued
+  /// requests are fetched as soon as the requests arrive.
   SchedulingQueue(boost::asio::io_service &main_io_service, DependencyWaiter &waiter,
-                  WorkerContext &worker_context,
+                  WorkerContext &worker_context, int64_t prefetch_depth = 0,
                   int64_t reorder_wait_seconds = kMaxReorderWaitSeconds)
       : worker_context_(worker_context),
+        prefetch_depth_(prefetch_depth),
         reorder_wait_seconds_(reorder_wait_seconds),
         wait_timer_(main_io_service),
         main_thread_id_(boost::this_thread::get_id()),
@@ -351,25 +366,44 @@ class SchedulingQueue {
                      << client_processed_up_to;
       next_seq_no_ = client_processed_up_to + 1;
     }
+    // Most requests arrive in order and without dependencies. If nothing is
+    // queued ahead of the request, run it right away instead of queueing it.
+    if (seq_no == next_seq_no_ && dependencies.empty() && pending_tasks_.empty()) {
+      RAY_LOG(DEBUG) << "Dispatch " << seq_no << " without queueing";
+      next_seq_no_++;
+      Dispatch(std::move(accept_request));
+      return;
+    }
     RAY_LOG(DEBUG) << "Enqueue " << seq_no << " cur seqno " << next_seq_no_;
-    pending_tasks_[seq_no] =
-        InboundRequest(accept_request, reject_request, dependencies.size() > 0);
-    if (dependencies.size() > 0) {
-      waiter_.Wait(dependencies, [seq_no, this]() {
-        RAY_CHECK(boost::this_thread::get_id() == main_thread_id_);
-        auto it = pending_tasks_.find(seq_no);
-        if (it != pending_tasks_.end()) {
-          it->second.MarkDependenciesSatisfied();
-          ScheduleRequests();
-        }
-      });
+    auto &request = pending_tasks_[seq_no] =
+        InboundRequest(std::move(accept_request), std::move(reject_request), dependencies);
+    if (prefetch_depth_ <= 0) {
+      WaitForDependencies(seq_no, request.TakeDependencies());
+    } else {
+      FetchDependencies();
     }
     ScheduleRequests();
   }
 
  private:
-  /// Schedules as many requests as possible in sequence.
-  void ScheduleRequests() {
+  /// Run an accepted request on the thread that the actor executes tasks on.
+  void Dispatch(std::function<void()> accept_request) {
+    InitExecutor();
+    if (is_asyncio_) {
+      // Process async actor task.
+      fiber_state_->EnqueueFiber(std::move(accept_request));
+    } else if (pool_) {
+      // Process concurrent actor task.
+      pool_->PostBlocking(std::move(accept_request));
+    } else {
+      // Process normal actor task.
+      accept_request();
+    }
+  }
+
+  /// Set up the fiber state or the thread pool that executes requests, if
+  /// the actor needs one.
+  void InitExecutor() {
     // Only call SetMaxActorConcurrency to configure threadpool size when the
     // actor is not async actor. Async actor is single threaded.
     int max_concurrency = worker_context_.CurrentActorMaxConcurrency();
@@ -387,7 +421,45 @@ class SchedulingQueue {
         pool_.reset(new BoundedExecutor(max_concurrency));
       }
     }
+  }
+
+  /// Wait for the dependencies of a queued request to be fetched.
+  void WaitForDependencies(int64_t seq_no,
+                           const std::vector<rpc::ObjectReference> &dependencies) {
+    if (dependencies.empty()) {
+      return;
+    }
+    waiter_.Wait(dependencies, [seq_no, this]() {
+      RAY_CHECK(boost::this_thread::get_id() == main_thread_id_);
+      auto it = pending_tasks_.find(seq_no);
+      if (it != pending_tasks_.end()) {
+        it->second.MarkDependenciesSatisfied();
+        ScheduleRequests();
+      }
+    });
+  }
+
+  /// Start fetching the dependencies of the first prefetch_depth_ queued
+  /// requests, so that the arguments of a request are local by the time the
+  /// requests ahead of it have executed.
+  void FetchDependencies() {
+    std::vector<std::pair<int64_t, std::vector<rpc::ObjectReference>>> to_fetch;
+    int64_t num_requests = 0;
+    for (auto it = pending_tasks_.begin();
+         it != pending_tasks_.end() && num_requests < prefetch_depth_;
+         it++, num_requests++) {
+      auto dependencies = it->second.TakeDependencies();
+      if (!dependencies.empty()) {
+        to_fetch.emplace_back(it->first, std::move(dependencies));
+      }
+    }
+    for (const auto &request : to_fetch) {
+      WaitForDependencies(request.first, request.second);
+    }
+  }
 
+  /// Schedules as many requests as possible in sequence.
+  void ScheduleRequests() {
     // Cancel any stale requests that the client doesn't need any longer.
     while (!pending_tasks_.empty() && pending_tasks_.begin()->first < next_seq_no_) {
       auto head = pending_tasks_.begin();
@@ -401,20 +473,15 @@ class SchedulingQueue {
     while (!pending_tasks_.empty() && pending_tasks_.begin()->first == next_seq_no_ &&
            pending_tasks_.begin()->second.CanExecute()) {
       auto head = pending_tasks_.begin();
-      auto request = head->second;
-
-      if (is_asyncio_) {
-        // Process async actor task.
-        fiber_state_->EnqueueFiber([request]() mutable { request.Accept(); });
-      } else if (pool_) {
-        // Process concurrent actor task.
-        pool_->PostBlocking([request]() mutable { request.Accept(); });
-      } else {
-        // Process normal actor task.
-        request.Accept();
-      }
+      auto accept_request = head->second.TakeAcceptCallback();
       pending_tasks_.erase(head);
       next_seq_no_++;
+      Dispatch(std::move(accept_request));
+    }
+
+    if (prefetch_depth_ > 0) {
+      // The requests that were dispatched made room for more requests to fetch.
+      FetchDependencies();
     }
 
     if (pending_tasks_.empty() || !pending_tasks_.begin()->second.CanExecute()) {
@@ -449,6 +516,8 @@ class SchedulingQueue {
 
   // Worker context.
   WorkerContext &worker_context_;
+  /// The number of queued requests to fetch the dependencies of ahead of time.
+  const int64_t prefetch_depth_;
   /// Max time in seconds to wait for dependencies to show up.
   const int64_t reorder_wait_seconds_ = 0;
   /// Sorted map of (accept, rej) task callbacks keyed by their sequence number.
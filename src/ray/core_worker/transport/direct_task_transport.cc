@@ -14,6 +14,9 @@
 
 #include "ray/core_worker/transport/direct_task_transport.h"
 
+#include <chrono>
+#include <cmath>
+
 #include "ray/core_worker/transport/dependency_resolver.h"
 
 namespace ray {
@@ -134,7 +137,7 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
     auto &client = *client_cache_[addr];
 
     while (!queue_entry->second.empty() &&
-           lease_entry.tasks_in_flight_ < max_tasks_in_flight_per_worker_) {
+           lease_entry.tasks_in_flight_ < MaxTasksInFlight(scheduling_key)) {
       auto task_spec = queue_entry->second.front();
       lease_entry
           .tasks_in_flight_++;  // Increment the number of tasks in flight to the worker
@@ -154,8 +157,67 @@ void CoreWorkerDirectTaskSubmitter::OnWorkerIdle(
   RequestNewWorkerIfNeeded(scheduling_key);
 }
 
+uint32_t CoreWorkerDirectTaskSubmitter::MaxTasksInFlight(
+    const SchedulingKey &scheduling_key) const {
+  if (max_adaptive_tasks_in_flight_per_worker_ == 0) {
+    return max_tasks_in_flight_per_worker_;
+  }
+  auto it = task_timings_.find(std::get<0>(scheduling_key));
+  const int64_t max_task_duration_us =
+      RayConfig::instance().adaptive_pipelining_max_task_duration_us();
+  if (it == task_timings_.end() || it->second.execution_time_us >= max_task_duration_us) {
+    // Send one task at a time until we know how long the tasks take, and never
+    // queue tasks behind long-running ones.
+    return 1;
+  }
+  // While one task executes, the worker should already have the next tasks that
+  // will be needed to cover the round trip to the owner.
+  const auto &timing = it->second;
+  const double depth =
+      1 + std::ceil(timing.rpc_latency_us / std::max(timing.execution_time_us, 1.0));
+  return static_cast<uint32_t>(
+      std::min(depth, static_cast<double>(max_adaptive_tasks_in_flight_per_worker_)));
+}
+
+void CoreWorkerDirectTaskSubmitter::RecordTaskTiming(
+    const SchedulingKey &scheduling_key, int64_t round_trip_time_us,
+    const rpc::PushTaskReply &reply) {
+  if (max_adaptive_tasks_in_flight_per_worker_ == 0) {
+    return;
+  }
+  // Weight recent tasks more, so that the depth follows changes in the workload.
+  const double alpha = 0.2;
+  const double rpc_latency_us =
+      std::max<int64_t>(round_trip_time_us - reply.handling_time_us(), 0);
+  auto &timing = task_timings_[std::get<0>(scheduling_key)];
+  if (timing.num_samples == 0) {
+    timing.execution_time_us = reply.execution_time_us();
+    timing.rpc_latency_us = rpc_latency_us;
+  } else {
+    timing.execution_time_us =
+        (1 - alpha) * timing.execution_time_us + alpha * reply.execution_time_us();
+    timing.rpc_latency_us = (1 - alpha) * timing.rpc_latency_us + alpha * rpc_latency_us;
+  }
+  timing.num_samples++;
+}
+
 void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
     const SchedulingKey &scheduling_key) {
+  auto it = pending_lease_requests_.find(scheduling_key);
+  if (it == pending_lease_requests_.end()) {
+    return;
+  }
+  std::vector<TaskID> lease_ids;
+  for (const auto &pending_lease_request : it->second) {
+    lease_ids.push_back(pending_lease_request.first);
+  }
+  for (const auto &lease_id : lease_ids) {
+    CancelWorkerLease(scheduling_key, lease_id);
+  }
+}
+
+void CoreWorkerDirectTaskSubmitter::CancelWorkerLease(const SchedulingKey &scheduling_key,
+                                                      const TaskID &lease_id) {
   auto queue_entry = task_queues_.find(scheduling_key);
   if (queue_entry != task_queues_.end()) {
     // There are still pending tasks, so let the worker lease request succeed.
@@ -163,14 +225,17 @@ void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
   }
 
   auto it = pending_lease_requests_.find(scheduling_key);
-  if (it != pending_lease_requests_.end()) {
+  if (it == pending_lease_requests_.end()) {
+    return;
+  }
+  auto lease_it = it->second.find(lease_id);
+  if (lease_it != it->second.end()) {
     // There is an in-flight lease request. Cancel it.
-    auto &lease_client = it->second.first;
-    auto &lease_id = it->second.second;
+    auto &lease_client = lease_it->second;
     RAY_LOG(DEBUG) << "Canceling lease request " << lease_id;
     RAY_UNUSED(lease_client->CancelWorkerLease(
-        lease_id, [this, scheduling_key](const Status &status,
-                                         const rpc::CancelWorkerLeaseReply &reply) {
+        lease_id, [this, scheduling_key, lease_id](
+                      const Status &status, const rpc::CancelWorkerLeaseReply &reply) {
           absl::MutexLock lock(&mu_);
           if (status.ok() && !reply.success()) {
             // The cancellation request can fail if the raylet does not have
@@ -181,7 +246,7 @@ void CoreWorkerDirectTaskSubmitter::CancelWorkerLeaseIfNeeded(
             // request again. In the latter case, the in-flight lease request
             // should already have been removed from our local state, so we no
             // longer need to cancel.
-            CancelWorkerLeaseIfNeeded(scheduling_key);
+            CancelWorkerLease(scheduling_key, lease_id);
           }
         }));
   }
@@ -213,68 +278,104 @@ CoreWorkerDirectTaskSubmitter::GetOrConnectLeaseClient(
 
 void CoreWorkerDirectTaskSubmitter::RequestNewWorkerIfNeeded(
     const SchedulingKey &scheduling_key, const rpc::Address *raylet_address) {
-  if (pending_lease_requests_.find(scheduling_key) != pending_lease_requests_.end()) {
-    // There's already an outstanding lease request for this type of task.
-    return;
-  }
   auto it = task_queues_.find(scheduling_key);
   if (it == task_queues_.end()) {
     // We don't have any of this type of task to run.
     return;
   }
+  auto &task_queue = it->second;
+  auto pending_it = pending_lease_requests_.find(scheduling_key);
+  size_t num_pending =
+      pending_it == pending_lease_requests_.end() ? 0 : pending_it->second.size();
+  // Keep one lease request in flight for each queued task, so that a large batch of
+  // tasks ramps up without waiting for one lease round trip per worker.
+  const size_t max_pending = std::min(
+      task_queue.size(),
+      static_cast<size_t>(std::max<int64_t>(
+          max_pending_lease_requests_per_scheduling_class_, 1)));
+  // The plasma dependencies are part of the scheduling key, so every task in the
+  // queue has its arguments in the same places.
+  std::unordered_map<ClientID, int64_t> arg_bytes_by_node;
+  const auto &dependency_ids = std::get<1>(scheduling_key);
+  if (get_arg_bytes_by_node_ && num_pending < max_pending && !dependency_ids.empty()) {
+    arg_bytes_by_node = get_arg_bytes_by_node_(dependency_ids);
+  }
+  while (num_pending < max_pending) {
+    // Each request is sent with the spec of a different queued task, since the
+    // raylet identifies lease requests by task ID.
+    const TaskSpecification *resource_spec = nullptr;
+    for (const auto &task_spec : task_queue) {
+      if (pending_it == pending_lease_requests_.end() ||
+          !pending_it->second.contains(task_spec.TaskId())) {
+        resource_spec = &task_spec;
+        break;
+      }
+    }
+    if (resource_spec == nullptr) {
+      break;
+    }
 
-  auto lease_client = GetOrConnectLeaseClient(raylet_address);
-  TaskSpecification &resource_spec = it->second.front();
-  TaskID task_id = resource_spec.TaskId();
-  RAY_LOG(DEBUG) << "Lease requested " << task_id;
-  RAY_UNUSED(lease_client->RequestWorkerLease(
-      resource_spec, [this, scheduling_key](const Status &status,
-                                            const rpc::RequestWorkerLeaseReply &reply) {
-        absl::MutexLock lock(&mu_);
+    auto lease_client = GetOrConnectLeaseClient(raylet_address);
+    // Only the first request goes to the raylet that we were redirected to.
+    raylet_address = nullptr;
+    TaskID task_id = resource_spec->TaskId();
+    RAY_LOG(DEBUG) << "Lease requested " << task_id;
+    RAY_UNUSED(lease_client->RequestWorkerLease(
+        *resource_spec,
+        [this, scheduling_key, task_id](const Status &status,
+                                        const rpc::RequestWorkerLeaseReply &reply) {
+          absl::MutexLock lock(&mu_);
 
-        auto it = pending_lease_requests_.find(scheduling_key);
-        RAY_CHECK(it != pending_lease_requests_.end());
-        auto lease_client = std::move(it->second.first);
-        const auto task_id = it->second.second;
-        pending_lease_requests_.erase(it);
+          auto it = pending_lease_requests_.find(scheduling_key);
+          RAY_CHECK(it != pending_lease_requests_.end());
+          auto lease_it = it->second.find(task_id);
+          RAY_CHECK(lease_it != it->second.end());
+          auto lease_client = std::move(lease_it->second);
+          it->second.erase(lease_it);
+          if (it->second.empty()) {
+            pending_lease_requests_.erase(it);
+          }
 
-        if (status.ok()) {
-          if (reply.canceled()) {
-            RAY_LOG(DEBUG) << "Lease canceled " << task_id;
+          if (status.ok()) {
+            if (reply.canceled()) {
+              RAY_LOG(DEBUG) << "Lease canceled " << task_id;
+              RequestNewWorkerIfNeeded(scheduling_key);
+            } else if (!reply.worker_address().raylet_id().empty()) {
+              // We got a lease for a worker. Add the lease client state and try to
+              // assign work to the worker.
+              RAY_LOG(DEBUG) << "Lease granted " << task_id;
+              rpc::WorkerAddress addr(reply.worker_address());
+              AddWorkerLeaseClient(addr, std::move(lease_client));
+              auto resources_copy = reply.resource_mapping();
+              OnWorkerIdle(addr, scheduling_key,
+                           /*error=*/false, resources_copy);
+            } else {
+              // The raylet redirected us to a different raylet to retry at.
+              RequestNewWorkerIfNeeded(scheduling_key, &reply.retry_at_raylet_address());
+            }
+          } else if (lease_client != local_lease_client_) {
+            // A lease request to a remote raylet failed. Retry locally if the lease is
+            // still needed.
+            // TODO(swang): Fail after some number of retries?
+            RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
+                           << status.ToString();
             RequestNewWorkerIfNeeded(scheduling_key);
-          } else if (!reply.worker_address().raylet_id().empty()) {
-            // We got a lease for a worker. Add the lease client state and try to
-            // assign work to the worker.
-            RAY_LOG(DEBUG) << "Lease granted " << task_id;
-            rpc::WorkerAddress addr(reply.worker_address());
-            AddWorkerLeaseClient(addr, std::move(lease_client));
-            auto resources_copy = reply.resource_mapping();
-            OnWorkerIdle(addr, scheduling_key,
-                         /*error=*/false, resources_copy);
           } else {
-            // The raylet redirected us to a different raylet to retry at.
-            RequestNewWorkerIfNeeded(scheduling_key, &reply.retry_at_raylet_address());
+            // A local request failed. This shouldn't happen if the raylet is still
+            // alive and we don't currently handle raylet failures, so treat it as a
+            // fatal error.
+            RAY_LOG(ERROR) << "The worker failed to receive a response from the local "
+                              "raylet. This is most "
+                              "likely because the local raylet has crahsed.";
+            RAY_LOG(FATAL) << status.ToString();
           }
-        } else if (lease_client != local_lease_client_) {
-          // A lease request to a remote raylet failed. Retry locally if the lease is
-          // still needed.
-          // TODO(swang): Fail after some number of retries?
-          RAY_LOG(ERROR) << "Retrying attempt to schedule task at remote node. Error: "
-                         << status.ToString();
-          RequestNewWorkerIfNeeded(scheduling_key);
-        } else {
-          // A local request failed. This shouldn't happen if the raylet is still alive
-          // and we don't currently handle raylet failures, so treat it as a fatal
-          // error.
-          RAY_LOG(ERROR) << "The worker failed to receive a response from the local "
-                            "raylet. This is most "
-                            "likely because the local raylet has crahsed.";
-          RAY_LOG(FATAL) << status.ToString();
-        }
-      }));
-  RAY_CHECK(pending_lease_requests_
-                .emplace(scheduling_key, std::make_pair(lease_client, task_id))
-                .second);
+        },
+        task_queue.size(), arg_bytes_by_node));
+    RAY_CHECK(
+        pending_lease_requests_[scheduling_key].emplace(task_id, lease_client).second);
+    pending_it = pending_lease_requests_.find(scheduling_key);
+    num_pending++;
+  }
 }
 
 void CoreWorkerDirectTaskSubmitter::PushNormalTask(
@@ -293,13 +394,21 @@ void CoreWorkerDirectTaskSubmitter::PushNormalTask(
   request->mutable_task_spec()->CopyFrom(task_spec.GetMessage());
   request->mutable_resource_mapping()->CopyFrom(assigned_resources);
   request->set_intended_worker_id(addr.worker_id.Binary());
+  const auto push_time = std::chrono::steady_clock::now();
   RAY_UNUSED(client.PushNormalTask(
       std::move(request),
       [this, task_id, is_actor, is_actor_creation, scheduling_key, addr,
-       assigned_resources](Status status, const rpc::PushTaskReply &reply) {
+       assigned_resources, push_time](Status status, const rpc::PushTaskReply &reply) {
         {
           absl::MutexLock lock(&mu_);
           executing_tasks_.erase(task_id);
+          if (status.ok()) {
+            RecordTaskTiming(scheduling_key,
+                             std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now() - push_time)
+                                 .count(),
+                             reply);
+          }
 
           // Decrement the number of tasks in flight to the worker
           auto &lease_entry = worker_to_lease_entry_[addr];
@@ -35,6 +35,12 @@ typedef std::function<std::shared_ptr<WorkerLeaseInterface>(const std::string &i
                                                             int port)>
     LeaseClientFactoryFn;
 
+// Returns the number of bytes of the given objects that are stored on each node, as
+// far as this worker knows.
+typedef std::function<std::unordered_map<ClientID, int64_t>(
+    const std::vector<ObjectID> &object_ids)>
+    ArgBytesByNodeFn;
+
 // The task queues are keyed on resource shape & function descriptor
 // (encapsulated in SchedulingClass) to defer resource allocation decisions to the raylet
 // and ensure fairness between different tasks, as well as plasma task dependencies as
@@ -58,7 +64,12 @@ class CoreWorkerDirectTaskSubmitter {
       uint32_t max_tasks_in_flight_per_worker =
           RayConfig::instance().max_tasks_in_flight_per_worker(),
       std::shared_ptr<ActorCreatorInterface> actor_creator = nullptr,
-      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt)
+      absl::optional<boost::asio::steady_timer> cancel_timer = absl::nullopt,
+      int64_t max_pending_lease_requests_per_scheduling_class =
+          RayConfig::instance().max_pending_lease_requests_per_scheduling_class(),
+      uint32_t max_adaptive_tasks_in_flight_per_worker =
+          RayConfig::instance().max_adaptive_tasks_in_flight_per_worker(),
+      ArgBytesByNodeFn get_arg_bytes_by_node = nullptr)
       : rpc_address_(rpc_address),
         local_lease_client_(lease_client),
         client_factory_(client_factory),
@@ -69,6 +80,10 @@ class CoreWorkerDirectTaskSubmitter {
         local_raylet_id_(local_raylet_id),
         actor_creator_(std::move(actor_creator)),
         max_tasks_in_flight_per_worker_(max_tasks_in_flight_per_worker),
+        max_pending_lease_requests_per_scheduling_class_(
+            max_pending_lease_requests_per_scheduling_class),
+        max_adaptive_tasks_in_flight_per_worker_(max_adaptive_tasks_in_flight_per_worker),
+        get_arg_bytes_by_node_(std::move(get_arg_bytes_by_node)),
         cancel_retry_timer_(std::move(cancel_timer)) {}
 
   /// Schedule a task for direct submission to a worker.
@@ -105,21 +120,39 @@ class CoreWorkerDirectTaskSubmitter {
   std::shared_ptr<WorkerLeaseInterface> GetOrConnectLeaseClient(
       const rpc::Address *raylet_address) EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  /// Request a new worker from the raylet if no such requests are currently in
-  /// flight and there are tasks queued. If a raylet address is provided, then
-  /// the worker should be requested from the raylet at that address. Else, the
-  /// worker should be requested from the local raylet.
+  /// Request new workers from the raylet until there is one request in flight for
+  /// each queued task, up to max_pending_lease_requests_per_scheduling_class_. If a
+  /// raylet address is provided, then the first worker should be requested from the
+  /// raylet at that address. Else, workers are requested from the local raylet.
   void RequestNewWorkerIfNeeded(const SchedulingKey &task_queue_key,
                                 const rpc::Address *raylet_address = nullptr)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
-  /// Cancel a pending worker lease and retry until the cancellation succeeds
-  /// (i.e., the raylet drops the request). This should be called when there
-  /// are no more tasks queued with the given scheduling key and there is an
-  /// in-flight lease request for that key.
+  /// Cancel the pending worker leases for a scheduling key. This should be called
+  /// when there are no more tasks queued with the given scheduling key.
   void CancelWorkerLeaseIfNeeded(const SchedulingKey &scheduling_key)
       EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  /// Cancel one pending worker lease and retry until the cancellation succeeds
+  /// (i.e., the raylet drops the request), unless tasks were queued with the
+  /// scheduling key in the meantime.
+  void CancelWorkerLease(const SchedulingKey &scheduling_key, const TaskID &lease_id)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// The number of tasks of a scheduling class that may be in flight to one leased
+  /// worker.
+  uint32_t MaxTasksInFlight(const SchedulingKey &scheduling_key) const
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Update the pipelining statistics of a scheduling class with a task that
+  /// finished.
+  ///
+  /// \param scheduling_key The scheduling key of the task.
+  /// \param round_trip_time_us The time from pushing the task to receiving the reply.
+  /// \param reply The worker's reply.
+  void RecordTaskTiming(const SchedulingKey &scheduling_key, int64_t round_trip_time_us,
+                        const rpc::PushTaskReply &reply) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   /// Set up client state for newly granted worker lease.
   void AddWorkerLeaseClient(const rpc::WorkerAddress &addr,
                             std::shared_ptr<WorkerLeaseInterface> lease_client)
@@ -177,6 +210,33 @@ class CoreWorkerDirectTaskSubmitter {
   // worker using a single lease.
   const uint32_t max_tasks_in_flight_per_worker_;
 
+  // The maximum number of worker lease requests in flight for each scheduling key.
+  const int64_t max_pending_lease_requests_per_scheduling_class_;
+
+  // If nonzero, the number of tasks in flight to each worker is adapted to the task
+  // durations of each scheduling class, up to this many tasks.
+  const uint32_t max_adaptive_tasks_in_flight_per_worker_;
+
+  // Looks up where the plasma arguments of a task are stored, so that the raylet can
+  // place the task near its data. If null, no locations are sent with lease requests.
+  const ArgBytesByNodeFn get_arg_bytes_by_node_;
+
+  /// Moving averages of how long tasks of a scheduling class take, used to decide how
+  /// many tasks to pipeline to a worker. Pipelining enough tasks to cover the RPC
+  /// latency keeps the worker busy between replies.
+  struct TaskTiming {
+    /// How long a task takes to execute on the worker.
+    double execution_time_us = 0;
+    /// How long a push and its reply take on the wire, i.e. the round trip time
+    /// minus the time that the request spent on the worker.
+    double rpc_latency_us = 0;
+    /// The number of tasks that the averages are based on.
+    int64_t num_samples = 0;
+  };
+
+  // Task timings for the adaptive pipelining mode, by scheduling class.
+  absl::flat_hash_map<SchedulingClass, TaskTiming> task_timings_ GUARDED_BY(mu_);
+
   /// A LeaseEntry struct is used to condense the metadata about a single executor:
   /// (1) The lease client through which the worker should be returned
   /// (2) The expiration time of a worker's lease.
@@ -197,9 +257,11 @@ class CoreWorkerDirectTaskSubmitter {
   absl::flat_hash_map<rpc::WorkerAddress, LeaseEntry> worker_to_lease_entry_
       GUARDED_BY(mu_);
 
-  // Keeps track of pending worker lease requests to the raylet.
+  // Keeps track of pending worker lease requests to the raylet, by the ID of the task
+  // whose spec was sent with the request.
+  // Invariant: if a scheduling key is in this map, it has at least one request.
   absl::flat_hash_map<SchedulingKey,
-                      std::pair<std::shared_ptr<WorkerLeaseInterface>, TaskID>>
+                      absl::flat_hash_map<TaskID, std::shared_ptr<WorkerLeaseInterface>>>
       pending_lease_requests_ GUARDED_BY(mu_);
 
   // Tasks that are queued for execution. We keep individual queues per
@@ -251,7 +251,8 @@ void GcsActorScheduler::LeaseWorkerFromNode(std::shared_ptr<GcsActor> actor,
             RetryLeasingWorkerFromNode(actor, node);
           }
         }
-      });
+      },
+      /*backlog_size=*/1, /*arg_bytes_by_node=*/{});
 
   if (!status.ok()) {
     RetryLeasingWorkerFromNode(actor, node);
@@ -70,7 +70,9 @@ struct GcsServerMocker {
 
     ray::Status RequestWorkerLease(
         const ray::TaskSpecification &resource_spec,
-        const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback) override {
+        const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
+        int64_t backlog_size,
+        const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) override {
       num_workers_requested += 1;
       callbacks.push_back(callback);
       return Status::OK();
@@ -0,0 +1,109 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_codec.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace ray {
+
+namespace {
+
+/// The number of bytes compressed by each sample of IsCompressible.
+constexpr uint64_t kSampleSize = 4096;
+/// The number of samples that IsCompressible takes from a chunk.
+constexpr uint64_t kNumSamples = 4;
+
+}  // namespace
+
+Status ParseCompressionCodec(const std::string &name, rpc::CompressionCodec *codec) {
+  if (name.empty() || name == "none") {
+    *codec = rpc::NO_COMPRESSION;
+  } else if (name == "zlib") {
+    *codec = rpc::ZLIB;
+  } else {
+    return Status::Invalid("Unknown compression codec " + name);
+  }
+  return Status::OK();
+}
+
+bool IsCompressible(const uint8_t *data, uint64_t size, double min_ratio) {
+  if (size == 0) {
+    return false;
+  }
+  const uint64_t sample_size = std::min(size, kSampleSize);
+  const uint64_t num_samples = std::min(kNumSamples, size / sample_size);
+  std::vector<Bytef> buffer(compressBound(sample_size));
+  uint64_t total_size = 0;
+  uint64_t total_compressed_size = 0;
+  for (uint64_t i = 0; i < num_samples; i++) {
+    // Spread the samples evenly, so that a chunk that starts with a
+    // compressible header is not mistaken for a compressible chunk.
+    const uint64_t offset =
+        num_samples == 1 ? 0 : i * (size - sample_size) / (num_samples - 1);
+    uLongf compressed_size = buffer.size();
+    if (compress2(buffer.data(), &compressed_size, data + offset, sample_size,
+                  Z_BEST_SPEED) != Z_OK) {
+      return false;
+    }
+    total_size += sample_size;
+    total_compressed_size += compressed_size;
+  }
+  return total_compressed_size < min_ratio * total_size;
+}
+
+Status CompressChunk(rpc::CompressionCodec codec, const uint8_t *data, uint64_t size,
+                     std::string *compressed) {
+  RAY_CHECK(codec == rpc::ZLIB) << "Unsupported compression codec " << codec;
+  uLongf compressed_size = compressBound(size);
+  compressed->resize(compressed_size);
+  int result = compress2(reinterpret_cast<Bytef *>(&(*compressed)[0]), &compressed_size,
+                         data, size, Z_BEST_SPEED);
+  if (result != Z_OK) {
+    return Status::IOError("Failed to compress chunk, zlib error " +
+                           std::to_string(result));
+  }
+  compressed->resize(compressed_size);
+  return Status::OK();
+}
+
+Status DecompressChunk(rpc::CompressionCodec codec, const std::string &compressed,
+                       uint8_t *data, uint64_t size) {
+  if (codec == rpc::NO_COMPRESSION) {
+    if (compressed.size() != size) {
+      return Status::IOError("Chunk has size " + std::to_string(compressed.size()) +
+                             ", expected " + std::to_string(size));
+    }
+    std::memcpy(data, compressed.data(), size);
+    return Status::OK();
+  }
+  if (codec != rpc::ZLIB) {
+    return Status::IOError("Unsupported compression codec " + std::to_string(codec));
+  }
+  uLongf decompressed_size = size;
+  int result =
+      uncompress(data, &decompressed_size,
+                 reinterpret_cast<const Bytef *>(compressed.data()), compressed.size());
+  if (result != Z_OK || decompressed_size != size) {
+    return Status::IOError("Failed to decompress chunk, zlib error " +
+                           std::to_string(result));
+  }
+  return Status::OK();
+}
+
+}  // namespace ray
@@ -0,0 +1,65 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "ray/common/status.h"
+#include "src/ray/protobuf/object_manager.pb.h"
+
+// Compression of object chunks sent between object managers.
+
+namespace ray {
+
+/// Parse the name of a compression codec.
+///
+/// \param name The codec name: "zlib", or "" or "none" for no compression.
+/// \param[out] codec The parsed codec.
+/// \return Status::Invalid if the name is unknown.
+Status ParseCompressionCodec(const std::string &name, rpc::CompressionCodec *codec);
+
+/// Estimate whether a chunk compresses well, by compressing a few samples
+/// spread across it. This costs a small fraction of compressing the chunk.
+///
+/// \param data The chunk data.
+/// \param size The size of the chunk.
+/// \param min_ratio The chunk is considered compressible if the compressed
+/// samples are smaller than this fraction of their original size.
+/// \return Whether the chunk is likely to compress to less than min_ratio.
+bool IsCompressible(const uint8_t *data, uint64_t size, double min_ratio);
+
+/// Compress a chunk.
+///
+/// \param codec The codec to use. Must not be NO_COMPRESSION.
+/// \param data The chunk data.
+/// \param size The size of the chunk.
+/// \param[out] compressed The compressed chunk.
+/// \return Status.
+Status CompressChunk(rpc::CompressionCodec codec, const uint8_t *data, uint64_t size,
+                     std::string *compressed);
+
+/// Decompress a chunk into its buffer.
+///
+/// \param codec The codec that the chunk was compressed with.
+/// \param compressed The compressed chunk.
+/// \param data The buffer to decompress the chunk into.
+/// \param size The size of the uncompressed chunk.
+/// \return Status::IOError if the chunk is corrupt or does not decompress to
+/// exactly size bytes.
+Status DecompressChunk(rpc::CompressionCodec codec, const std::string &compressed,
+                       uint8_t *data, uint64_t size);
+
+}  // namespace ray
@@ -172,6 +172,22 @@ void ObjectBufferPool::SealChunk(const ObjectID &object_id, const uint64_t chunk
   }
 }
 
+bool ObjectBufferPool::GetMissingChunks(const ObjectID &object_id,
+                                        std::vector<uint64_t> *chunk_indices) {
+  std::lock_guard<std::mutex> lock(pool_mutex_);
+  auto it = create_buffer_state_.find(object_id);
+  if (it == create_buffer_state_.end()) {
+    return false;
+  }
+  const auto &chunk_state = it->second.chunk_state;
+  for (uint64_t chunk_index = 0; chunk_index < chunk_state.size(); chunk_index++) {
+    if (chunk_state[chunk_index] == CreateChunkState::AVAILABLE) {
+      chunk_indices->push_back(chunk_index);
+    }
+  }
+  return true;
+}
+
 void ObjectBufferPool::AbortCreate(const ObjectID &object_id) {
   RAY_CHECK_OK(store_client_.Release(object_id));
   RAY_CHECK_OK(store_client_.Abort(object_id));
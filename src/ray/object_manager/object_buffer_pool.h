@@ -131,6 +131,16 @@ class ObjectBufferPool {
   /// \param chunk_index The index of the chunk.
   void SealChunk(const ObjectID &object_id, uint64_t chunk_index);
 
+  /// Get the chunks of an object that is being received that have not been
+  /// written yet.
+  ///
+  /// \param object_id The ObjectID.
+  /// \param[out] chunk_indices The indices of the chunks that are missing.
+  /// \return False if no chunk of the object has been received yet, in which
+  /// case the number of chunks is not known.
+  bool GetMissingChunks(const ObjectID &object_id,
+                        std::vector<uint64_t> *chunk_indices);
+
   /// Free a list of objects from object store.
   ///
   /// \param object_ids the The list of ObjectIDs to be deleted.
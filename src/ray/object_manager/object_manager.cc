@@ -26,11 +26,29 @@ namespace object_manager_protocol = ray::object_manager::protocol;
 
 namespace ray {
 
+std::vector<std::vector<ClientID>> SplitBroadcastTree(
+    const std::vector<ClientID> &client_ids, int fan_out) {
+  std::vector<std::vector<ClientID>> subtrees;
+  const size_t num_subtrees =
+      std::min(client_ids.size(), static_cast<size_t>(std::max(fan_out, 1)));
+  size_t begin = 0;
+  for (size_t i = 0; i < num_subtrees; i++) {
+    size_t end = begin + (client_ids.size() - begin) / (num_subtrees - i);
+    subtrees.emplace_back(client_ids.begin() + begin, client_ids.begin() + end);
+    begin = end;
+  }
+  return subtrees;
+}
+
 ObjectStoreRunner::ObjectStoreRunner(const ObjectManagerConfig &config) {
   if (config.object_store_memory > 0) {
+    std::string external_store_endpoint;
+    if (!config.object_spilling_directory.empty()) {
+      external_store_endpoint = "file://" + config.object_spilling_directory;
+    }
     plasma::plasma_store_runner.reset(new plasma::PlasmaStoreRunner(
         config.store_socket_name, config.object_store_memory, config.huge_pages,
-        config.plasma_directory, ""));
+        config.plasma_directory, external_store_endpoint));
     // Initialize object store.
     store_thread_ =
         std::thread(&plasma::PlasmaStoreRunner::Start, plasma::plasma_store_runner.get());
@@ -63,6 +81,7 @@ ObjectManager::ObjectManager(asio::io_service &main_service, const ClientID &sel
       object_manager_service_(rpc_service_, *this),
       client_call_manager_(main_service, config_.rpc_service_threads_number) {
   RAY_CHECK(config_.rpc_service_threads_number > 0);
+  RAY_CHECK_OK(ParseCompressionCodec(config_.compression_codec, &compression_codec_));
   main_service_ = &main_service;
 
   if (plasma::plasma_store_runner) {
@@ -127,10 +146,19 @@ void ObjectManager::HandleObjectAdded(
   if (iter != unfulfilled_push_requests_.end()) {
     for (auto &pair : iter->second) {
       auto &client_id = pair.first;
-      main_service_->post([this, object_id, client_id]() { Push(object_id, client_id); });
-      // When push timeout is set to -1, there will be an empty timer in pair.second.
-      if (pair.second != nullptr) {
-        pair.second->cancel();
+      auto &request = pair.second;
+      // Replay the request with its chunk filter and forward list, so that a
+      // partial pull or a broadcast is served the same as if the object had
+      // been local when it arrived.
+      auto chunk_filter = request.chunk_filter;
+      auto forward_client_ids = request.forward_client_ids;
+      main_service_->post([this, object_id, client_id, chunk_filter,
+                           forward_client_ids]() {
+        Push(object_id, client_id, chunk_filter, forward_client_ids);
+      });
+      // When push timeout is set to -1, there will be an empty timer.
+      if (request.timer != nullptr) {
+        request.timer->cancel();
       }
     }
     unfulfilled_push_requests_.erase(iter);
@@ -234,37 +262,65 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
     return;
   }
 
-  // Choose a random client to pull the object from.
-  // Generate a random index.
-  std::uniform_int_distribution<int> distribution(0, node_vector.size() - 1);
-  int node_index = distribution(gen_);
-  ClientID node_id = node_vector[node_index];
-  // If the object manager somehow ended up choosing itself, choose a different
-  // object manager.
-  if (node_id == self_node_id_) {
-    std::swap(node_vector[node_index], node_vector[node_vector.size() - 1]);
-    node_vector.pop_back();
+  // Try the clients that have the object in a random order.
+  std::vector<ClientID> sources;
+  for (const auto &node_id : node_vector) {
+    if (node_id != self_node_id_) {
+      sources.push_back(node_id);
+    }
+  }
+  // If the object manager somehow ended up in the list of locations, do not
+  // try to pull from itself.
+  if (sources.size() < node_vector.size()) {
+    node_vector = sources;
     RAY_LOG(ERROR) << "The object manager with ID " << self_node_id_
                    << " is trying to pull object " << object_id
                    << " but the object table suggests that this object manager "
                    << "already has the object.";
-    node_id = node_vector[node_index % node_vector.size()];
-    RAY_CHECK(node_id != self_node_id_);
   }
+  std::shuffle(sources.begin(), sources.end(), gen_);
+
+  // Each source sends a disjoint subset of the chunks. The receiver does not
+  // know the size of the object before the first chunk arrives, so the first
+  // requests split the chunks by index modulo the number of sources. Once
+  // some chunks were received, only the missing ones are requested. Chunks
+  // that are still in flight from a source that has the object are not
+  // requested again until their request expires, so a retry only fetches the
+  // chunks that a slow or failed source did not send.
+  std::vector<uint64_t> missing_chunks;
+  bool num_chunks_known = buffer_pool_.GetMissingChunks(object_id, &missing_chunks);
+  const int64_t now_ms = absl::GetCurrentTimeNanos() / 1000000;
+  auto requests = it->second.chunk_tracker.NextRequests(
+      sources, config_.max_pull_sources, num_chunks_known ? &missing_chunks : nullptr,
+      now_ms, now_ms + config_.pull_timeout_ms);
+
+  for (const auto &request : requests) {
+    const ClientID &node_id = request.source;
+    rpc::PullRequest pull_request;
+    pull_request.set_object_id(object_id.Binary());
+    pull_request.set_client_id(self_node_id_.Binary());
+    pull_request.set_stripe_index(request.stripe_index);
+    pull_request.set_num_stripes(request.num_stripes);
+    for (uint64_t chunk_index : request.chunk_indices) {
+      pull_request.add_chunk_indices(chunk_index);
+    }
 
-  RAY_LOG(DEBUG) << "Sending pull request from " << self_node_id_ << " to " << node_id
-                 << " of object " << object_id;
+    RAY_LOG(DEBUG) << "Sending pull request from " << self_node_id_ << " to " << node_id
+                   << " of object " << object_id << ", stripe " << request.stripe_index
+                   << " of " << request.num_stripes << ", "
+                   << request.chunk_indices.size() << " chunks";
 
-  auto rpc_client = GetRpcClient(node_id);
-  if (rpc_client) {
-    // Try pulling from the client.
-    rpc_service_.post([this, object_id, node_id, rpc_client]() {
-      SendPullRequest(object_id, node_id, rpc_client);
-    });
-  } else {
-    RAY_LOG(ERROR) << "Couldn't send pull request from " << self_node_id_ << " to "
-                   << node_id << " of object " << object_id
-                   << " , setup rpc connection failed.";
+    auto rpc_client = GetRpcClient(node_id);
+    if (rpc_client) {
+      // Try pulling from the client.
+      rpc_service_.post([this, object_id, node_id, pull_request, rpc_client]() {
+        SendPullRequest(object_id, node_id, pull_request, rpc_client);
+      });
+    } else {
+      RAY_LOG(ERROR) << "Couldn't send pull request from " << self_node_id_ << " to "
+                     << node_id << " of object " << object_id
+                     << " , setup rpc connection failed.";
+    }
   }
 
   // If there are more clients to try, try them in succession, with a timeout
@@ -303,11 +359,8 @@ void ObjectManager::TryPull(const ObjectID &object_id) {
 
 void ObjectManager::SendPullRequest(
     const ObjectID &object_id, const ClientID &client_id,
+    const rpc::PullRequest &pull_request,
     std::shared_ptr<rpc::ObjectManagerClient> rpc_client) {
-  rpc::PullRequest pull_request;
-  pull_request.set_object_id(object_id.Binary());
-  pull_request.set_client_id(self_node_id_.Binary());
-
   rpc_client->Pull(pull_request, [object_id, client_id](const Status &status,
                                                         const rpc::PullReply &reply) {
     if (!status.ok()) {
@@ -379,12 +432,38 @@ void ObjectManager::HandleReceiveFinished(const ObjectID &object_id,
 }
 
 void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
+  Push(object_id, client_id, nullptr, {});
+}
+
+void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id,
+                         const std::function<bool(uint64_t)> &chunk_filter,
+                         const std::vector<ClientID> &forward_client_ids) {
   RAY_LOG(DEBUG) << "Push on " << self_node_id_ << " to " << client_id << " of object "
                  << object_id;
   if (local_objects_.count(object_id) == 0) {
     // Avoid setting duplicated timer for the same object and client pair.
     auto &clients = unfulfilled_push_requests_[object_id];
-    if (clients.count(client_id) == 0) {
+    auto pending = clients.find(client_id);
+    if (pending != clients.end()) {
+      // Merge the request into the one that is already waiting, so that the
+      // receiver gets every chunk that either of them asked for.
+      auto &request = pending->second;
+      if (request.chunk_filter && chunk_filter) {
+        auto first_filter = request.chunk_filter;
+        request.chunk_filter = [first_filter, chunk_filter](uint64_t chunk_index) {
+          return first_filter(chunk_index) || chunk_filter(chunk_index);
+        };
+      } else {
+        request.chunk_filter = nullptr;
+      }
+      for (const auto &forward_client_id : forward_client_ids) {
+        if (std::find(request.forward_client_ids.begin(),
+                      request.forward_client_ids.end(),
+                      forward_client_id) == request.forward_client_ids.end()) {
+          request.forward_client_ids.push_back(forward_client_id);
+        }
+      }
+    } else {
       // If config_.push_timeout_ms < 0, we give an empty timer
       // and the task will be kept infinitely.
       auto timer = std::unique_ptr<boost::asio::deadline_timer>();
@@ -407,7 +486,8 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
             });
       }
       if (config_.push_timeout_ms != 0) {
-        clients.emplace(client_id, std::move(timer));
+        clients.emplace(client_id, UnfulfilledPush{chunk_filter, forward_client_ids,
+                                                   std::move(timer)});
       }
     }
     return;
@@ -415,10 +495,15 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
 
   // If we haven't pushed this object to this same object manager yet, then push
   // it. If we have, but it was a long time ago, then push it. If we have and it
-  // was recent, then don't do it again.
+  // was recent, then don't do it again. Requests for a subset of the chunks
+  // come from a receiver that is still missing them, and broadcasts also have
+  // to reach the nodes behind the receiver, so they are always served.
   auto &recent_pushes = local_objects_[object_id].recent_pushes;
   auto it = recent_pushes.find(client_id);
-  if (it == recent_pushes.end()) {
+  if (chunk_filter || !forward_client_ids.empty()) {
+    RAY_LOG(DEBUG) << "Pushing " << object_id << " to " << client_id
+                   << " for a partial pull or broadcast";
+  } else if (it == recent_pushes.end()) {
     // We haven't pushed this specific object to this specific object manager
     // yet (or if we have then the object must have been evicted and recreated
     // locally).
@@ -450,17 +535,16 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
                    << ", total data size: " << data_size;
 
     UniqueID push_id = UniqueID::FromRandom();
+    auto forward_ids = std::make_shared<const std::vector<ClientID>>(forward_client_ids);
+    auto &window = push_windows_[client_id];
     for (uint64_t chunk_index = 0; chunk_index < num_chunks; ++chunk_index) {
-      rpc_service_.post([this, push_id, object_id, client_id, data_size, metadata_size,
-                         chunk_index, rpc_client]() {
-        auto st = SendObjectChunk(push_id, object_id, client_id, data_size, metadata_size,
-                                  chunk_index, rpc_client);
-        if (!st.ok()) {
-          RAY_LOG(WARNING) << "Send object " << object_id << " chunk failed due to "
-                           << st.message() << ", chunk index " << chunk_index;
-        }
-      });
+      if (chunk_filter && !chunk_filter(chunk_index)) {
+        continue;
+      }
+      window.queued_chunks.push_back({push_id, object_id, data_size, metadata_size,
+                                      chunk_index, forward_ids, rpc_client, nullptr});
     }
+    SendQueuedChunks(client_id);
   } else {
     // Push is best effort, so do nothing here.
     RAY_LOG(ERROR)
@@ -468,9 +552,77 @@ void ObjectManager::Push(const ObjectID &object_id, const ClientID &client_id) {
   }
 }
 
+void ObjectManager::SendQueuedChunks(const ClientID &client_id) {
+  auto it = push_windows_.find(client_id);
+  if (it == push_windows_.end()) {
+    return;
+  }
+  auto &window = it->second;
+  // Only a bounded number of chunks is copied into requests at a time, so that
+  // pushing a large object does not buffer all of it in gRPC at once.
+  while (window.num_in_flight < config_.max_chunks_in_flight_per_node &&
+         !window.queued_chunks.empty()) {
+    QueuedChunk chunk = std::move(window.queued_chunks.front());
+    window.queued_chunks.pop_front();
+    window.num_in_flight++;
+    if (chunk.forwarded_request != nullptr) {
+      // The chunk is already in memory, so there is no need to read it from
+      // the object store on an RPC thread.
+      SendForwardedChunk(client_id, chunk);
+      continue;
+    }
+    rpc_service_.post([this, client_id, chunk]() {
+      auto st = SendObjectChunk(chunk.push_id, chunk.object_id, client_id,
+                                chunk.data_size, chunk.metadata_size, chunk.chunk_index,
+                                *chunk.forward_client_ids, chunk.rpc_client);
+      if (!st.ok()) {
+        RAY_LOG(WARNING) << "Send object " << chunk.object_id << " chunk failed due to "
+                         << st.message() << ", chunk index " << chunk.chunk_index;
+        // No reply will arrive for this chunk, so release its slot here.
+        main_service_->post([this, client_id]() { HandleChunkSendDone(client_id); });
+      }
+    });
+  }
+  if (window.num_in_flight == 0) {
+    push_windows_.erase(it);
+  }
+}
+
+void ObjectManager::SendForwardedChunk(const ClientID &client_id,
+                                       const QueuedChunk &chunk) {
+  double start_time = absl::GetCurrentTimeNanos() / 1e9;
+  auto &request = *chunk.forwarded_request;
+  request.set_client_id(self_node_id_.Binary());
+  request.clear_forward_client_ids();
+  for (const auto &forward_client_id : *chunk.forward_client_ids) {
+    request.add_forward_client_ids(forward_client_id.Binary());
+  }
+  ObjectID object_id = chunk.object_id;
+  uint64_t chunk_index = chunk.chunk_index;
+  chunk.rpc_client->Push(request, [this, start_time, object_id, client_id, chunk_index](
+                                      const Status &status, const rpc::PushReply &reply) {
+    if (!status.ok()) {
+      RAY_LOG(WARNING) << "Forward object " << object_id << " chunk to client "
+                       << client_id << " failed due to" << status.message()
+                       << ", chunk index: " << chunk_index;
+    }
+    double end_time = absl::GetCurrentTimeNanos() / 1e9;
+    HandleSendFinished(object_id, client_id, chunk_index, start_time, end_time, status);
+    HandleChunkSendDone(client_id);
+  });
+}
+
+void ObjectManager::HandleChunkSendDone(const ClientID &client_id) {
+  auto it = push_windows_.find(client_id);
+  RAY_CHECK(it != push_windows_.end());
+  it->second.num_in_flight--;
+  SendQueuedChunks(client_id);
+}
+
 ray::Status ObjectManager::SendObjectChunk(
     const UniqueID &push_id, const ObjectID &object_id, const ClientID &client_id,
     uint64_t data_size, uint64_t metadata_size, uint64_t chunk_index,
+    const std::vector<ClientID> &forward_client_ids,
     std::shared_ptr<rpc::ObjectManagerClient> rpc_client) {
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
   rpc::PushRequest push_request;
@@ -481,6 +633,9 @@ ray::Status ObjectManager::SendObjectChunk(
   push_request.set_data_size(data_size);
   push_request.set_metadata_size(metadata_size);
   push_request.set_chunk_index(chunk_index);
+  for (const auto &forward_client_id : forward_client_ids) {
+    push_request.add_forward_client_ids(forward_client_id.Binary());
+  }
 
   // Get data
   std::pair<const ObjectBufferPool::ChunkInfo &, ray::Status> chunk_status =
@@ -496,7 +651,23 @@ ray::Status ObjectManager::SendObjectChunk(
     RAY_RETURN_NOT_OK(status);
   }
 
-  push_request.set_data(chunk_info.data, chunk_info.buffer_length);
+  // Only compress chunks that a sample shows to be compressible, so that
+  // already compressed or random data costs little extra CPU time.
+  std::string compressed_data;
+  if (compression_codec_ != rpc::NO_COMPRESSION &&
+      IsCompressible(chunk_info.data, chunk_info.buffer_length,
+                     config_.compression_min_ratio) &&
+      CompressChunk(compression_codec_, chunk_info.data, chunk_info.buffer_length,
+                    &compressed_data)
+          .ok() &&
+      compressed_data.size() < chunk_info.buffer_length) {
+    num_bytes_before_compression_ += chunk_info.buffer_length;
+    num_bytes_after_compression_ += compressed_data.size();
+    push_request.set_compression_codec(compression_codec_);
+    push_request.set_data(std::move(compressed_data));
+  } else {
+    push_request.set_data(chunk_info.data, chunk_info.buffer_length);
+  }
 
   // record the time cost between send chunk and receive reply
   rpc::ClientCallback<rpc::PushReply> callback = [this, start_time, object_id, client_id,
@@ -511,6 +682,7 @@ ray::Status ObjectManager::SendObjectChunk(
     }
     double end_time = absl::GetCurrentTimeNanos() / 1e9;
     HandleSendFinished(object_id, client_id, chunk_index, start_time, end_time, status);
+    HandleChunkSendDone(client_id);
   };
   rpc_client->Push(push_request, callback);
 
@@ -732,17 +904,58 @@ void ObjectManager::HandlePush(const rpc::PushRequest &request, rpc::PushReply *
 
   double start_time = absl::GetCurrentTimeNanos() / 1e9;
   auto status = ReceiveObjectChunk(client_id, object_id, data_size, metadata_size,
-                                   chunk_index, data);
+                                   chunk_index, request.compression_codec(), data);
   double end_time = absl::GetCurrentTimeNanos() / 1e9;
 
   HandleReceiveFinished(object_id, client_id, chunk_index, start_time, end_time, status);
+
+  // Pass the chunk on if this node is part of a broadcast tree. The chunk is
+  // forwarded even if it could not be written locally, so that the rest of
+  // the tree is not held up by this node.
+  if (request.forward_client_ids_size() > 0) {
+    auto forward_request = std::make_shared<rpc::PushRequest>(request);
+    main_service_->post(
+        [this, forward_request]() { ForwardObjectChunk(forward_request); });
+  }
   send_reply_callback(status, nullptr, nullptr);
 }
 
+void ObjectManager::ForwardObjectChunk(const std::shared_ptr<rpc::PushRequest> &request) {
+  ObjectID object_id = ObjectID::FromBinary(request->object_id());
+  UniqueID push_id = UniqueID::FromBinary(request->push_id());
+  uint64_t chunk_index = request->chunk_index();
+  std::vector<ClientID> client_ids;
+  for (const auto &forward_client_id : request->forward_client_ids()) {
+    client_ids.push_back(ClientID::FromBinary(forward_client_id));
+  }
+
+  for (const auto &subtree : SplitBroadcastTree(client_ids, config_.broadcast_fan_out)) {
+    const ClientID &child_id = subtree.front();
+    auto rpc_client = GetRpcClient(child_id);
+    if (!rpc_client) {
+      // The nodes in this subtree will pull the chunk from a holder of the
+      // object when their pull requests time out.
+      RAY_LOG(WARNING) << "Failed to forward chunk " << chunk_index << " of object "
+                       << object_id << " to " << child_id
+                       << ", setup rpc connection failed.";
+      continue;
+    }
+    auto forward_ids =
+        std::make_shared<const std::vector<ClientID>>(subtree.begin() + 1, subtree.end());
+    // Forwarded chunks share the window of the child with the chunks that this
+    // node pushes to it, so that a relay does not flood its children.
+    push_windows_[child_id].queued_chunks.push_back(
+        {push_id, object_id, request->data_size(), request->metadata_size(),
+         chunk_index, forward_ids, rpc_client, request});
+    SendQueuedChunks(child_id);
+  }
+}
+
 ray::Status ObjectManager::ReceiveObjectChunk(const ClientID &client_id,
                                               const ObjectID &object_id,
                                               uint64_t data_size, uint64_t metadata_size,
                                               uint64_t chunk_index,
+                                              rpc::CompressionCodec compression_codec,
                                               const std::string &data) {
   RAY_LOG(DEBUG) << "ReceiveObjectChunk on " << self_node_id_ << " from " << client_id
                  << " of object " << object_id << " chunk index: " << chunk_index
@@ -755,8 +968,15 @@ ray::Status ObjectManager::ReceiveObjectChunk(const ClientID &client_id,
   ObjectBufferPool::ChunkInfo chunk_info = chunk_status.first;
   if (chunk_status.second.ok()) {
     // Avoid handling this chunk if it's already being handled by another process.
-    std::memcpy(chunk_info.data, data.data(), chunk_info.buffer_length);
-    buffer_pool_.SealChunk(object_id, chunk_index);
+    status = DecompressChunk(compression_codec, data, chunk_info.data,
+                             chunk_info.buffer_length);
+    if (status.ok()) {
+      buffer_pool_.SealChunk(object_id, chunk_index);
+    } else {
+      RAY_LOG(WARNING) << "ReceiveObjectChunk index " << chunk_index << " of object "
+                       << object_id << " failed: " << status.message();
+      buffer_pool_.AbortCreateChunk(object_id, chunk_index);
+    }
   } else {
     RAY_LOG(WARNING) << "ReceiveObjectChunk index " << chunk_index << " of object "
                      << object_id << " failed: " << chunk_status.second.message();
@@ -783,10 +1003,82 @@ void ObjectManager::HandlePull(const rpc::PullRequest &request, rpc::PullReply *
     profile_events_.emplace_back(profile_event);
   }
 
-  main_service_->post([this, object_id, client_id]() { Push(object_id, client_id); });
+  // Only push the chunks that were requested, if the requester is pulling
+  // the object from several nodes at once.
+  std::function<bool(uint64_t)> chunk_filter;
+  if (request.chunk_indices_size() > 0) {
+    auto chunk_indices = std::make_shared<std::unordered_set<uint64_t>>(
+        request.chunk_indices().begin(), request.chunk_indices().end());
+    chunk_filter = [chunk_indices](uint64_t chunk_index) {
+      return chunk_indices->count(chunk_index) > 0;
+    };
+  } else if (request.num_stripes() > 1) {
+    uint64_t stripe_index = request.stripe_index();
+    uint64_t num_stripes = request.num_stripes();
+    chunk_filter = [stripe_index, num_stripes](uint64_t chunk_index) {
+      return chunk_index % num_stripes == stripe_index;
+    };
+  }
+  if (!chunk_filter && config_.broadcast_batch_ms > 0) {
+    main_service_->post(
+        [this, object_id, client_id]() { AddBroadcastRequest(object_id, client_id); });
+  } else {
+    main_service_->post([this, object_id, client_id, chunk_filter]() {
+      Push(object_id, client_id, chunk_filter, {});
+    });
+  }
   send_reply_callback(Status::OK(), nullptr, nullptr);
 }
 
+void ObjectManager::AddBroadcastRequest(const ObjectID &object_id,
+                                        const ClientID &client_id) {
+  if (local_objects_.count(object_id) == 0) {
+    Push(object_id, client_id);
+    return;
+  }
+  auto &broadcast = pending_broadcasts_[object_id];
+  if (std::find(broadcast.client_ids.begin(), broadcast.client_ids.end(), client_id) !=
+      broadcast.client_ids.end()) {
+    return;
+  }
+  broadcast.client_ids.push_back(client_id);
+  if (broadcast.timer == nullptr) {
+    broadcast.timer.reset(new boost::asio::deadline_timer(*main_service_));
+    broadcast.timer->expires_from_now(
+        boost::posix_time::milliseconds(config_.broadcast_batch_ms));
+    broadcast.timer->async_wait(
+        [this, object_id](const boost::system::error_code &error) {
+          if (!error) {
+            StartBroadcast(object_id);
+          }
+        });
+  }
+}
+
+void ObjectManager::StartBroadcast(const ObjectID &object_id) {
+  auto it = pending_broadcasts_.find(object_id);
+  if (it == pending_broadcasts_.end()) {
+    return;
+  }
+  std::vector<ClientID> client_ids = std::move(it->second.client_ids);
+  pending_broadcasts_.erase(it);
+  if (local_objects_.count(object_id) == 0) {
+    // The object was evicted in the meantime. Each node waits for the object
+    // to become local again on its own.
+    for (const auto &client_id : client_ids) {
+      Push(object_id, client_id);
+    }
+    return;
+  }
+
+  RAY_LOG(DEBUG) << "Broadcasting object " << object_id << " to " << client_ids.size()
+                 << " nodes";
+  for (const auto &subtree : SplitBroadcastTree(client_ids, config_.broadcast_fan_out)) {
+    Push(object_id, subtree.front(), nullptr,
+         std::vector<ClientID>(subtree.begin() + 1, subtree.end()));
+  }
+}
+
 void ObjectManager::HandleFreeObjects(const rpc::FreeObjectsRequest &request,
                                       rpc::FreeObjectsReply *reply,
                                       rpc::SendReplyCallback send_reply_callback) {
@@ -882,6 +1174,10 @@ std::string ObjectManager::DebugString() const {
   result << "\n- num unfulfilled push requests: " << unfulfilled_push_requests_.size();
   result << "\n- num pull requests: " << pull_requests_.size();
   result << "\n- num buffered profile events: " << profile_events_.size();
+  if (compression_codec_ != rpc::NO_COMPRESSION) {
+    result << "\n- bytes compressed: " << num_bytes_before_compression_ << " -> "
+           << num_bytes_after_compression_;
+  }
   result << "\n" << object_directory_->DebugString();
   result << "\n" << store_notification_->DebugString();
   result << "\n" << buffer_pool_.DebugString();
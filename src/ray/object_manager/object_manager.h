@@ -15,8 +15,10 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <deque>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -31,11 +33,13 @@
 #include "ray/common/id.h"
 #include "ray/common/ray_config.h"
 #include "ray/common/status.h"
+#include "ray/object_manager/chunk_codec.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 #include "ray/object_manager/notification/object_store_notification_manager_ipc.h"
 #include "ray/object_manager/object_buffer_pool.h"
 #include "ray/object_manager/object_directory.h"
 #include "ray/object_manager/plasma/store_runner.h"
+#include "ray/object_manager/pull_chunk_tracker.h"
 #include "ray/rpc/object_manager/object_manager_client.h"
 #include "ray/rpc/object_manager/object_manager_server.h"
 
@@ -67,6 +71,27 @@ struct ObjectManagerConfig {
   std::string plasma_directory;
   /// Enable huge pages.
   bool huge_pages;
+  /// The maximum number of chunks that may be in flight to a single remote
+  /// object manager at once. Further chunks are queued until earlier ones
+  /// are acknowledged.
+  int max_chunks_in_flight_per_node = 16;
+  /// The maximum number of remote object managers to pull a single object
+  /// from in parallel.
+  int max_pull_sources = 4;
+  /// The time to batch pull requests for the same object into a broadcast.
+  /// If 0, objects are not broadcast.
+  int broadcast_batch_ms = 0;
+  /// The number of nodes that each node forwards chunks to in a broadcast.
+  int broadcast_fan_out = 2;
+  /// The codec to compress object chunks with. If empty, chunks are sent
+  /// uncompressed.
+  std::string compression_codec;
+  /// Chunks are only compressed if a sample of them compresses to less than
+  /// this fraction of its size.
+  double compression_min_ratio = 0.8;
+  /// The directory to spill objects to when the store is low on memory. If
+  /// empty, objects are not spilled.
+  std::string object_spilling_directory;
 };
 
 struct LocalObjectInfo {
@@ -77,6 +102,17 @@ struct LocalObjectInfo {
   std::unordered_map<ClientID, int64_t> recent_pushes;
 };
 
+/// Split the nodes that a broadcast still has to reach into at most fan_out
+/// subtrees of nearly equal size. The first node of each subtree receives the
+/// chunks directly and forwards them to the rest of its subtree, so an object
+/// reaches N nodes after O(log(N)) hops.
+///
+/// \param client_ids The nodes to reach.
+/// \param fan_out The maximum number of subtrees.
+/// \return The subtrees, in the order of client_ids.
+std::vector<std::vector<ClientID>> SplitBroadcastTree(
+    const std::vector<ClientID> &client_ids, int fan_out);
+
 class ObjectStoreRunner {
  public:
   ObjectStoreRunner(const ObjectManagerConfig &config);
@@ -136,10 +172,12 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param data_size Data size
   /// \param metadata_size Metadata size
   /// \param chunk_index Chunk index of this object chunk, start with 0
+  /// \param forward_client_ids Nodes the remote object manager forwards the chunk to
   /// \param rpc_client Rpc client used to send message to remote object manager
   ray::Status SendObjectChunk(const UniqueID &push_id, const ObjectID &object_id,
                               const ClientID &client_id, uint64_t data_size,
                               uint64_t metadata_size, uint64_t chunk_index,
+                              const std::vector<ClientID> &forward_client_ids,
                               std::shared_ptr<rpc::ObjectManagerClient> rpc_client);
 
   /// Receive object chunk from remote object manager, small object may contain one chunk
@@ -149,16 +187,21 @@ class ObjectManager : public ObjectManagerInterface,
   /// \param data_size Data size
   /// \param metadata_size Metadata size
   /// \param chunk_index Chunk index
+  /// \param compression_codec The codec that the chunk data is compressed with
   /// \param data Chunk data
   ray::Status ReceiveObjectChunk(const ClientID &client_id, const ObjectID &object_id,
                                  uint64_t data_size, uint64_t metadata_size,
-                                 uint64_t chunk_index, const std::string &data);
+                                 uint64_t chunk_index,
+                                 rpc::CompressionCodec compression_codec,
+                                 const std::string &data);
 
   /// Send pull request
   ///
   /// \param object_id Object id
   /// \param client_id Remote server client id
+  /// \param pull_request The request, including which chunks to send.
   void SendPullRequest(const ObjectID &object_id, const ClientID &client_id,
+                       const rpc::PullRequest &pull_request,
                        std::shared_ptr<rpc::ObjectManagerClient> rpc_client);
 
   /// Get the rpc client according to the client ID
@@ -212,6 +255,21 @@ class ObjectManager : public ObjectManagerInterface,
   /// \return Void.
   void Push(const ObjectID &object_id, const ClientID &client_id);
 
+  /// Push a subset of an object's chunks to a remote object manager. This is
+  /// used to serve pull requests for a part of an object, and to broadcast an
+  /// object to many remote object managers.
+  ///
+  /// \param object_id The object's object id.
+  /// \param client_id The remote node's client id.
+  /// \param chunk_filter Returns whether the chunk with the given index should
+  /// be pushed. If empty, all chunks are pushed.
+  /// \param forward_client_ids The nodes that the remote object manager should
+  /// forward each chunk to.
+  /// \return Void.
+  void Push(const ObjectID &object_id, const ClientID &client_id,
+            const std::function<bool(uint64_t)> &chunk_filter,
+            const std::vector<ClientID> &forward_client_ids);
+
   /// Pull an object from ClientID.
   ///
   /// \param object_id The object's object id.
@@ -283,6 +341,8 @@ class ObjectManager : public ObjectManagerInterface,
     std::unique_ptr<boost::asio::deadline_timer> retry_timer;
     bool timer_set;
     std::vector<ClientID> client_locations;
+    /// The chunks that were requested from each location.
+    PullChunkTracker chunk_tracker;
   };
 
   struct WaitState {
@@ -350,6 +410,79 @@ class ObjectManager : public ObjectManagerInterface,
   /// Register object remove with directory.
   void NotifyDirectoryObjectDeleted(const ObjectID &object_id);
 
+  /// A chunk that is waiting to be sent to a remote object manager.
+  struct QueuedChunk {
+    UniqueID push_id;
+    ObjectID object_id;
+    uint64_t data_size;
+    uint64_t metadata_size;
+    uint64_t chunk_index;
+    /// The nodes that the receiver should forward the chunk to. Shared by all
+    /// chunks of the same push.
+    std::shared_ptr<const std::vector<ClientID>> forward_client_ids;
+    std::shared_ptr<rpc::ObjectManagerClient> rpc_client;
+    /// If the chunk is forwarded in a broadcast, the request that it was
+    /// received in. All children that the chunk is forwarded to share it.
+    std::shared_ptr<rpc::PushRequest> forwarded_request;
+  };
+
+  /// The chunks that are being sent to a remote object manager.
+  struct PushWindow {
+    /// Chunks that have not been sent yet, in order.
+    std::deque<QueuedChunk> queued_chunks;
+    /// The number of chunks that were sent but not acknowledged yet.
+    int num_in_flight = 0;
+  };
+
+  /// Send queued chunks to a remote object manager until its window of
+  /// in-flight chunks is full. This must be called on the main thread.
+  ///
+  /// \param client_id The ID of the remote object manager.
+  void SendQueuedChunks(const ClientID &client_id);
+
+  /// Send a chunk that is forwarded in a broadcast. The shared request is
+  /// updated for this receiver and serialized by the call, so the chunk data
+  /// is not copied for each receiver. This must be called on the main thread.
+  ///
+  /// \param client_id The ID of the remote object manager.
+  /// \param chunk The chunk to send.
+  void SendForwardedChunk(const ClientID &client_id, const QueuedChunk &chunk);
+
+  /// Release a slot in the window of a remote object manager once a chunk has
+  /// been acknowledged or failed to send, and send the next queued chunks.
+  /// This must be called on the main thread.
+  ///
+  /// \param client_id The ID of the remote object manager.
+  void HandleChunkSendDone(const ClientID &client_id);
+
+  /// Pull requests for the same object that will be served as one broadcast.
+  struct PendingBroadcast {
+    /// The nodes that requested the object, in the order of their requests.
+    std::vector<ClientID> client_ids;
+    /// Fires when the batching window for the broadcast closes.
+    std::unique_ptr<boost::asio::deadline_timer> timer;
+  };
+
+  /// Add a pull request to the broadcast of an object, starting the batching
+  /// window if this is the first request. This must be called on the main
+  /// thread.
+  ///
+  /// \param object_id The requested object.
+  /// \param client_id The node that requested the object.
+  void AddBroadcastRequest(const ObjectID &object_id, const ClientID &client_id);
+
+  /// Push an object to the nodes that requested it during the batching window,
+  /// arranged as a tree. This must be called on the main thread.
+  ///
+  /// \param object_id The object to broadcast.
+  void StartBroadcast(const ObjectID &object_id);
+
+  /// Forward a received chunk to the next nodes of a broadcast, through the
+  /// push window of each of them. This must be called on the main thread.
+  ///
+  /// \param request A copy of the push request that the chunk was received in.
+  void ForwardObjectChunk(const std::shared_ptr<rpc::PushRequest> &request);
+
   /// This is used to notify the main thread that the sending of a chunk has
   /// completed.
   ///
@@ -413,6 +546,14 @@ class ObjectManager : public ObjectManagerInterface,
   /// including when the object was last pushed to other object managers.
   std::unordered_map<ObjectID, LocalObjectInfo> local_objects_;
 
+  /// The chunks being pushed to each remote object manager. Only accessed on
+  /// the main thread.
+  std::unordered_map<ClientID, PushWindow> push_windows_;
+
+  /// Broadcasts that are waiting for their batching window to close. Only
+  /// accessed on the main thread.
+  std::unordered_map<ObjectID, PendingBroadcast> pending_broadcasts_;
+
   /// This is used as the callback identifier in Pull for
   /// SubscribeObjectLocations. We only need one identifier because we never need to
   /// subscribe multiple times to the same object during Pull.
@@ -421,11 +562,20 @@ class ObjectManager : public ObjectManagerInterface,
   /// A set of active wait requests.
   std::unordered_map<UniqueID, WaitState> active_wait_requests_;
 
+  /// A push request that waits for the object to become local.
+  struct UnfulfilledPush {
+    /// The chunks to push, or nullptr to push all of them.
+    std::function<bool(uint64_t)> chunk_filter;
+    /// The nodes that the receiver forwards the object to.
+    std::vector<ClientID> forward_client_ids;
+    /// Drops the request after push_timeout_ms. Empty if the request is kept
+    /// until the object is local.
+    std::unique_ptr<boost::asio::deadline_timer> timer;
+  };
+
   /// Maintains a map of push requests that have not been fulfilled due to an object not
   /// being local. Objects are removed from this map after push_timeout_ms have elapsed.
-  std::unordered_map<
-      ObjectID,
-      std::unordered_map<ClientID, std::unique_ptr<boost::asio::deadline_timer>>>
+  std::unordered_map<ObjectID, std::unordered_map<ClientID, UnfulfilledPush>>
       unfulfilled_push_requests_;
 
   /// The objects that this object manager is currently trying to fetch from
@@ -443,6 +593,14 @@ class ObjectManager : public ObjectManagerInterface,
   /// Internally maintained random number generator.
   std::mt19937_64 gen_;
 
+  /// The codec that chunks are compressed with before they are sent.
+  rpc::CompressionCodec compression_codec_ = rpc::NO_COMPRESSION;
+
+  /// The number of bytes of chunks that were sent compressed, before and after
+  /// compression. Updated from the rpc threads.
+  std::atomic<uint64_t> num_bytes_before_compression_{0};
+  std::atomic<uint64_t> num_bytes_after_compression_{0};
+
   /// The gPRC server.
   rpc::GrpcServer object_manager_server_;
 
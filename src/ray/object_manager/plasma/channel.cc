@@ -0,0 +1,321 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ray/object_manager/plasma/channel.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#ifdef __linux__
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+
+namespace {
+
+constexpr uint64_t kChannelMagic = 0x6c656e6e61686370;  // "pchannel"
+/// How many times the client checks for a reply before it goes to sleep.
+constexpr int kReplySpinIterations = 256;
+/// How long the client sleeps for a reply before checking that the store is
+/// still alive.
+constexpr long kReplyWaitNanoseconds = 100 * 1000 * 1000;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+}  // namespace
+
+/// The header of a ring. Each index is only written by one side, and the
+/// indices are on separate cache lines so that the two sides do not contend.
+/// The messages follow the header.
+struct PlasmaChannel::Ring {
+  /// The index of the next message to pop. Written by the consumer.
+  alignas(64) std::atomic<uint32_t> head;
+  /// The index of the next message to push. Written by the producer. This
+  /// is also the futex word that the client sleeps on for replies.
+  alignas(64) std::atomic<uint32_t> tail;
+  /// Whether the consumer is waiting to be woken up for the next message.
+  alignas(64) std::atomic<uint32_t> waiting;
+
+  ChannelMessage* messages() { return reinterpret_cast<ChannelMessage*>(this + 1); }
+};
+
+struct PlasmaChannel::Layout {
+  uint64_t magic;
+  /// The number of messages that each ring can hold. This is a power of two.
+  int64_t capacity;
+};
+
+size_t PlasmaChannel::RingSize(int64_t capacity) {
+  size_t size = sizeof(Ring) + capacity * sizeof(ChannelMessage);
+  return (size + 63) / 64 * 64;
+}
+
+PlasmaChannel::PlasmaChannel(MEMFD_TYPE memory_fd, MEMFD_TYPE doorbell_fd,
+                             Layout* layout, size_t map_size)
+    : memory_fd_(memory_fd),
+      doorbell_fd_(doorbell_fd),
+      layout_(layout),
+      capacity_(layout->capacity),
+      map_size_(map_size) {
+  requests_ = reinterpret_cast<Ring*>(reinterpret_cast<uint8_t*>(layout_) + 64);
+  replies_ = reinterpret_cast<Ring*>(reinterpret_cast<uint8_t*>(requests_) +
+                                     RingSize(capacity_));
+}
+
+PlasmaChannel::~PlasmaChannel() {
+  munmap(layout_, map_size_);
+  close(memory_fd_);
+  close(doorbell_fd_);
+}
+
+bool PlasmaChannel::IsSupported() { return true; }
+
+Status PlasmaChannel::Create(int64_t capacity, std::unique_ptr<PlasmaChannel>* channel) {
+  RAY_CHECK(capacity > 0);
+  // Round the capacity up to a power of two, so that the indices can wrap
+  // around.
+  int64_t ring_capacity = 1;
+  while (ring_capacity < capacity) {
+    ring_capacity *= 2;
+  }
+  const size_t map_size = 64 + 2 * RingSize(ring_capacity);
+
+  int memory_fd = syscall(SYS_memfd_create, "plasma-channel", 0);
+  if (memory_fd < 0) {
+    return Status::IOError(std::string("Failed to create channel memory: ") +
+                           strerror(errno));
+  }
+  if (ftruncate(memory_fd, map_size) != 0) {
+    close(memory_fd);
+    return Status::IOError(std::string("Failed to size channel memory: ") +
+                           strerror(errno));
+  }
+  void* pointer =
+      mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+  if (pointer == MAP_FAILED) {
+    close(memory_fd);
+    return Status::IOError(std::string("Failed to map channel memory: ") +
+                           strerror(errno));
+  }
+  int doorbell_fd = eventfd(0, 0);
+  if (doorbell_fd < 0) {
+    munmap(pointer, map_size);
+    close(memory_fd);
+    return Status::IOError(std::string("Failed to create channel doorbell: ") +
+                           strerror(errno));
+  }
+
+  // The file is zero-filled, so the rings start out empty.
+  auto layout = reinterpret_cast<Layout*>(pointer);
+  layout->magic = kChannelMagic;
+  layout->capacity = ring_capacity;
+  channel->reset(new PlasmaChannel(memory_fd, doorbell_fd, layout, map_size));
+  // The store is not processing any requests yet, so the first request
+  // should ring the doorbell.
+  (*channel)->ArmDoorbell();
+  return Status::OK();
+}
+
+Status PlasmaChannel::Open(MEMFD_TYPE memory_fd, MEMFD_TYPE doorbell_fd,
+                           std::unique_ptr<PlasmaChannel>* channel) {
+  struct stat info;
+  if (fstat(memory_fd, &info) != 0 || info.st_size < 64) {
+    close(memory_fd);
+    close(doorbell_fd);
+    return Status::IOError("Received an invalid channel from the store");
+  }
+  const size_t map_size = info.st_size;
+  void* pointer =
+      mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, memory_fd, 0);
+  if (pointer == MAP_FAILED) {
+    close(memory_fd);
+    close(doorbell_fd);
+    return Status::IOError(std::string("Failed to map channel memory: ") +
+                           strerror(errno));
+  }
+  auto layout = reinterpret_cast<Layout*>(pointer);
+  if (layout->magic != kChannelMagic || layout->capacity <= 0 ||
+      (layout->capacity & (layout->capacity - 1)) != 0 ||
+      64 + 2 * RingSize(layout->capacity) != map_size) {
+    munmap(pointer, map_size);
+    close(memory_fd);
+    close(doorbell_fd);
+    return Status::IOError("Received an invalid channel from the store");
+  }
+  channel->reset(new PlasmaChannel(memory_fd, doorbell_fd, layout, map_size));
+  return Status::OK();
+}
+
+bool PlasmaChannel::Push(Ring* ring, int64_t capacity, const ChannelMessage& message) {
+  const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  if (tail - ring->head.load(std::memory_order_acquire) >= capacity) {
+    return false;
+  }
+  ring->messages()[tail & (capacity - 1)] = message;
+  ring->tail.store(tail + 1, std::memory_order_seq_cst);
+  return true;
+}
+
+bool PlasmaChannel::Pop(Ring* ring, int64_t capacity, ChannelMessage* message) {
+  const uint32_t head = ring->head.load(std::memory_order_relaxed);
+  if (head == ring->tail.load(std::memory_order_acquire)) {
+    return false;
+  }
+  *message = ring->messages()[head & (capacity - 1)];
+  ring->head.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void PlasmaChannel::RingDoorbell() {
+  if (requests_->waiting.exchange(0, std::memory_order_seq_cst) == 1) {
+    uint64_t value = 1;
+    RAY_CHECK(write(doorbell_fd_, &value, sizeof(value)) == sizeof(value));
+  }
+}
+
+void PlasmaChannel::ArmDoorbell() {
+  requests_->waiting.store(1, std::memory_order_seq_cst);
+}
+
+bool PlasmaChannel::Post(int64_t type, const ObjectID& object_id) {
+  ChannelMessage request;
+  request.type = type;
+  request.result = 0;
+  std::memcpy(request.object_id, object_id.Data(), sizeof(request.object_id));
+  if (!Push(requests_, capacity_, request)) {
+    return false;
+  }
+  RingDoorbell();
+  return true;
+}
+
+Status PlasmaChannel::Call(int64_t type, const ObjectID& object_id,
+                           const std::function<bool()>& is_store_alive,
+                           int64_t* result) {
+  // The ring can only be full of requests without replies. Wait for the
+  // store to catch up on them.
+  while (!Post(type, object_id)) {
+    if (!is_store_alive()) {
+      return Status::IOError("The plasma store has gone away");
+    }
+    sched_yield();
+  }
+
+  // Spinning only helps if the store can run at the same time.
+  static const int spin_iterations =
+      std::thread::hardware_concurrency() > 1 ? kReplySpinIterations : 0;
+  ChannelMessage reply;
+  int spins = 0;
+  while (!Pop(replies_, capacity_, &reply)) {
+    if (spins < spin_iterations) {
+      spins++;
+      CpuRelax();
+      continue;
+    }
+    // Tell the store to wake us up, then check once more that the reply did
+    // not arrive in the meantime before going to sleep.
+    const uint32_t tail = replies_->tail.load(std::memory_order_seq_cst);
+    replies_->waiting.store(1, std::memory_order_seq_cst);
+    bool timed_out = false;
+    if (replies_->head.load(std::memory_order_relaxed) == tail) {
+      struct timespec timeout = {0, kReplyWaitNanoseconds};
+      timed_out = syscall(SYS_futex, &replies_->tail, FUTEX_WAIT, tail, &timeout,
+                          nullptr, 0) != 0 &&
+                  errno == ETIMEDOUT;
+    }
+    replies_->waiting.store(0, std::memory_order_relaxed);
+    if (timed_out && !is_store_alive()) {
+      return Status::IOError("The plasma store has gone away");
+    }
+  }
+  RAY_CHECK(reply.type == type &&
+            std::memcmp(reply.object_id, object_id.Data(), sizeof(reply.object_id)) == 0)
+      << "Received a reply to the wrong request on the plasma channel";
+  *result = reply.result;
+  return Status::OK();
+}
+
+bool PlasmaChannel::PopRequest(ChannelMessage* request) {
+  return Pop(requests_, capacity_, request);
+}
+
+void PlasmaChannel::PushReply(const ChannelMessage& request, int64_t result) {
+  ChannelMessage reply = request;
+  reply.result = result;
+  // The client waits for each reply before it sends the next request that
+  // expects one, so the reply ring cannot be full unless the client is
+  // misbehaving.
+  if (!Push(replies_, capacity_, reply)) {
+    RAY_LOG(WARNING) << "Dropping a reply on a full plasma channel";
+    return;
+  }
+  if (replies_->waiting.load(std::memory_order_seq_cst) == 1) {
+    syscall(SYS_futex, &replies_->tail, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+  }
+}
+
+#else
+
+PlasmaChannel::~PlasmaChannel() {}
+
+bool PlasmaChannel::IsSupported() { return false; }
+
+Status PlasmaChannel::Create(int64_t capacity, std::unique_ptr<PlasmaChannel>* channel) {
+  return Status::NotImplemented("The plasma channel is only supported on Linux");
+}
+
+Status PlasmaChannel::Open(MEMFD_TYPE memory_fd, MEMFD_TYPE doorbell_fd,
+                           std::unique_ptr<PlasmaChannel>* channel) {
+  return Status::NotImplemented("The plasma channel is only supported on Linux");
+}
+
+bool PlasmaChannel::Post(int64_t type, const ObjectID& object_id) { return false; }
+
+Status PlasmaChannel::Call(int64_t type, const ObjectID& object_id,
+                           const std::function<bool()>& is_store_alive,
+                           int64_t* result) {
+  return Status::NotImplemented("The plasma channel is only supported on Linux");
+}
+
+bool PlasmaChannel::PopRequest(ChannelMessage* request) { return false; }
+
+void PlasmaChannel::PushReply(const ChannelMessage& request, int64_t result) {}
+
+void PlasmaChannel::ArmDoorbell() {}
+
+#endif
+
+}  // namespace plasma
@@ -0,0 +1,165 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "ray/common/status.h"
+#include "ray/object_manager/plasma/common.h"
+#include "ray/object_manager/plasma/compat.h"
+#include "ray/util/macros.h"
+
+namespace plasma {
+
+using ray::Status;
+
+// ==== The shared memory channel ====
+//
+// A control channel between one client and the store for small, frequent
+// requests (Release and Contains), so that they do not have to go through
+// the store's socket. The channel is a memory-mapped file with two
+// single-producer single-consumer rings: one for requests from the client
+// to the store and one for replies from the store to the client.
+//
+// The client wakes up the store by writing to an eventfd (the "doorbell"),
+// which the store polls on its event loop. The store only asks to be woken
+// up once it has drained the request ring, so a burst of requests costs a
+// single write. The client spins briefly for a reply and then sleeps on a
+// futex in the reply ring.
+//
+// The socket is still used to set up the channel and for all other
+// requests. Before the store handles a socket message from a client, it
+// drains that client's request ring, so that requests are handled in the
+// order that the client sent them.
+//
+// The channel is only available on Linux.
+
+/// A request or a reply on the channel.
+struct ChannelMessage {
+  /// The type of the message. This is the MessageType of the equivalent
+  /// socket request, e.g. PlasmaReleaseRequest.
+  int64_t type;
+  /// The result of the request, for replies.
+  int64_t result;
+  /// The object the message is about.
+  uint8_t object_id[ObjectID::kLength];
+};
+
+class PlasmaChannel {
+ public:
+  ~PlasmaChannel();
+
+  /// Whether the channel is supported on this platform.
+  static bool IsSupported();
+
+  /// Create a new channel. This is called by the store.
+  ///
+  /// \param capacity The number of messages that each ring can hold.
+  /// \param[out] channel The new channel.
+  /// \return The return status.
+  static Status Create(int64_t capacity, std::unique_ptr<PlasmaChannel>* channel);
+
+  /// Open a channel that was created by the store. This is called by the
+  /// client, which takes ownership of the file descriptors.
+  ///
+  /// \param memory_fd The file descriptor of the channel's memory.
+  /// \param doorbell_fd The file descriptor that wakes up the store.
+  /// \param[out] channel The opened channel.
+  /// \return The return status.
+  static Status Open(MEMFD_TYPE memory_fd, MEMFD_TYPE doorbell_fd,
+                     std::unique_ptr<PlasmaChannel>* channel);
+
+  /// The file descriptor of the channel's memory, to send to the client.
+  MEMFD_TYPE memory_fd() const { return memory_fd_; }
+
+  /// The file descriptor that wakes up the store, to send to the client and
+  /// to poll on the store's event loop.
+  MEMFD_TYPE doorbell_fd() const { return doorbell_fd_; }
+
+  /// Client side: send a request that does not expect a reply.
+  ///
+  /// \param type The type of the request.
+  /// \param object_id The object the request is about.
+  /// \return False if the request ring is full, in which case the request
+  ///         was not sent.
+  bool Post(int64_t type, const ObjectID& object_id);
+
+  /// Client side: send a request and wait for the store's reply.
+  ///
+  /// \param type The type of the request.
+  /// \param object_id The object the request is about.
+  /// \param is_store_alive Called periodically while waiting, to stop
+  ///        waiting if the store has gone away.
+  /// \param[out] result The result in the store's reply.
+  /// \return The return status.
+  Status Call(int64_t type, const ObjectID& object_id,
+              const std::function<bool()>& is_store_alive, int64_t* result);
+
+  /// Store side: take the next request off the request ring.
+  ///
+  /// \param[out] request The request.
+  /// \return False if there are no more requests.
+  bool PopRequest(ChannelMessage* request);
+
+  /// Store side: reply to the request that was just taken off the ring.
+  ///
+  /// \param request The request to reply to.
+  /// \param result The result of the request.
+  void PushReply(const ChannelMessage& request, int64_t result);
+
+  /// Store side: ask the client to ring the doorbell for the next request.
+  /// The caller must drain the request ring once more after this, since a
+  /// request may have been pushed without a doorbell just before.
+  void ArmDoorbell();
+
+ private:
+  struct Ring;
+  struct Layout;
+
+  PlasmaChannel(MEMFD_TYPE memory_fd, MEMFD_TYPE doorbell_fd, Layout* layout,
+                size_t map_size);
+
+  /// The number of bytes that a ring with the given capacity takes up.
+  static size_t RingSize(int64_t capacity);
+
+  static bool Push(Ring* ring, int64_t capacity, const ChannelMessage& message);
+
+  static bool Pop(Ring* ring, int64_t capacity, ChannelMessage* message);
+
+  /// Client side: wake up the store if it asked to be woken up.
+  void RingDoorbell();
+
+  MEMFD_TYPE memory_fd_;
+  MEMFD_TYPE doorbell_fd_;
+  /// The memory-mapped channel, shared with the other process.
+  Layout* layout_;
+  /// The number of messages that each ring can hold. This is read once when
+  /// the channel is created or opened, since the other process can write to
+  /// the shared memory.
+  int64_t capacity_;
+  size_t map_size_;
+  /// The rings in the shared memory.
+  Ring* requests_;
+  Ring* replies_;
+
+  RAY_DISALLOW_COPY_AND_ASSIGN(PlasmaChannel);
+};
+
+}  // namespace plasma
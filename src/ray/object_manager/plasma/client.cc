@@ -29,10 +29,15 @@
 #include <unordered_set>
 #include <vector>
 
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
 #include <boost/asio.hpp>
 
 #include "arrow/buffer.h"
 
+#include "ray/object_manager/plasma/channel.h"
 #include "ray/object_manager/plasma/connection.h"
 #include "ray/object_manager/plasma/plasma.h"
 #include "ray/object_manager/plasma/protocol.h"
@@ -171,6 +176,17 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
 
   Status Seal(const ObjectID& object_id);
 
+  Status CreateBatch(const std::vector<ObjectID>& object_ids,
+                     const std::vector<int64_t>& data_sizes,
+                     const std::vector<const uint8_t*>& metadata,
+                     const std::vector<int64_t>& metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>>* data,
+                     std::vector<Status>* statuses, bool evict_if_full);
+
+  Status SealBatch(const std::vector<ObjectID>& object_ids);
+
+  Status ReleaseBatch(const std::vector<ObjectID>& object_ids);
+
   Status Delete(const std::vector<ObjectID>& object_ids);
 
   Status Evict(int64_t num_bytes, int64_t& num_bytes_evicted);
@@ -200,6 +216,15 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   /// \return The return status.
   Status MarkObjectUnused(const ObjectID& object_id);
 
+  /// Decrement the number of instances of an object that this client is
+  /// using, and mark the object unused once there are none left.
+  ///
+  /// \param object_id The object ID to decrement the count of.
+  /// \param[out] is_unused Whether the object is no longer used by this client,
+  ///        in which case the store must be told to release it.
+  /// \return The return status.
+  Status DecrementObjectCount(const ObjectID& object_id, bool* is_unused);
+
   /// Common helper for Get() variants
   Status GetBuffers(const ObjectID* object_ids, int64_t num_objects, int64_t timeout_ms,
                     const std::function<std::shared_ptr<Buffer>(
@@ -211,10 +236,21 @@ class PlasmaClient::Impl : public std::enable_shared_from_this<PlasmaClient::Imp
   void IncrementObjectCount(const ObjectID& object_id, PlasmaObject* object,
                             bool is_sealed);
 
+  /// Tell the store that the client no longer needs an object, over the
+  /// shared memory channel if there is one.
+  Status SendRelease(const ObjectID& object_id);
+
+  /// Whether the connection to the store is still open. This is used while
+  /// waiting for a reply on the shared memory channel.
+  bool IsStoreAlive();
+
   /// The boost::asio IO context for the client.
   boost::asio::io_service main_service_;
   /// The connection to the store service.
   std::shared_ptr<StoreConn> store_conn_;
+  /// The shared memory channel to the store for Release and Contains
+  /// requests, or nullptr if the store did not create one.
+  std::unique_ptr<PlasmaChannel> channel_;
   /// Table of dlmalloc buffer files that have been memory mapped so far. This
   /// is a hash table mapping a file descriptor to a struct containing the
   /// address of the corresponding memory-mapped file.
@@ -548,6 +584,23 @@ Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
   if (!store_conn_) {
     return Status::OK();
   }
+  bool is_unused;
+  RAY_RETURN_NOT_OK(DecrementObjectCount(object_id, &is_unused));
+  // Check if the client is no longer using this object.
+  if (is_unused) {
+    // Tell the store that the client no longer needs the object.
+    RAY_RETURN_NOT_OK(SendRelease(object_id));
+    auto iter = deletion_cache_.find(object_id);
+    if (iter != deletion_cache_.end()) {
+      deletion_cache_.erase(object_id);
+      RAY_RETURN_NOT_OK(Delete({object_id}));
+    }
+  }
+  return Status::OK();
+}
+
+Status PlasmaClient::Impl::DecrementObjectCount(const ObjectID& object_id,
+                                                bool* is_unused) {
   auto object_entry = objects_in_use_.find(object_id);
   RAY_CHECK(object_entry != objects_in_use_.end());
 
@@ -565,20 +618,35 @@ Status PlasmaClient::Impl::Release(const ObjectID& object_id) {
 
   object_entry->second->count -= 1;
   RAY_CHECK(object_entry->second->count >= 0);
-  // Check if the client is no longer using this object.
-  if (object_entry->second->count == 0) {
-    // Tell the store that the client no longer needs the object.
+  *is_unused = object_entry->second->count == 0;
+  if (*is_unused) {
     RAY_RETURN_NOT_OK(MarkObjectUnused(object_id));
-    RAY_RETURN_NOT_OK(SendReleaseRequest(store_conn_, object_id));
-    auto iter = deletion_cache_.find(object_id);
-    if (iter != deletion_cache_.end()) {
-      deletion_cache_.erase(object_id);
-      RAY_RETURN_NOT_OK(Delete({object_id}));
-    }
   }
   return Status::OK();
 }
 
+Status PlasmaClient::Impl::SendRelease(const ObjectID& object_id) {
+  // If the channel is full, fall back to the socket. The store handles the
+  // requests on the channel before the next message on the socket, so they
+  // are still handled in order.
+  if (channel_ &&
+      channel_->Post(static_cast<int64_t>(MessageType::PlasmaReleaseRequest), object_id)) {
+    return Status::OK();
+  }
+  return SendReleaseRequest(store_conn_, object_id);
+}
+
+bool PlasmaClient::Impl::IsStoreAlive() {
+#ifdef _WIN32
+  return true;
+#else
+  // The store never writes to the socket unprompted, so any event on it
+  // means that the store has closed the connection.
+  struct pollfd fd = {store_conn_->GetNativeHandle(), POLLIN, 0};
+  return poll(&fd, 1, 0) == 0;
+#endif
+}
+
 // This method is used to query whether the plasma store contains an object.
 Status PlasmaClient::Impl::Contains(const ObjectID& object_id, bool* has_object) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
@@ -589,6 +657,14 @@ Status PlasmaClient::Impl::Contains(const ObjectID& object_id, bool* has_object)
   } else {
     // If we don't already have a reference to the object, check with the store
     // to see if we have the object.
+    if (channel_) {
+      int64_t result;
+      RAY_RETURN_NOT_OK(channel_->Call(
+          static_cast<int64_t>(MessageType::PlasmaContainsRequest), object_id,
+          [this]() { return IsStoreAlive(); }, &result));
+      *has_object = result != 0;
+      return Status::OK();
+    }
     RAY_RETURN_NOT_OK(SendContainsRequest(store_conn_, object_id));
     std::vector<uint8_t> buffer;
     RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaContainsReply, &buffer));
@@ -632,6 +708,124 @@ Status PlasmaClient::Impl::Seal(const ObjectID& object_id) {
   return Release(object_id);
 }
 
+Status PlasmaClient::Impl::CreateBatch(const std::vector<ObjectID>& object_ids,
+                                       const std::vector<int64_t>& data_sizes,
+                                       const std::vector<const uint8_t*>& metadata,
+                                       const std::vector<int64_t>& metadata_sizes,
+                                       std::vector<std::shared_ptr<Buffer>>* data,
+                                       std::vector<Status>* statuses,
+                                       bool evict_if_full) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+  RAY_CHECK(object_ids.size() == data_sizes.size());
+  RAY_CHECK(object_ids.size() == metadata.size());
+  RAY_CHECK(object_ids.size() == metadata_sizes.size());
+
+  RAY_LOG(DEBUG) << "called plasma_create_batch on conn " << store_conn_ << " with "
+                 << object_ids.size() << " objects";
+  RAY_RETURN_NOT_OK(SendCreateBatchRequest(store_conn_, object_ids, evict_if_full,
+                                           data_sizes, metadata_sizes));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaCreateBatchReply, &buffer));
+  std::vector<ObjectID> ids;
+  std::vector<PlasmaObject> objects;
+  std::vector<MEMFD_TYPE> store_fds;
+  std::vector<int64_t> mmap_sizes;
+  RAY_RETURN_NOT_OK(ReadCreateBatchReply(buffer.data(), buffer.size(), &ids, &objects,
+                                         statuses, &store_fds, &mmap_sizes));
+  RAY_CHECK(ids.size() == object_ids.size());
+  // Receive the file descriptors for all created objects first, in the order
+  // that the store sent them.
+  for (size_t i = 0; i < store_fds.size(); i++) {
+    GetStoreFdAndMmap(store_fds[i], mmap_sizes[i]);
+  }
+
+  data->assign(object_ids.size(), nullptr);
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    if (!(*statuses)[i].ok()) {
+      continue;
+    }
+    PlasmaObject* object = &objects[i];
+    RAY_CHECK(object->data_size == data_sizes[i]);
+    RAY_CHECK(object->metadata_size == metadata_sizes[i]);
+    // The metadata should come right after the data.
+    RAY_CHECK(object->metadata_offset == object->data_offset + data_sizes[i]);
+    (*data)[i] = std::make_shared<PlasmaMutableBuffer>(
+        shared_from_this(), LookupMmappedFile(object->store_fd) + object->data_offset,
+        data_sizes[i]);
+    if (metadata[i] != nullptr) {
+      memcpy((*data)[i]->mutable_data() + object->data_size, metadata[i],
+             metadata_sizes[i]);
+    }
+    // As in Create(), the second reference is released when the object is
+    // sealed.
+    IncrementObjectCount(object_ids[i], object, false);
+    IncrementObjectCount(object_ids[i], object, false);
+  }
+  return Status::OK();
+}
+
+Status PlasmaClient::Impl::SealBatch(const std::vector<ObjectID>& object_ids) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  for (const auto& object_id : object_ids) {
+    auto object_entry = objects_in_use_.find(object_id);
+    if (object_entry == objects_in_use_.end()) {
+      return Status::ObjectNotFound(
+          "SealBatch() called on an object without a reference to it");
+    }
+    if (object_entry->second->is_sealed) {
+      return Status::ObjectAlreadySealed(
+          "SealBatch() called on an already sealed object");
+    }
+  }
+  for (const auto& object_id : object_ids) {
+    objects_in_use_[object_id]->is_sealed = true;
+  }
+
+  RAY_RETURN_NOT_OK(SendSealBatchRequest(store_conn_, object_ids));
+  std::vector<uint8_t> buffer;
+  RAY_RETURN_NOT_OK(
+      PlasmaReceive(store_conn_, MessageType::PlasmaSealBatchReply, &buffer));
+  std::vector<ObjectID> sealed_ids;
+  RAY_RETURN_NOT_OK(ReadSealBatchReply(buffer.data(), buffer.size(), &sealed_ids));
+  RAY_CHECK(sealed_ids == object_ids);
+  // Release the references that were taken in CreateBatch() or Create() to
+  // keep the objects alive until they are sealed.
+  return ReleaseBatch(object_ids);
+}
+
+Status PlasmaClient::Impl::ReleaseBatch(const std::vector<ObjectID>& object_ids) {
+  std::lock_guard<std::recursive_mutex> guard(client_mutex_);
+
+  // If the client is already disconnected, ignore release requests.
+  if (!store_conn_) {
+    return Status::OK();
+  }
+  std::vector<ObjectID> unused_ids;
+  for (const auto& object_id : object_ids) {
+    bool is_unused;
+    RAY_RETURN_NOT_OK(DecrementObjectCount(object_id, &is_unused));
+    if (is_unused) {
+      unused_ids.push_back(object_id);
+    }
+  }
+  if (unused_ids.empty()) {
+    return Status::OK();
+  }
+  RAY_RETURN_NOT_OK(SendReleaseBatchRequest(store_conn_, unused_ids));
+  std::vector<ObjectID> ids_to_delete;
+  for (const auto& object_id : unused_ids) {
+    if (deletion_cache_.erase(object_id) > 0) {
+      ids_to_delete.push_back(object_id);
+    }
+  }
+  if (!ids_to_delete.empty()) {
+    RAY_RETURN_NOT_OK(Delete(ids_to_delete));
+  }
+  return Status::OK();
+}
+
 Status PlasmaClient::Impl::Abort(const ObjectID& object_id) {
   std::lock_guard<std::recursive_mutex> guard(client_mutex_);
   auto object_entry = objects_in_use_.find(object_id);
@@ -728,7 +922,21 @@ Status PlasmaClient::Impl::Connect(const std::string& store_socket_name,
   RAY_RETURN_NOT_OK(SendConnectRequest(store_conn_));
   std::vector<uint8_t> buffer;
   RAY_RETURN_NOT_OK(PlasmaReceive(store_conn_, MessageType::PlasmaConnectReply, &buffer));
-  RAY_RETURN_NOT_OK(ReadConnectReply(buffer.data(), buffer.size(), &store_capacity_));
+  int64_t channel_capacity;
+  RAY_RETURN_NOT_OK(ReadConnectReply(buffer.data(), buffer.size(), &store_capacity_,
+                                     &channel_capacity));
+  if (channel_capacity > 0) {
+    MEMFD_TYPE memory_fd;
+    MEMFD_TYPE doorbell_fd;
+    RAY_RETURN_NOT_OK(store_conn_->RecvFd(&memory_fd));
+    RAY_RETURN_NOT_OK(store_conn_->RecvFd(&doorbell_fd));
+    Status status = PlasmaChannel::Open(memory_fd, doorbell_fd, &channel_);
+    if (!status.ok()) {
+      // The socket still works for all requests.
+      RAY_LOG(WARNING) << "Failed to open the shared memory channel to the plasma store: "
+                       << status.ToString();
+    }
+  }
   return Status::OK();
 }
 
@@ -750,6 +958,7 @@ Status PlasmaClient::Impl::Disconnect() {
 
   // Close the connections to Plasma. The Plasma store will release the objects
   // that were in use by us when handling the SIGPIPE.
+  channel_.reset();
   store_conn_.reset();
   return Status::OK();
 }
@@ -819,6 +1028,24 @@ Status PlasmaClient::Abort(const ObjectID& object_id) { return impl_->Abort(obje
 
 Status PlasmaClient::Seal(const ObjectID& object_id) { return impl_->Seal(object_id); }
 
+Status PlasmaClient::CreateBatch(const std::vector<ObjectID>& object_ids,
+                                 const std::vector<int64_t>& data_sizes,
+                                 const std::vector<const uint8_t*>& metadata,
+                                 const std::vector<int64_t>& metadata_sizes,
+                                 std::vector<std::shared_ptr<Buffer>>* data,
+                                 std::vector<Status>* statuses, bool evict_if_full) {
+  return impl_->CreateBatch(object_ids, data_sizes, metadata, metadata_sizes, data,
+                            statuses, evict_if_full);
+}
+
+Status PlasmaClient::SealBatch(const std::vector<ObjectID>& object_ids) {
+  return impl_->SealBatch(object_ids);
+}
+
+Status PlasmaClient::ReleaseBatch(const std::vector<ObjectID>& object_ids) {
+  return impl_->ReleaseBatch(object_ids);
+}
+
 Status PlasmaClient::Delete(const ObjectID& object_id) {
   return impl_->Delete(std::vector<ObjectID>{object_id});
 }
@@ -170,6 +170,46 @@ class RAY_EXPORT PlasmaClient {
   /// \return The return status.
   Status Seal(const ObjectID& object_id);
 
+  /// Create many objects in the Plasma Store with a single request. This is
+  /// equivalent to calling Create() for each object, but only takes one round
+  /// trip to the store. Objects are always created on the CPU.
+  ///
+  /// \param object_ids The IDs of the objects to create.
+  /// \param data_sizes The sizes in bytes of the objects' data.
+  /// \param metadata The objects' metadata, which is copied into the objects.
+  ///        An entry may be nullptr if the metadata is written later.
+  /// \param metadata_sizes The sizes in bytes of the objects' metadata.
+  /// \param[out] data The buffers to write the objects' data to. An entry is
+  ///        nullptr if the object could not be created.
+  /// \param[out] statuses The result of creating each object, like the return
+  ///        value of Create().
+  /// \param evict_if_full Whether to evict other objects to make space for
+  ///        these objects.
+  /// \return The return status. If this is not OK, no object was created.
+  ///
+  /// Each created object must be released once it is done with, and it must
+  /// either be sealed or aborted.
+  Status CreateBatch(const std::vector<ObjectID>& object_ids,
+                     const std::vector<int64_t>& data_sizes,
+                     const std::vector<const uint8_t*>& metadata,
+                     const std::vector<int64_t>& metadata_sizes,
+                     std::vector<std::shared_ptr<Buffer>>* data,
+                     std::vector<Status>* statuses, bool evict_if_full = true);
+
+  /// Seal many objects in the object store with a single request.
+  ///
+  /// \param object_ids The IDs of the objects to seal.
+  /// \return The return status. If this client has no reference to one of the
+  ///         objects or one of them is already sealed, no object is sealed.
+  Status SealBatch(const std::vector<ObjectID>& object_ids);
+
+  /// Tell Plasma that the client no longer needs many objects, with a single
+  /// request.
+  ///
+  /// \param object_ids The IDs of the objects that are no longer needed.
+  /// \return The return status.
+  Status ReleaseBatch(const std::vector<ObjectID>& object_ids);
+
   /// Delete an object from the object store. This currently assumes that the
   /// object is present, has been sealed and not used by another client. Otherwise,
   /// it is a no operation.
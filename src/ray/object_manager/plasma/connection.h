@@ -1,8 +1,13 @@
 #pragma once
 
+#ifndef _WIN32
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif
+
 #include "ray/common/client_connection.h"
 #include "ray/common/id.h"
 #include "ray/common/status.h"
+#include "ray/object_manager/plasma/channel.h"
 #include "ray/object_manager/plasma/compat.h"
 
 namespace plasma {
@@ -29,6 +34,16 @@ class Client : public ray::ClientConnection  {
 
   std::string name = "anonymous_client";
 
+  /// The shared memory channel for Release and Contains requests, or nullptr
+  /// if the store did not create one for this client.
+  std::unique_ptr<PlasmaChannel> channel;
+#ifndef _WIN32
+  /// Polls the channel's doorbell on the store's event loop.
+  std::unique_ptr<boost::asio::posix::stream_descriptor> channel_doorbell;
+  /// The value read from the doorbell.
+  uint64_t channel_doorbell_value = 0;
+#endif
+
  private:
   Client(ray::MessageHandler &message_handler, ray::local_stream_socket &&socket);
   /// File descriptors that are used by this client.
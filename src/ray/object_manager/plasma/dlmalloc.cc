@@ -27,10 +27,18 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 #include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/plasma/plasma.h"
 
 namespace plasma {
@@ -68,6 +76,49 @@ static void* pointer_advance(void* p, ptrdiff_t n) { return (unsigned char*)p +
 
 static void* pointer_retreat(void* p, ptrdiff_t n) { return (unsigned char*)p - n; }
 
+/// The largest number of NUMA nodes that Linux supports.
+constexpr int kMaxNumaNodes = 1024;
+
+/// Parse a single NUMA node number.
+static bool parse_numa_node(const std::string& str, int* node) {
+  if (str.empty() || str.size() > 4 ||
+      str.find_first_not_of("0123456789") != std::string::npos) {
+    return false;
+  }
+  *node = std::stoi(str);
+  return *node < kMaxNumaNodes;
+}
+
+bool ParseNumaNodeList(const std::string& list, std::vector<unsigned long>* mask) {
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  if (list.empty() || list.back() == ',') {
+    return false;
+  }
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    auto dash = range.find('-');
+    int first, last;
+    if (!parse_numa_node(range.substr(0, dash), &first)) {
+      return false;
+    }
+    last = first;
+    if (dash != std::string::npos && !parse_numa_node(range.substr(dash + 1), &last)) {
+      return false;
+    }
+    if (last < first) {
+      return false;
+    }
+    for (int node = first; node <= last; node++) {
+      if (mask->size() <= static_cast<size_t>(node / kBitsPerWord)) {
+        mask->resize(node / kBitsPerWord + 1, 0);
+      }
+      (*mask)[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+    }
+  }
+  return true;
+}
+
 #ifdef _WIN32
 void create_and_mmap_buffer(int64_t size, void **pointer, HANDLE* handle) {
   *handle = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
@@ -80,6 +131,97 @@ void create_and_mmap_buffer(int64_t size, void **pointer, HANDLE* handle) {
   }
 }
 #else
+#ifdef __linux__
+// Memory policies for mbind(2), see <linux/mempolicy.h>.
+constexpr int kMpolBind = 2;
+constexpr int kMpolInterleave = 3;
+
+/// Place the pages of a buffer on NUMA nodes according to the policy, which
+/// is "interleave", "interleave:<nodes>" or "bind:<nodes>". This must be done
+/// before the pages are first touched.
+static void apply_numa_policy(void* pointer, int64_t size, const std::string& policy) {
+  std::string mode = policy;
+  std::string nodes;
+  auto colon = policy.find(':');
+  if (colon != std::string::npos) {
+    mode = policy.substr(0, colon);
+    nodes = policy.substr(colon + 1);
+  } else {
+    std::ifstream online("/sys/devices/system/node/online");
+    std::getline(online, nodes);
+  }
+  int mpol_mode;
+  if (mode == "interleave") {
+    mpol_mode = kMpolInterleave;
+  } else if (mode == "bind") {
+    mpol_mode = kMpolBind;
+  } else {
+    RAY_LOG(WARNING) << "Ignoring unknown plasma NUMA policy " << policy;
+    return;
+  }
+  std::vector<unsigned long> mask;
+  if (!ParseNumaNodeList(nodes, &mask)) {
+    RAY_LOG(WARNING) << "Ignoring plasma NUMA policy " << policy
+                     << " with invalid node list \"" << nodes << "\"";
+    return;
+  }
+  if (syscall(SYS_mbind, pointer, size, mpol_mode, mask.data(),
+              8 * sizeof(unsigned long) * mask.size() + 1, 0) != 0) {
+    RAY_LOG(WARNING) << "Failed to apply plasma NUMA policy " << policy << ": "
+                     << std::strerror(errno);
+  }
+}
+
+/// Touch every page of a buffer from several threads, so that the page
+/// faults are taken now instead of when objects are first created.
+static void prefault_buffer(void* pointer, int64_t size, int num_threads) {
+  const int64_t page_size = sysconf(_SC_PAGESIZE);
+  const int64_t num_pages = (size + page_size - 1) / page_size;
+  num_threads = std::max(1, std::min<int>(num_threads, num_pages));
+  const int64_t pages_per_thread = (num_pages + num_threads - 1) / num_threads;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([=]() {
+      volatile uint8_t* base = static_cast<uint8_t*>(pointer);
+      int64_t end = std::min(num_pages, (i + 1) * pages_per_thread);
+      for (int64_t page = i * pages_per_thread; page < end; page++) {
+        base[page * page_size] = 0;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  RAY_LOG(INFO) << "Pre-faulted " << size << " bytes of plasma memory with "
+                << num_threads << " threads in "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start)
+                       .count()
+                << "ms";
+}
+#endif
+
+/// Apply the configured huge page, NUMA and pre-faulting options to a newly
+/// mapped buffer.
+static void prepare_buffer(void* pointer, int64_t size) {
+#ifdef __linux__
+  auto& config = RayConfig::instance();
+  if (!config.plasma_numa_policy().empty()) {
+    apply_numa_policy(pointer, size, config.plasma_numa_policy());
+  }
+  if (config.plasma_transparent_huge_pages() && !plasma_config->hugepages_enabled) {
+    if (madvise(pointer, size, MADV_HUGEPAGE) != 0) {
+      RAY_LOG(WARNING) << "Failed to enable transparent huge pages for plasma memory: "
+                       << std::strerror(errno);
+    }
+  }
+  if (config.plasma_prefault_memory()) {
+    prefault_buffer(pointer, size, config.plasma_prefault_threads());
+  }
+#endif
+}
+
 void create_and_mmap_buffer(int64_t size, void **pointer, int* fd) {
   // Create a buffer. This is creating a temporary file and then
   // immediately unlinking it so we do not leave traces in the system.
@@ -106,7 +248,8 @@ void create_and_mmap_buffer(int64_t size, void **pointer, int* fd) {
 
   // MAP_POPULATE can be used to pre-populate the page tables for this memory region
   // which avoids work when accessing the pages later. However it causes long pauses
-  // when mmapping the files. Only supported on Linux.
+  // when mmapping the files, so the pages are instead touched from several threads
+  // in prepare_buffer if plasma_prefault_memory is set.
   *pointer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, *fd, 0);
   if (*pointer == MAP_FAILED) {
     RAY_LOG(ERROR) << "mmap failed with error: " << std::strerror(errno);
@@ -114,6 +257,8 @@ void create_and_mmap_buffer(int64_t size, void **pointer, int* fd) {
       RAY_LOG(ERROR)
           << "  (this probably means you have to increase /proc/sys/vm/nr_hugepages)";
     }
+  } else {
+    prepare_buffer(*pointer, size);
   }
 }
 #endif
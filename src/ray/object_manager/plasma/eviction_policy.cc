@@ -45,18 +45,18 @@ int64_t LRUCache::Remove(const ObjectID& key) {
   return size;
 }
 
-void LRUCache::AdjustCapacity(int64_t delta) {
+void ObjectCache::AdjustCapacity(int64_t delta) {
   RAY_LOG(INFO) << "adjusting global lru capacity from " << Capacity() << " to "
                   << (Capacity() + delta) << " (max " << OriginalCapacity() << ")";
   capacity_ += delta;
   RAY_CHECK(used_capacity_ >= 0) << DebugString();
 }
 
-int64_t LRUCache::Capacity() const { return capacity_; }
+int64_t ObjectCache::Capacity() const { return capacity_; }
 
-int64_t LRUCache::OriginalCapacity() const { return original_capacity_; }
+int64_t ObjectCache::OriginalCapacity() const { return original_capacity_; }
 
-int64_t LRUCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
+int64_t ObjectCache::RemainingCapacity() const { return capacity_ - used_capacity_; }
 
 void LRUCache::Foreach(std::function<void(const ObjectID&)> f) {
   for (auto& pair : item_list_) {
@@ -64,13 +64,13 @@ void LRUCache::Foreach(std::function<void(const ObjectID&)> f) {
   }
 }
 
-std::string LRUCache::DebugString() const {
+std::string ObjectCache::DebugString() const {
   std::stringstream result;
   result << "\n(" << name_ << ") capacity: " << Capacity();
   result << "\n(" << name_
          << ") used: " << 100. * (1. - (RemainingCapacity() / (double)OriginalCapacity()))
          << "%";
-  result << "\n(" << name_ << ") num objects: " << item_map_.size();
+  result << "\n(" << name_ << ") num objects: " << NumObjects();
   result << "\n(" << name_ << ") num evictions: " << num_evictions_total_;
   result << "\n(" << name_ << ") bytes evicted: " << bytes_evicted_total_;
   return result.str();
@@ -90,23 +90,150 @@ int64_t LRUCache::ChooseObjectsToEvict(int64_t num_bytes_required,
   return bytes_evicted;
 }
 
-EvictionPolicy::EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size)
-    : pinned_memory_bytes_(0), store_info_(store_info), cache_("global lru", max_size) {}
+GreedyDualCache::ObjectStats& GreedyDualCache::GetStats(const ObjectID& key) {
+  auto it = stats_.find(key);
+  if (it != stats_.end()) {
+    // Move the object to the front of the history.
+    history_.splice(history_.begin(), history_, it->second.history_it);
+    return it->second;
+  }
+  if (history_.size() >= max_history_size_) {
+    stats_.erase(history_.back());
+    history_.pop_back();
+  }
+  history_.push_front(key);
+  auto& stats = stats_[key];
+  stats.history_it = history_.begin();
+  return stats;
+}
+
+void GreedyDualCache::Add(const ObjectID& key, int64_t size) {
+  RAY_CHECK(item_map_.find(key) == item_map_.end());
+  auto& stats = GetStats(key);
+  if (stats.evicted) {
+    stats.evicted = false;
+    stats.num_refetches++;
+    num_refetches_total_++;
+  }
+  stats.num_accesses++;
+  double priority = inflation_ + stats.num_accesses *
+                                     cost_function_(size, stats.num_refetches) /
+                                     std::max<int64_t>(size, 1);
+  auto it = queue_
+                .emplace(Priority(priority, next_sequence_number_++),
+                         std::make_pair(key, size))
+                .first;
+  item_map_.emplace(key, it);
+  used_capacity_ += size;
+}
+
+int64_t GreedyDualCache::Remove(const ObjectID& key) {
+  auto it = item_map_.find(key);
+  if (it == item_map_.end()) {
+    return -1;
+  }
+  int64_t size = it->second->second.second;
+  used_capacity_ -= size;
+  queue_.erase(it->second);
+  item_map_.erase(it);
+  RAY_CHECK(used_capacity_ >= 0) << DebugString();
+  return size;
+}
+
+int64_t GreedyDualCache::ChooseObjectsToEvict(int64_t num_bytes_required,
+                                              std::vector<ObjectID>* objects_to_evict) {
+  int64_t bytes_evicted = 0;
+  for (auto it = queue_.begin(); bytes_evicted < num_bytes_required && it != queue_.end();
+       it++) {
+    const auto& key = it->second.first;
+    objects_to_evict->push_back(key);
+    bytes_evicted += it->second.second;
+    bytes_evicted_total_ += it->second.second;
+    num_evictions_total_ += 1;
+    inflation_ = it->first.first;
+    auto stats_it = stats_.find(key);
+    if (stats_it != stats_.end()) {
+      stats_it->second.evicted = true;
+    }
+  }
+  return bytes_evicted;
+}
+
+void GreedyDualCache::Foreach(std::function<void(const ObjectID&)> f) {
+  for (auto& item : queue_) {
+    f(item.second.first);
+  }
+}
+
+std::string GreedyDualCache::DebugString() const {
+  std::stringstream result;
+  result << ObjectCache::DebugString();
+  result << "\n(" << name_ << ") inflation: " << inflation_;
+  result << "\n(" << name_ << ") num refetches: " << num_refetches_total_;
+  return result.str();
+}
+
+std::unordered_map<std::string, ObjectCaches::Factory>& ObjectCaches::Factories() {
+  static std::unordered_map<std::string, Factory> factories = {
+      {"lru",
+       [](const std::string& name, int64_t capacity) {
+         return std::unique_ptr<ObjectCache>(new LRUCache(name, capacity));
+       }},
+      {"gdsf",
+       [](const std::string& name, int64_t capacity) {
+         return std::unique_ptr<ObjectCache>(new GreedyDualCache(
+             name, capacity, [](int64_t size, int64_t num_refetches) { return 1.0; }));
+       }},
+      {"lfuda",
+       [](const std::string& name, int64_t capacity) {
+         return std::unique_ptr<ObjectCache>(new GreedyDualCache(
+             name, capacity,
+             [](int64_t size, int64_t num_refetches) { return static_cast<double>(size); }));
+       }},
+      {"cost_aware",
+       [](const std::string& name, int64_t capacity) {
+         return std::unique_ptr<ObjectCache>(new GreedyDualCache(
+             name, capacity, [](int64_t size, int64_t num_refetches) {
+               return static_cast<double>(kObjectFetchOverheadBytes + size) *
+                      (1 + num_refetches);
+             }));
+       }},
+  };
+  return factories;
+}
+
+void ObjectCaches::Register(const std::string& policy, Factory factory) {
+  Factories()[policy] = factory;
+}
+
+std::unique_ptr<ObjectCache> ObjectCaches::Create(const std::string& policy,
+                                                  const std::string& name, int64_t size) {
+  auto it = Factories().find(policy);
+  RAY_CHECK(it != Factories().end()) << "Unknown plasma eviction policy " << policy;
+  return it->second(name, size);
+}
+
+EvictionPolicy::EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                               const std::string& cache_policy)
+    : pinned_memory_bytes_(0),
+      store_info_(store_info),
+      cache_policy_(cache_policy),
+      cache_(ObjectCaches::Create(cache_policy, "global " + cache_policy, max_size)) {}
 
 int64_t EvictionPolicy::ChooseObjectsToEvict(int64_t num_bytes_required,
                                              std::vector<ObjectID>* objects_to_evict) {
   int64_t bytes_evicted =
-      cache_.ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
+      cache_->ChooseObjectsToEvict(num_bytes_required, objects_to_evict);
   // Update the LRU cache.
   for (auto& object_id : *objects_to_evict) {
-    cache_.Remove(object_id);
+    cache_->Remove(object_id);
   }
   return bytes_evicted;
 }
 
 void EvictionPolicy::ObjectCreated(const ObjectID& object_id, Client* client,
                                    bool is_create) {
-  cache_.Add(object_id, GetObjectSize(object_id));
+  cache_->Add(object_id, GetObjectSize(object_id));
 }
 
 bool EvictionPolicy::SetClientQuota(Client* client, int64_t output_memory_quota) {
@@ -125,9 +252,10 @@ bool EvictionPolicy::RequireSpace(int64_t size, std::vector<ObjectID>* objects_t
   int64_t required_space =
       PlasmaAllocator::Allocated() + size - PlasmaAllocator::GetFootprintLimit();
   // Try to free up at least as much space as we need right now but ideally
-  // up to 20% of the total capacity.
+  // up to a fraction of the total capacity.
   int64_t space_to_free =
-      std::max(required_space, PlasmaAllocator::GetFootprintLimit() / 5);
+      std::max(required_space, static_cast<int64_t>(PlasmaAllocator::GetFootprintLimit() *
+                                                    eviction_batch_fraction_));
   RAY_LOG(DEBUG) << "not enough space to create this object, so evicting objects";
   // Choose some objects to evict, and update the return pointers.
   int64_t num_bytes_evicted = ChooseObjectsToEvict(space_to_free, objects_to_evict);
@@ -140,27 +268,27 @@ bool EvictionPolicy::RequireSpace(int64_t size, std::vector<ObjectID>* objects_t
 
 void EvictionPolicy::BeginObjectAccess(const ObjectID& object_id) {
   // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
+  cache_->Remove(object_id);
   pinned_memory_bytes_ += GetObjectSize(object_id);
 }
 
 void EvictionPolicy::EndObjectAccess(const ObjectID& object_id) {
   auto size = GetObjectSize(object_id);
   // Add the object to the LRU cache.
-  cache_.Add(object_id, size);
+  cache_->Add(object_id, size);
   pinned_memory_bytes_ -= size;
 }
 
 void EvictionPolicy::RemoveObject(const ObjectID& object_id) {
   // If the object is in the LRU cache, remove it.
-  cache_.Remove(object_id);
+  cache_->Remove(object_id);
 }
 
 void EvictionPolicy::RefreshObjects(const std::vector<ObjectID>& object_ids) {
   for (const auto& object_id : object_ids) {
-    int64_t size = cache_.Remove(object_id);
+    int64_t size = cache_->Remove(object_id);
     if (size != -1) {
-      cache_.Add(object_id, size);
+      cache_->Add(object_id, size);
     }
   }
 }
@@ -170,6 +298,6 @@ int64_t EvictionPolicy::GetObjectSize(const ObjectID& object_id) const {
   return entry->data_size + entry->metadata_size;
 }
 
-std::string EvictionPolicy::DebugString() const { return cache_.DebugString(); }
+std::string EvictionPolicy::DebugString() const { return cache_->DebugString(); }
 
 }  // namespace plasma
@@ -19,6 +19,8 @@
 
 #include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -39,9 +41,11 @@ class Client;
 //
 // It does not implement memory quotas; see quota_aware_policy for that.
 
-class LRUCache {
+/// A cache of the objects that are not in use and may be evicted. Each
+/// implementation decides in which order objects are evicted.
+class ObjectCache {
  public:
-  LRUCache(const std::string& name, int64_t size)
+  ObjectCache(const std::string& name, int64_t size)
       : name_(name),
         original_capacity_(size),
         capacity_(size),
@@ -49,12 +53,28 @@ class LRUCache {
         num_evictions_total_(0),
         bytes_evicted_total_(0) {}
 
-  void Add(const ObjectID& key, int64_t size);
+  virtual ~ObjectCache() {}
 
-  int64_t Remove(const ObjectID& key);
+  /// Add an object to the cache. This is called when an object is created and
+  /// every time it stops being used.
+  virtual void Add(const ObjectID& key, int64_t size) = 0;
 
-  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
-                               std::vector<ObjectID>* objects_to_evict);
+  /// Remove an object from the cache.
+  ///
+  /// \return The size of the object, or -1 if it was not in the cache.
+  virtual int64_t Remove(const ObjectID& key) = 0;
+
+  /// Choose objects to evict, in eviction order. The objects are not removed
+  /// from the cache.
+  ///
+  /// \param num_bytes_required The number of bytes of space to try to free up.
+  /// \param objects_to_evict The object IDs that were chosen for eviction will
+  ///        be stored into this vector.
+  /// \return The total number of bytes of space chosen to be evicted.
+  virtual int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                                       std::vector<ObjectID>* objects_to_evict) = 0;
+
+  virtual void Foreach(std::function<void(const ObjectID&)>) = 0;
 
   int64_t OriginalCapacity() const;
 
@@ -64,18 +84,11 @@ class LRUCache {
 
   void AdjustCapacity(int64_t delta);
 
-  void Foreach(std::function<void(const ObjectID&)>);
-
-  std::string DebugString() const;
+  virtual std::string DebugString() const;
 
- private:
-  /// A doubly-linked list containing the items in the cache and
-  /// their sizes in LRU order.
-  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
-  ItemList item_list_;
-  /// A hash table mapping the object ID of an object in the cache to its
-  /// location in the doubly linked list item_list_.
-  std::unordered_map<ObjectID, ItemList::iterator> item_map_;
+ protected:
+  /// The number of objects in the cache.
+  virtual size_t NumObjects() const = 0;
 
   /// The name of this cache, used for debugging purposes only.
   const std::string name_;
@@ -91,6 +104,151 @@ class LRUCache {
   int64_t bytes_evicted_total_;
 };
 
+/// Evicts the least recently used object first.
+class LRUCache : public ObjectCache {
+ public:
+  LRUCache(const std::string& name, int64_t size) : ObjectCache(name, size) {}
+
+  void Add(const ObjectID& key, int64_t size) override;
+
+  int64_t Remove(const ObjectID& key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID>* objects_to_evict) override;
+
+  void Foreach(std::function<void(const ObjectID&)>) override;
+
+ protected:
+  size_t NumObjects() const override { return item_map_.size(); }
+
+ private:
+  /// A doubly-linked list containing the items in the cache and
+  /// their sizes in LRU order.
+  typedef std::list<std::pair<ObjectID, int64_t>> ItemList;
+  ItemList item_list_;
+  /// A hash table mapping the object ID of an object in the cache to its
+  /// location in the doubly linked list item_list_.
+  std::unordered_map<ObjectID, ItemList::iterator> item_map_;
+};
+
+/// The fixed cost of fetching an object, in the number of bytes that could be
+/// transferred in the same time. Used by the "cost_aware" eviction policy.
+constexpr int64_t kObjectFetchOverheadBytes = 64 * 1024;
+
+/// A GreedyDual-Size-Frequency cache. Every object gets the priority
+///
+///   inflation + num_accesses * cost / size
+///
+/// and the object with the lowest priority is evicted first. The inflation
+/// value is raised to the priority of each evicted object, so that objects
+/// that were accessed often a long time ago age out.
+///
+/// The cost function gives the cost of bringing an object back after it was
+/// evicted. The cache remembers a bounded number of objects after they are
+/// evicted, so that it can count how many times an object was fetched again.
+class GreedyDualCache : public ObjectCache {
+ public:
+  /// Return the cost of fetching an object again, given its size and the
+  /// number of times it was already fetched again after being evicted.
+  using CostFunction = std::function<double(int64_t size, int64_t num_refetches)>;
+
+  GreedyDualCache(const std::string& name, int64_t size, CostFunction cost_function,
+                  size_t max_history_size = 100000)
+      : ObjectCache(name, size),
+        cost_function_(cost_function),
+        max_history_size_(max_history_size) {}
+
+  void Add(const ObjectID& key, int64_t size) override;
+
+  int64_t Remove(const ObjectID& key) override;
+
+  int64_t ChooseObjectsToEvict(int64_t num_bytes_required,
+                               std::vector<ObjectID>* objects_to_evict) override;
+
+  void Foreach(std::function<void(const ObjectID&)>) override;
+
+  std::string DebugString() const override;
+
+ protected:
+  size_t NumObjects() const override { return item_map_.size(); }
+
+ private:
+  /// Priorities are unique because ties are broken by insertion order.
+  typedef std::pair<double, int64_t> Priority;
+  typedef std::map<Priority, std::pair<ObjectID, int64_t>> PriorityQueue;
+
+  /// Access statistics for an object, kept while the object is not in the
+  /// cache too.
+  struct ObjectStats {
+    int64_t num_accesses = 0;
+    int64_t num_refetches = 0;
+    /// Whether the object was chosen for eviction since it was last added.
+    bool evicted = false;
+    /// The position of the object in history_.
+    std::list<ObjectID>::iterator history_it;
+  };
+
+  /// Get the statistics for an object, creating them if needed.
+  ObjectStats& GetStats(const ObjectID& key);
+
+  const CostFunction cost_function_;
+  /// The objects in the cache, ordered by priority.
+  PriorityQueue queue_;
+  /// A hash table mapping the object ID of an object in the cache to its
+  /// position in queue_.
+  std::unordered_map<ObjectID, PriorityQueue::iterator> item_map_;
+  /// Statistics for the objects seen most recently.
+  std::unordered_map<ObjectID, ObjectStats> stats_;
+  /// The objects in stats_, from most to least recently added.
+  std::list<ObjectID> history_;
+  /// The maximum number of objects to keep statistics for.
+  const size_t max_history_size_;
+  /// The priority of the last evicted object.
+  double inflation_ = 0;
+  /// Used to order objects with equal priority by insertion order.
+  int64_t next_sequence_number_ = 0;
+  /// The number of objects that were added again after being evicted.
+  int64_t num_refetches_total_ = 0;
+};
+
+/// A registry of cache implementations, so that the eviction order can be
+/// chosen per plasma store. The built-in policies are:
+///
+/// - "lru": least recently used.
+/// - "gdsf": GreedyDual-Size-Frequency with a constant cost per object, which
+///   favors keeping many small objects.
+/// - "lfuda": LFU with dynamic aging, which is GDSF with a cost proportional
+///   to the object size, so that size does not affect the eviction order.
+/// - "cost_aware": the cost of an object is a fixed fetch overhead plus its
+///   size, times one plus the number of times it had to be fetched again
+///   after being evicted. Small objects are kept longer than large ones with
+///   the same history, since the overhead makes them more expensive per byte,
+///   and objects that are often reconstructed are kept longer than both.
+class ObjectCaches {
+ public:
+  typedef std::function<std::unique_ptr<ObjectCache>(const std::string& name,
+                                                     int64_t size)>
+      Factory;
+
+  /// Register a new cache implementation.
+  ///
+  /// \param policy The name that the implementation is selected with.
+  /// \param factory Creates a cache with the given name and capacity.
+  static void Register(const std::string& policy, Factory factory);
+
+  /// Create a cache that implements the given policy. The policy must have
+  /// been registered.
+  ///
+  /// \param policy The name of the policy.
+  /// \param name The name of the cache, used for debugging purposes only.
+  /// \param size The capacity of the cache in bytes.
+  static std::unique_ptr<ObjectCache> Create(const std::string& policy,
+                                             const std::string& name, int64_t size);
+
+ private:
+  static std::unordered_map<std::string, Factory>& Factories();
+};
+
 /// The eviction policy.
 class EvictionPolicy {
  public:
@@ -99,7 +257,10 @@ class EvictionPolicy {
   /// \param store_info Information about the Plasma store that is exposed
   ///        to the eviction policy.
   /// \param max_size Max size in bytes total of objects to store.
-  explicit EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size);
+  /// \param cache_policy The name of the cache policy that decides in which
+  ///        order objects are evicted. See ObjectCaches.
+  explicit EvictionPolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                          const std::string& cache_policy = "lru");
 
   /// Destroy an eviction policy.
   virtual ~EvictionPolicy() {}
@@ -155,6 +316,12 @@ class EvictionPolicy {
   /// \return True if enough space can be freed and false otherwise.
   virtual bool RequireSpace(int64_t size, std::vector<ObjectID>* objects_to_evict);
 
+  /// Set the fraction of the total capacity that RequireSpace tries to free
+  /// up at once, even if less space is needed right now.
+  ///
+  /// \param fraction The fraction of the capacity, 0.2 by default.
+  void SetEvictionBatchFraction(double fraction) { eviction_batch_fraction_ = fraction; }
+
   /// This method will be called whenever an unused object in the Plasma store
   /// starts to be used. When this method is called, the eviction policy will
   /// assume that the objects chosen to be evicted will in fact be evicted from
@@ -202,10 +369,15 @@ class EvictionPolicy {
   /// The number of bytes pinned by applications.
   int64_t pinned_memory_bytes_;
 
+  /// The fraction of the capacity that RequireSpace tries to free up.
+  double eviction_batch_fraction_ = 0.2;
+
   /// Pointer to the plasma store info.
   PlasmaStoreInfo* store_info_;
-  /// Datastructure for the LRU cache.
-  LRUCache cache_;
+  /// The name of the policy used for the caches.
+  const std::string cache_policy_;
+  /// The cache of objects that may be evicted.
+  std::unique_ptr<ObjectCache> cache_;
 };
 
 }  // namespace plasma
@@ -72,6 +72,17 @@ class ExternalStore {
   /// \return The return status.
   virtual Status Get(const std::vector<ObjectID>& ids,
                      std::vector<std::shared_ptr<Buffer>> buffers) = 0;
+
+  /// This method will be called whenever objects that were put in the
+  /// external store are deleted from the Plasma store, so that the external
+  /// store can free the space used by them. Deleting an object that was never
+  /// put is not an error.
+  ///
+  /// This API is experimental and might change in the future.
+  ///
+  /// \param ids The IDs of the objects to delete.
+  /// \return The return status.
+  virtual Status Delete(const std::vector<ObjectID>& ids) { return Status::OK(); }
 };
 
 class ExternalStores {
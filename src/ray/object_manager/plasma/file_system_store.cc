@@ -0,0 +1,173 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "ray/object_manager/plasma/file_system_store.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+#include <fstream>
+
+#include "ray/util/filesystem.h"
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+namespace {
+
+constexpr char kEndpointPrefix[] = "file://";
+
+}  // namespace
+
+FileSystemStore::~FileSystemStore() {
+  absl::MutexLock lock(&mu_);
+  for (const auto& entry : num_objects_per_file_) {
+    std::remove(GetFilePath(entry.first).c_str());
+  }
+}
+
+Status FileSystemStore::Connect(const std::string& endpoint) {
+  const std::string prefix(kEndpointPrefix);
+  if (endpoint.compare(0, prefix.size(), prefix) != 0 ||
+      endpoint.size() == prefix.size()) {
+    return Status::Invalid("Malformed file system store endpoint " + endpoint);
+  }
+  directory_ = endpoint.substr(prefix.size());
+#ifdef _WIN32
+  int result = _mkdir(directory_.c_str());
+#else
+  int result = mkdir(directory_.c_str(), 0700);
+#endif
+  if (result != 0 && errno != EEXIST) {
+    return Status::IOError("Failed to create spill directory " + directory_ + ": " +
+                           strerror(errno));
+  }
+  RAY_LOG(INFO) << "Spilling objects to " << directory_;
+  return Status::OK();
+}
+
+std::string FileSystemStore::GetFilePath(int64_t file_index) const {
+  return ray::JoinPaths(directory_, "plasma-spill-" + std::to_string(file_index));
+}
+
+Status FileSystemStore::Put(const std::vector<ObjectID>& ids,
+                            const std::vector<std::shared_ptr<Buffer>>& data) {
+  RAY_CHECK(ids.size() == data.size());
+  if (ids.empty()) {
+    return Status::OK();
+  }
+  int64_t file_index;
+  {
+    absl::MutexLock lock(&mu_);
+    file_index = next_file_index_++;
+  }
+
+  // Write all of the objects into a single file without holding the lock, so
+  // that restoring other objects is not blocked on the write.
+  const std::string path = GetFilePath(file_index);
+  std::vector<SpilledObject> locations;
+  locations.reserve(ids.size());
+  {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    int64_t offset = 0;
+    for (const auto& buffer : data) {
+      file.write(reinterpret_cast<const char*>(buffer->data()), buffer->size());
+      locations.push_back({file_index, offset, buffer->size()});
+      offset += buffer->size();
+    }
+    file.flush();
+    if (!file.good()) {
+      file.close();
+      std::remove(path.c_str());
+      return Status::IOError("Failed to write spill file " + path);
+    }
+  }
+
+  absl::MutexLock lock(&mu_);
+  for (size_t i = 0; i < ids.size(); i++) {
+    // If this object was already spilled before, keep only the newest copy.
+    RemoveObject(ids[i]);
+    spilled_objects_[ids[i]] = locations[i];
+  }
+  num_objects_per_file_[file_index] += ids.size();
+  return Status::OK();
+}
+
+Status FileSystemStore::Get(const std::vector<ObjectID>& ids,
+                            std::vector<std::shared_ptr<Buffer>> buffers) {
+  RAY_CHECK(ids.size() == buffers.size());
+  std::vector<SpilledObject> locations;
+  locations.reserve(ids.size());
+  {
+    absl::MutexLock lock(&mu_);
+    for (const auto& id : ids) {
+      auto it = spilled_objects_.find(id);
+      if (it == spilled_objects_.end()) {
+        return Status::ObjectNotFound("Object " + id.Hex() + " was not spilled");
+      }
+      locations.push_back(it->second);
+    }
+  }
+
+  for (size_t i = 0; i < ids.size(); i++) {
+    const auto& location = locations[i];
+    RAY_CHECK(buffers[i]->size() <= location.size);
+    const std::string path = GetFilePath(location.file_index);
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(location.offset);
+    file.read(reinterpret_cast<char*>(buffers[i]->mutable_data()), buffers[i]->size());
+    if (!file.good()) {
+      return Status::IOError("Failed to restore object " + ids[i].Hex() + " from " +
+                             path);
+    }
+  }
+  return Status::OK();
+}
+
+Status FileSystemStore::Delete(const std::vector<ObjectID>& ids) {
+  absl::MutexLock lock(&mu_);
+  for (const auto& id : ids) {
+    RemoveObject(id);
+  }
+  return Status::OK();
+}
+
+void FileSystemStore::RemoveObject(const ObjectID& id) {
+  auto it = spilled_objects_.find(id);
+  if (it == spilled_objects_.end()) {
+    return;
+  }
+  const int64_t file_index = it->second.file_index;
+  spilled_objects_.erase(it);
+  auto file_it = num_objects_per_file_.find(file_index);
+  RAY_CHECK(file_it != num_objects_per_file_.end());
+  if (--file_it->second == 0) {
+    num_objects_per_file_.erase(file_it);
+    std::remove(GetFilePath(file_index).c_str());
+  }
+}
+
+REGISTER_EXTERNAL_STORE("file", FileSystemStore);
+
+}  // namespace plasma
@@ -0,0 +1,90 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "ray/object_manager/plasma/external_store.h"
+
+namespace plasma {
+
+// ==== The local file system store ====
+//
+// An external store that spills objects to files in a local directory. The
+// endpoint has the form file://{directory}.
+//
+// Every call to Put writes all of its objects back to back into a single new
+// file, so that spilling many small objects results in a few large sequential
+// writes instead of one file per object. An in-memory index maps each spilled
+// object to its file and offset, and a file is unlinked once every object in
+// it has been deleted.
+//
+// All methods are thread-safe: the plasma store writes spilled objects from a
+// background thread while it restores objects on its main thread.
+
+class FileSystemStore : public ExternalStore {
+ public:
+  FileSystemStore() = default;
+
+  ~FileSystemStore() override;
+
+  Status Connect(const std::string& endpoint) override;
+
+  Status Put(const std::vector<ObjectID>& ids,
+             const std::vector<std::shared_ptr<Buffer>>& data) override;
+
+  Status Get(const std::vector<ObjectID>& ids,
+             std::vector<std::shared_ptr<Buffer>> buffers) override;
+
+  Status Delete(const std::vector<ObjectID>& ids) override;
+
+ private:
+  /// The location of a spilled object.
+  struct SpilledObject {
+    /// The index of the file that contains the object.
+    int64_t file_index;
+    /// The offset of the object in the file.
+    int64_t offset;
+    /// The number of bytes spilled for the object.
+    int64_t size;
+  };
+
+  /// Return the path of the spill file with the given index.
+  std::string GetFilePath(int64_t file_index) const;
+
+  /// Remove an object from the index and unlink its file if it was the last
+  /// object in that file.
+  void RemoveObject(const ObjectID& id) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  /// Protects the index below. File I/O happens outside of this lock.
+  absl::Mutex mu_;
+  /// The directory that spilled objects are written to.
+  std::string directory_;
+  /// The index that the next spill file will be created with.
+  int64_t next_file_index_ GUARDED_BY(mu_) = 0;
+  /// Mapping from object ID to where the object was spilled.
+  std::unordered_map<ObjectID, SpilledObject> spilled_objects_ GUARDED_BY(mu_);
+  /// Mapping from spill file index to the number of objects still in it.
+  std::unordered_map<int64_t, int64_t> num_objects_per_file_ GUARDED_BY(mu_);
+};
+
+}  // namespace plasma
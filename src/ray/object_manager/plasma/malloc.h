@@ -21,7 +21,9 @@
 #include <stddef.h>
 
 #include "ray/object_manager/plasma/compat.h"
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace plasma {
 
@@ -39,6 +41,14 @@ void GetMallocMapinfo(void* addr, MEMFD_TYPE* fd, int64_t* map_length, ptrdiff_t
 /// \return The size of the corresponding memory-mapped file.
 int64_t GetMmapSize(MEMFD_TYPE fd);
 
+/// Parse a NUMA node list such as "0-1,3" into a node mask, with one bit per
+/// node. This is the format of /sys/devices/system/node/online.
+///
+/// \param list The comma-separated list of nodes and node ranges.
+/// \param mask The mask to set the bits of the listed nodes in.
+/// \return Whether the list is well formed and not empty.
+bool ParseNumaNodeList(const std::string& list, std::vector<unsigned long>* mask);
+
 struct MmapRecord {
   MEMFD_TYPE fd;
   int64_t size;
@@ -364,6 +364,190 @@ Status ReadReleaseReply(uint8_t* data, size_t size, ObjectID* object_id) {
   return PlasmaErrorStatus(message->error());
 }
 
+// Batched create, seal and release messages.
+
+namespace {
+
+std::vector<ObjectID> ReadObjectIds(
+    const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>* object_ids) {
+  std::vector<ObjectID> result;
+  result.reserve(object_ids->size());
+  for (uoffset_t i = 0; i < object_ids->size(); ++i) {
+    result.push_back(ObjectID::FromBinary(object_ids->Get(i)->str()));
+  }
+  return result;
+}
+
+std::vector<PlasmaError> ReadErrors(const flatbuffers::Vector<int32_t>* errors) {
+  std::vector<PlasmaError> result;
+  result.reserve(errors->size());
+  for (uoffset_t i = 0; i < errors->size(); ++i) {
+    result.push_back(static_cast<PlasmaError>(errors->Get(i)));
+  }
+  return result;
+}
+
+}  // namespace
+
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID>& object_ids, bool evict_if_full,
+                              const std::vector<int64_t>& data_sizes,
+                              const std::vector<int64_t>& metadata_sizes) {
+  RAY_DCHECK(object_ids.size() == data_sizes.size());
+  RAY_DCHECK(object_ids.size() == metadata_sizes.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<uint64_t> data_sizes_unsigned(data_sizes.begin(), data_sizes.end());
+  std::vector<uint64_t> metadata_sizes_unsigned(metadata_sizes.begin(),
+                                                metadata_sizes.end());
+  auto message = fb::CreatePlasmaCreateBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()), evict_if_full,
+      fbb.CreateVector(arrow::util::MakeNonNull(data_sizes_unsigned.data()),
+                       data_sizes_unsigned.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(metadata_sizes_unsigned.data()),
+                       metadata_sizes_unsigned.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaCreateBatchRequest, &fbb, message);
+}
+
+Status ReadCreateBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                              bool* evict_if_full, std::vector<int64_t>* data_sizes,
+                              std::vector<int64_t>* metadata_sizes) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *object_ids = ReadObjectIds(message->object_ids());
+  *evict_if_full = message->evict_if_full();
+  data_sizes->assign(message->data_sizes()->begin(), message->data_sizes()->end());
+  metadata_sizes->assign(message->metadata_sizes()->begin(),
+                         message->metadata_sizes()->end());
+  if (data_sizes->size() != object_ids->size() ||
+      metadata_sizes->size() != object_ids->size()) {
+    return Status::Invalid("Malformed create batch request");
+  }
+  return Status::OK();
+}
+
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID>& object_ids,
+                            const std::vector<PlasmaObject>& objects,
+                            const std::vector<PlasmaError>& errors,
+                            const std::vector<MEMFD_TYPE>& store_fds,
+                            const std::vector<int64_t>& mmap_sizes) {
+  RAY_DCHECK(object_ids.size() == objects.size());
+  RAY_DCHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  std::vector<PlasmaObjectSpec> object_specs;
+  for (const auto& object : objects) {
+    object_specs.push_back(PlasmaObjectSpec(FD2INT(object.store_fd), object.data_offset,
+                                            object.data_size, object.metadata_offset,
+                                            object.metadata_size, object.device_num));
+  }
+  std::vector<int> store_fds_as_int;
+  for (MEMFD_TYPE store_fd : store_fds) {
+    store_fds_as_int.push_back(FD2INT(store_fd));
+  }
+  auto message = fb::CreatePlasmaCreateBatchReply(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateVectorOfStructs(arrow::util::MakeNonNull(object_specs.data()),
+                                object_specs.size()),
+      fbb.CreateVector(
+          arrow::util::MakeNonNull(reinterpret_cast<const int32_t*>(errors.data())),
+          errors.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(store_fds_as_int.data()),
+                       store_fds_as_int.size()),
+      fbb.CreateVector(arrow::util::MakeNonNull(mmap_sizes.data()), mmap_sizes.size()));
+  return PlasmaSend(client, MessageType::PlasmaCreateBatchReply, &fbb, message);
+}
+
+Status ReadCreateBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                            std::vector<PlasmaObject>* objects,
+                            std::vector<Status>* statuses,
+                            std::vector<MEMFD_TYPE>* store_fds,
+                            std::vector<int64_t>* mmap_sizes) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaCreateBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *object_ids = ReadObjectIds(message->object_ids());
+  statuses->clear();
+  for (PlasmaError error : ReadErrors(message->errors())) {
+    statuses->push_back(PlasmaErrorStatus(error));
+  }
+  objects->resize(object_ids->size());
+  for (uoffset_t i = 0; i < message->plasma_objects()->size(); ++i) {
+    const PlasmaObjectSpec* object = message->plasma_objects()->Get(i);
+    PlasmaObject& plasma_object = (*objects)[i];
+    plasma_object.store_fd = INT2FD(object->segment_index());
+    plasma_object.data_offset = object->data_offset();
+    plasma_object.data_size = object->data_size();
+    plasma_object.metadata_offset = object->metadata_offset();
+    plasma_object.metadata_size = object->metadata_size();
+    plasma_object.device_num = object->device_num();
+  }
+  RAY_CHECK(message->store_fds()->size() == message->mmap_sizes()->size());
+  for (uoffset_t i = 0; i < message->store_fds()->size(); i++) {
+    store_fds->push_back(INT2FD(message->store_fds()->Get(i)));
+    mmap_sizes->push_back(message->mmap_sizes()->Get(i));
+  }
+  return Status::OK();
+}
+
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID>& object_ids) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaSealBatchRequest, &fbb, message);
+}
+
+Status ReadSealBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *object_ids = ReadObjectIds(message->object_ids());
+  return Status::OK();
+}
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID>& object_ids,
+                          const std::vector<PlasmaError>& errors) {
+  RAY_DCHECK(object_ids.size() == errors.size());
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaSealBatchReply(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()),
+      fbb.CreateVector(
+          arrow::util::MakeNonNull(reinterpret_cast<const int32_t*>(errors.data())),
+          errors.size()));
+  return PlasmaSend(client, MessageType::PlasmaSealBatchReply, &fbb, message);
+}
+
+Status ReadSealBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaSealBatchReply>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *object_ids = ReadObjectIds(message->object_ids());
+  // Return the first error, like a sequence of single seal requests would.
+  for (PlasmaError error : ReadErrors(message->errors())) {
+    RAY_RETURN_NOT_OK(PlasmaErrorStatus(error));
+  }
+  return Status::OK();
+}
+
+Status SendReleaseBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                               const std::vector<ObjectID>& object_ids) {
+  flatbuffers::FlatBufferBuilder fbb;
+  auto message = fb::CreatePlasmaReleaseBatchRequest(
+      fbb, ToFlatbuffer(&fbb, object_ids.data(), object_ids.size()));
+  return PlasmaSend(store_conn, MessageType::PlasmaReleaseBatchRequest, &fbb, message);
+}
+
+Status ReadReleaseBatchRequest(uint8_t* data, size_t size,
+                               std::vector<ObjectID>* object_ids) {
+  RAY_DCHECK(data);
+  auto message = flatbuffers::GetRoot<fb::PlasmaReleaseBatchRequest>(data);
+  RAY_DCHECK(VerifyFlatbuffer(message, data, size));
+  *object_ids = ReadObjectIds(message->object_ids());
+  return Status::OK();
+}
+
 // Delete objects messages.
 
 Status SendDeleteRequest(const std::shared_ptr<StoreConn> &store_conn, const std::vector<ObjectID>& object_ids) {
@@ -462,17 +646,20 @@ Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn) {
 
 Status ReadConnectRequest(uint8_t* data) { return Status::OK(); }
 
-Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity) {
+Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity,
+                        int64_t channel_capacity) {
   flatbuffers::FlatBufferBuilder fbb;
-  auto message = fb::CreatePlasmaConnectReply(fbb, memory_capacity);
+  auto message = fb::CreatePlasmaConnectReply(fbb, memory_capacity, channel_capacity);
   return PlasmaSend(client, MessageType::PlasmaConnectReply, &fbb, message);
 }
 
-Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity) {
+Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity,
+                        int64_t* channel_capacity) {
   RAY_DCHECK(data);
   auto message = flatbuffers::GetRoot<fb::PlasmaConnectReply>(data);
   RAY_DCHECK(VerifyFlatbuffer(message, data, size));
   *memory_capacity = message->memory_capacity();
+  *channel_capacity = message->channel_capacity();
   return Status::OK();
 }
 
@@ -137,6 +137,47 @@ Status SendReleaseReply(const std::shared_ptr<Client> &client, ObjectID object_i
 
 Status ReadReleaseReply(uint8_t* data, size_t size, ObjectID* object_id);
 
+/* Plasma batched Create, Seal and Release message functions. */
+
+Status SendCreateBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                              const std::vector<ObjectID>& object_ids, bool evict_if_full,
+                              const std::vector<int64_t>& data_sizes,
+                              const std::vector<int64_t>& metadata_sizes);
+
+Status ReadCreateBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                              bool* evict_if_full, std::vector<int64_t>* data_sizes,
+                              std::vector<int64_t>* metadata_sizes);
+
+Status SendCreateBatchReply(const std::shared_ptr<Client> &client,
+                            const std::vector<ObjectID>& object_ids,
+                            const std::vector<PlasmaObject>& objects,
+                            const std::vector<PlasmaError>& errors,
+                            const std::vector<MEMFD_TYPE>& store_fds,
+                            const std::vector<int64_t>& mmap_sizes);
+
+Status ReadCreateBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids,
+                            std::vector<PlasmaObject>* objects,
+                            std::vector<Status>* statuses,
+                            std::vector<MEMFD_TYPE>* store_fds,
+                            std::vector<int64_t>* mmap_sizes);
+
+Status SendSealBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                            const std::vector<ObjectID>& object_ids);
+
+Status ReadSealBatchRequest(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids);
+
+Status SendSealBatchReply(const std::shared_ptr<Client> &client,
+                          const std::vector<ObjectID>& object_ids,
+                          const std::vector<PlasmaError>& errors);
+
+Status ReadSealBatchReply(uint8_t* data, size_t size, std::vector<ObjectID>* object_ids);
+
+Status SendReleaseBatchRequest(const std::shared_ptr<StoreConn> &store_conn,
+                               const std::vector<ObjectID>& object_ids);
+
+Status ReadReleaseBatchRequest(uint8_t* data, size_t size,
+                               std::vector<ObjectID>* object_ids);
+
 /* Plasma Delete objects message functions. */
 
 Status SendDeleteRequest(const std::shared_ptr<StoreConn> &store_conn, const std::vector<ObjectID>& object_ids);
@@ -166,9 +207,11 @@ Status SendConnectRequest(const std::shared_ptr<StoreConn> &store_conn);
 
 Status ReadConnectRequest(uint8_t* data, size_t size);
 
-Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity);
+Status SendConnectReply(const std::shared_ptr<Client> &client, int64_t memory_capacity,
+                        int64_t channel_capacity);
 
-Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity);
+Status ReadConnectReply(uint8_t* data, size_t size, int64_t* memory_capacity,
+                        int64_t* channel_capacity);
 
 /* Plasma Evict message functions (no reply so far). */
 
@@ -59,7 +59,10 @@ class QuotaAwarePolicy : public EvictionPolicy {
   /// \param store_info Information about the Plasma store that is exposed
   ///        to the eviction policy.
   /// \param max_size Max size in bytes total of objects to store.
-  explicit QuotaAwarePolicy(PlasmaStoreInfo* store_info, int64_t max_size);
+  /// \param cache_policy The name of the cache policy that decides in which
+  ///        order objects are evicted. See ObjectCaches.
+  explicit QuotaAwarePolicy(PlasmaStoreInfo* store_info, int64_t max_size,
+                            const std::string& cache_policy = "lru");
   void ObjectCreated(const ObjectID& object_id, Client* client, bool is_create) override;
   bool SetClientQuota(Client* client, int64_t output_memory_quota) override;
   bool EnforcePerClientQuota(Client* client, int64_t size, bool is_create,
@@ -75,8 +78,8 @@ class QuotaAwarePolicy : public EvictionPolicy {
   /// Returns whether we are enforcing memory quotas for an operation.
   bool HasQuota(Client* client, bool is_create);
 
-  /// Per-client LRU caches, if quota is enabled.
-  std::unordered_map<Client*, std::unique_ptr<LRUCache>> per_client_cache_;
+  /// Per-client caches, if quota is enabled.
+  std::unordered_map<Client*, std::unique_ptr<ObjectCache>> per_client_cache_;
   /// Tracks which client created which object. This only applies to clients
   /// that have a memory quota set.
   std::unordered_map<ObjectID, Client*> owned_by_client_;
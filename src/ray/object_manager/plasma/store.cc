@@ -36,6 +36,7 @@
 #include <ctime>
 #include <deque>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -44,11 +45,13 @@
 
 #include <boost/bind.hpp>
 
+#include "ray/common/ray_config.h"
 #include "ray/object_manager/format/object_manager_generated.h"
 #include "ray/object_manager/plasma/common.h"
 #include "ray/object_manager/plasma/malloc.h"
 #include "ray/object_manager/plasma/plasma_allocator.h"
 #include "ray/object_manager/plasma/protocol.h"
+#include "ray/stats/stats.h"
 #include "ray/util/util.h"
 
 #ifdef PLASMA_CUDA
@@ -110,8 +113,16 @@ PlasmaStore::PlasmaStore(boost::asio::io_service &main_service, std::string dire
       socket_name_(socket_name),
       acceptor_(main_service, ParseUrlEndpoint(socket_name)),
       socket_(main_service),
-      eviction_policy_(&store_info_, PlasmaAllocator::GetFootprintLimit()),
-      external_store_(external_store) {
+      eviction_policy_(&store_info_, PlasmaAllocator::GetFootprintLimit(),
+                       RayConfig::instance().plasma_eviction_policy()),
+      background_eviction_enabled_(
+          RayConfig::instance().plasma_background_eviction_enabled() &&
+          external_store == nullptr),
+      eviction_high_watermark_(RayConfig::instance().plasma_eviction_high_watermark()),
+      eviction_low_watermark_(RayConfig::instance().plasma_eviction_low_watermark()),
+      external_store_(external_store),
+      spill_high_watermark_(RayConfig::instance().object_spilling_high_watermark()),
+      spill_low_watermark_(RayConfig::instance().object_spilling_low_watermark()) {
   store_info_.directory = directory;
   store_info_.hugepages_enabled = hugepages_enabled;
 #ifdef PLASMA_CUDA
@@ -119,10 +130,25 @@ PlasmaStore::PlasmaStore(boost::asio::io_service &main_service, std::string dire
   DCHECK_OK(maybe_manager.status());
   manager_ = *maybe_manager;
 #endif
+  if (background_eviction_enabled_) {
+    // Space is reclaimed ahead of time, so creating an object only needs to
+    // evict as much as it needs.
+    eviction_policy_.SetEvictionBatchFraction(0);
+  }
+  if (external_store_) {
+    spill_work_.reset(new boost::asio::io_service::work(spill_service_));
+    spill_thread_ = std::thread([this]() { spill_service_.run(); });
+  }
 }
 
 // TODO(pcm): Get rid of this destructor by using RAII to clean up data.
-PlasmaStore::~PlasmaStore() {}
+PlasmaStore::~PlasmaStore() {
+  if (spill_thread_.joinable()) {
+    // Let any in-progress write finish before the external store goes away.
+    spill_work_.reset();
+    spill_thread_.join();
+  }
+}
 
 void PlasmaStore::Start() {
   // Start listening for clients.
@@ -189,9 +215,18 @@ uint8_t* PlasmaStore::AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE
       break;
     }
     // Tell the eviction policy how much space we need to create this object.
+    auto start = std::chrono::steady_clock::now();
     std::vector<ObjectID> objects_to_evict;
     bool success = eviction_policy_.RequireSpace(size, &objects_to_evict);
     EvictObjects(objects_to_evict);
+    int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+    num_blocking_evictions_total_ += 1;
+    blocking_eviction_time_us_total_ += elapsed_us;
+    blocking_eviction_time_us_max_ = std::max(blocking_eviction_time_us_max_, elapsed_us);
+    ray::stats::PlasmaEvictionLatency().Record(elapsed_us,
+                                               {{ray::stats::ValueTypeKey, "blocking"}});
     // Return an error to the client if not enough space could be freed to
     // create the object.
     if (!success) {
@@ -202,10 +237,65 @@ uint8_t* PlasmaStore::AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE
   if (pointer != nullptr) {
     GetMallocMapinfo(pointer, fd, map_size, offset);
     RAY_CHECK(*fd != INVALID_FD);
+    ScheduleBackgroundEvictionIfNeeded();
+  } else {
+    // The memory may be held by pinned objects, which only spilling can free.
+    // The client retries once they have been written.
+    SpillObjectsIfNeeded(size);
   }
   return pointer;
 }
 
+void PlasmaStore::ScheduleBackgroundEvictionIfNeeded() {
+  if (!background_eviction_enabled_ || background_eviction_scheduled_ ||
+      PlasmaAllocator::Allocated() <
+          PlasmaAllocator::GetFootprintLimit() * eviction_high_watermark_) {
+    return;
+  }
+  background_eviction_scheduled_ = true;
+  io_context_.post([this]() {
+    background_eviction_scheduled_ = false;
+    EvictObjectsInBackground();
+  });
+}
+
+void PlasmaStore::EvictObjectsInBackground() {
+  const int64_t target = PlasmaAllocator::GetFootprintLimit() * eviction_low_watermark_;
+  const int64_t num_bytes_to_evict =
+      std::min(PlasmaAllocator::Allocated() - target,
+               RayConfig::instance().plasma_background_eviction_batch_bytes());
+  if (num_bytes_to_evict <= 0) {
+    return;
+  }
+  auto start = std::chrono::steady_clock::now();
+  std::vector<ObjectID> objects_to_evict;
+  int64_t num_bytes_evicted =
+      eviction_policy_.ChooseObjectsToEvict(num_bytes_to_evict, &objects_to_evict);
+  EvictObjects(objects_to_evict);
+  int64_t elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+  num_background_evictions_total_ += 1;
+  bytes_evicted_in_background_total_ += num_bytes_evicted;
+  background_eviction_time_us_total_ += elapsed_us;
+  background_eviction_time_us_max_ = std::max(background_eviction_time_us_max_, elapsed_us);
+  ray::stats::PlasmaEvictionLatency().Record(elapsed_us,
+                                             {{ray::stats::ValueTypeKey, "background"}});
+  ray::stats::PlasmaBytesEvictedInBackground().Record(num_bytes_evicted);
+  RAY_LOG(DEBUG) << "Evicted " << objects_to_evict.size() << " objects ("
+                 << num_bytes_evicted << " bytes) in the background in " << elapsed_us
+                 << "us";
+
+  if (!objects_to_evict.empty() && PlasmaAllocator::Allocated() > target) {
+    // Yield to client requests before evicting the next batch.
+    background_eviction_scheduled_ = true;
+    io_context_.post([this]() {
+      background_eviction_scheduled_ = false;
+      EvictObjectsInBackground();
+    });
+  }
+}
+
 #ifdef PLASMA_CUDA
 Status PlasmaStore::AllocateCudaMemory(
     int device_num, int64_t size, uint8_t** out_pointer,
@@ -481,6 +571,9 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
         // Change the state of the object back to PLASMA_EVICTED so some
         // other request can try again.
         entry->state = ObjectState::PLASMA_EVICTED;
+        // Report the object as not present, so that the client retries once
+        // memory has been freed, for example by spilling.
+        get_req->objects[object_id].data_size = -1;
       }
     } else {
       // Add a placeholder plasma object to the get request to indicate that the
@@ -496,11 +589,14 @@ void PlasmaStore::ProcessGetRequest(const std::shared_ptr<Client> &client,
     std::vector<std::shared_ptr<Buffer>> buffers;
     for (size_t i = 0; i < evicted_ids.size(); ++i) {
       RAY_CHECK(evicted_entries[i]->pointer != nullptr);
-      buffers.emplace_back(new arrow::MutableBuffer(evicted_entries[i]->pointer,
-                                                    evicted_entries[i]->data_size));
+      buffers.emplace_back(new arrow::MutableBuffer(
+          evicted_entries[i]->pointer,
+          evicted_entries[i]->data_size + evicted_entries[i]->metadata_size));
     }
     if (external_store_->Get(evicted_ids, buffers).ok()) {
       for (size_t i = 0; i < evicted_ids.size(); ++i) {
+        num_objects_restored_total_ += 1;
+        num_bytes_restored_total_ += buffers[i]->size();
         evicted_entries[i]->state = ObjectState::PLASMA_SEALED;
         evicted_entries[i]->construct_duration =
             std::time(nullptr) - evicted_entries[i]->create_time;
@@ -565,12 +661,18 @@ int PlasmaStore::RemoveFromClientObjectIds(const ObjectID& object_id,
 void PlasmaStore::EraseFromObjectTable(const ObjectID& object_id) {
   auto& object = store_info_.objects[object_id];
   auto buff_size = object->data_size + object->metadata_size;
-  if (object->device_num == 0) {
-    PlasmaAllocator::Free(object->pointer, buff_size);
-  } else {
+  // Evicted objects have no memory allocated for them.
+  if (object->pointer != nullptr) {
+    if (object->device_num == 0) {
+      PlasmaAllocator::Free(object->pointer, buff_size);
+    } else {
 #ifdef PLASMA_CUDA
-    RAY_CHECK_OK(FreeCudaMemory(object->device_num, buff_size, object->pointer));
+      RAY_CHECK_OK(FreeCudaMemory(object->device_num, buff_size, object->pointer));
 #endif
+    }
+  }
+  if (spilled_objects_.erase(object_id) > 0) {
+    RAY_CHECK_OK(external_store_->Delete({object_id}));
   }
   store_info_.objects.erase(object_id);
 }
@@ -582,6 +684,56 @@ void PlasmaStore::ReleaseObject(const ObjectID& object_id, const std::shared_ptr
   RAY_CHECK(RemoveFromClientObjectIds(object_id, entry, client) == 1);
 }
 
+void PlasmaStore::PinObjects(const std::vector<ObjectID>& object_ids) {
+  for (const auto& object_id : object_ids) {
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    if (entry == nullptr || (entry->state != ObjectState::PLASMA_SEALED &&
+                             entry->state != ObjectState::PLASMA_EVICTED)) {
+      RAY_LOG(ERROR) << "Plasma object " << object_id
+                     << " was evicted before the raylet could pin it.";
+      continue;
+    }
+    if (entry->state == ObjectState::PLASMA_EVICTED ||
+        pinned_object_index_.count(object_id) > 0) {
+      // The object has been spilled already, or is pinned already.
+      continue;
+    }
+    if (entry->ref_count == 0) {
+      eviction_policy_.BeginObjectAccess(object_id);
+    }
+    entry->ref_count++;
+    pinned_object_index_[object_id] =
+        pinned_objects_.insert(pinned_objects_.end(), object_id);
+  }
+}
+
+void PlasmaStore::UnpinObjects(const std::vector<ObjectID>& object_ids) {
+  for (const auto& object_id : object_ids) {
+    if (pinned_object_index_.count(object_id) == 0) {
+      continue;
+    }
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    RAY_CHECK(entry != nullptr);
+    ReleasePin(object_id, entry);
+    if (entry->ref_count == 0) {
+      if (deletion_cache_.count(object_id) == 0) {
+        eviction_policy_.EndObjectAccess(object_id);
+      } else {
+        deletion_cache_.erase(object_id);
+        EvictObjects({object_id});
+      }
+    }
+  }
+}
+
+void PlasmaStore::ReleasePin(const ObjectID& object_id, ObjectTableEntry* entry) {
+  auto it = pinned_object_index_.find(object_id);
+  RAY_CHECK(it != pinned_object_index_.end());
+  pinned_objects_.erase(it->second);
+  pinned_object_index_.erase(it);
+  entry->ref_count--;
+}
+
 // Check if an object is present.
 ObjectStatus PlasmaStore::ContainsObject(const ObjectID& object_id) {
   auto entry = GetObjectTableEntry(&store_info_, object_id);
@@ -616,6 +768,8 @@ void PlasmaStore::SealObjects(const std::vector<ObjectID>& object_ids) {
   for (size_t i = 0; i < object_ids.size(); ++i) {
     UpdateObjectGetRequests(object_ids[i]);
   }
+
+  SpillObjectsIfNeeded();
 }
 
 int PlasmaStore::AbortObject(const ObjectID& object_id, const std::shared_ptr<Client> &client) {
@@ -646,6 +800,17 @@ PlasmaError PlasmaStore::DeleteObject(ObjectID& object_id) {
     return PlasmaError::ObjectNonexistent;
   }
 
+  if (entry->state == ObjectState::PLASMA_EVICTED) {
+    // The object only exists in the external store, so there is nothing else
+    // that could be using it.
+    EraseFromObjectTable(object_id);
+    ObjectInfoT notification;
+    notification.object_id = object_id.Binary();
+    notification.is_deletion = true;
+    PushNotification(&notification);
+    return PlasmaError::OK;
+  }
+
   if (entry->state != ObjectState::PLASMA_SEALED) {
     // To delete an object it must have been sealed.
     // Put it into deletion cache, it will be deleted later.
@@ -676,6 +841,7 @@ void PlasmaStore::EvictObjects(const std::vector<ObjectID>& object_ids) {
     return;
   }
 
+  std::vector<ObjectID> evicted_object_ids;
   std::vector<std::shared_ptr<arrow::Buffer>> evicted_object_data;
   std::vector<ObjectTableEntry*> evicted_entries;
   for (const auto& object_id : object_ids) {
@@ -694,8 +860,13 @@ void PlasmaStore::EvictObjects(const std::vector<ObjectID>& object_ids) {
     // external store, free the object data pointer and keep a placeholder
     // entry in ObjectTable
     if (external_store_) {
-      evicted_object_data.push_back(std::make_shared<arrow::Buffer>(
-          entry->pointer, entry->data_size + entry->metadata_size));
+      // Objects that were already spilled in the background do not need to be
+      // written again.
+      if (spilled_objects_.count(object_id) == 0) {
+        evicted_object_ids.push_back(object_id);
+        evicted_object_data.push_back(std::make_shared<arrow::Buffer>(
+            entry->pointer, entry->data_size + entry->metadata_size));
+      }
       evicted_entries.push_back(entry);
     } else {
       // If there is no backing external store, just erase the object entry
@@ -710,7 +881,10 @@ void PlasmaStore::EvictObjects(const std::vector<ObjectID>& object_ids) {
   }
 
   if (external_store_ && !object_ids.empty()) {
-    RAY_CHECK_OK(external_store_->Put(object_ids, evicted_object_data));
+    if (!evicted_object_ids.empty()) {
+      RAY_CHECK_OK(external_store_->Put(evicted_object_ids, evicted_object_data));
+      spilled_objects_.insert(evicted_object_ids.begin(), evicted_object_ids.end());
+    }
     for (auto entry : evicted_entries) {
       PlasmaAllocator::Free(entry->pointer, entry->data_size + entry->metadata_size);
       entry->pointer = nullptr;
@@ -719,6 +893,151 @@ void PlasmaStore::EvictObjects(const std::vector<ObjectID>& object_ids) {
   }
 }
 
+void PlasmaStore::SpillObjectsIfNeeded(int64_t num_bytes_required) {
+  if (!external_store_ || num_bytes_spilling_ > 0) {
+    // Only one batch is written at a time, so that the batch can be chosen
+    // with an up-to-date view of memory usage.
+    return;
+  }
+  const int64_t limit = PlasmaAllocator::GetFootprintLimit();
+  const int64_t allocated = PlasmaAllocator::Allocated();
+  if (allocated < limit * spill_high_watermark_ && num_bytes_required == 0) {
+    return;
+  }
+  int64_t num_bytes_to_spill =
+      std::max(num_bytes_required,
+               std::min(allocated - static_cast<int64_t>(limit * spill_low_watermark_),
+                        RayConfig::instance().object_spilling_max_batch_bytes()));
+  std::vector<ObjectID> candidates;
+  eviction_policy_.ChooseObjectsToEvict(num_bytes_to_spill, &candidates);
+  int64_t num_bytes_chosen = 0;
+  for (const auto& object_id : candidates) {
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    num_bytes_chosen += entry->data_size + entry->metadata_size;
+  }
+  // Objects that are not in use may not free enough memory, since the raylet
+  // pins the primary copy of every object. Spill the oldest pinned objects
+  // that nobody else is using too.
+  for (const auto& object_id : pinned_objects_) {
+    if (num_bytes_chosen >= num_bytes_to_spill) {
+      break;
+    }
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    if (entry->ref_count == 1) {
+      candidates.push_back(object_id);
+      num_bytes_chosen += entry->data_size + entry->metadata_size;
+    }
+  }
+
+  std::vector<ObjectID> objects_to_evict;
+  std::vector<ObjectID> objects_to_spill;
+  std::vector<std::shared_ptr<arrow::Buffer>> data;
+  for (const auto& object_id : candidates) {
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    RAY_CHECK(entry != nullptr && entry->state == ObjectState::PLASMA_SEALED);
+    if (spilled_objects_.count(object_id) > 0) {
+      // There is already a copy in the external store, so the memory can be
+      // freed right away.
+      if (pinned_object_index_.count(object_id) > 0) {
+        ReleasePin(object_id, entry);
+        eviction_policy_.EndObjectAccess(object_id);
+        eviction_policy_.RemoveObject(object_id);
+      }
+      objects_to_evict.push_back(object_id);
+      continue;
+    }
+    // Pin the object so that it is not evicted or deleted while it is being
+    // written. It is unpinned in OnObjectsSpilled.
+    if (entry->ref_count == 0) {
+      eviction_policy_.BeginObjectAccess(object_id);
+    }
+    entry->ref_count++;
+    objects_to_spill.push_back(object_id);
+    data.push_back(std::make_shared<arrow::Buffer>(
+        entry->pointer, entry->data_size + entry->metadata_size));
+    num_bytes_spilling_ += entry->data_size + entry->metadata_size;
+  }
+  EvictObjects(objects_to_evict);
+  if (objects_to_spill.empty()) {
+    return;
+  }
+
+  RAY_LOG(DEBUG) << "Spilling " << objects_to_spill.size() << " objects ("
+                 << num_bytes_spilling_ << " bytes), " << allocated
+                 << " bytes are in use";
+  spill_service_.post([this, objects_to_spill, data]() {
+    Status status = external_store_->Put(objects_to_spill, data);
+    io_context_.post(
+        [this, objects_to_spill, status]() { OnObjectsSpilled(objects_to_spill, status); });
+  });
+}
+
+void PlasmaStore::OnObjectsSpilled(const std::vector<ObjectID>& object_ids,
+                                   const Status& status) {
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to spill " << object_ids.size()
+                     << " objects: " << status.ToString();
+  }
+  std::vector<ObjectID> objects_to_evict;
+  for (const auto& object_id : object_ids) {
+    auto entry = GetObjectTableEntry(&store_info_, object_id);
+    RAY_CHECK(entry != nullptr);
+    const int64_t size = entry->data_size + entry->metadata_size;
+    num_bytes_spilling_ -= size;
+    if (status.ok()) {
+      spilled_objects_.insert(object_id);
+      num_objects_spilled_total_ += 1;
+      num_bytes_spilled_total_ += size;
+    }
+    entry->ref_count--;
+    if (status.ok() && entry->ref_count == 1 &&
+        pinned_object_index_.count(object_id) > 0) {
+      // Only the raylet's pin is left. It now refers to the copy in the
+      // external store, so the memory can be freed.
+      ReleasePin(object_id, entry);
+    }
+    if (entry->ref_count == 0) {
+      eviction_policy_.EndObjectAccess(object_id);
+      // Free the object's memory now that it has a copy in the external store.
+      // If a client started using the object while it was being written, it
+      // stays in memory and is evicted later without being written again.
+      if (status.ok() || deletion_cache_.count(object_id) > 0) {
+        deletion_cache_.erase(object_id);
+        eviction_policy_.RemoveObject(object_id);
+        objects_to_evict.push_back(object_id);
+      }
+    }
+  }
+  RAY_CHECK(num_bytes_spilling_ == 0);
+  EvictObjects(objects_to_evict);
+  // Keep spilling if objects were created faster than they could be written.
+  SpillObjectsIfNeeded();
+}
+
+std::string PlasmaStore::DebugString() const {
+  std::stringstream result;
+  result << eviction_policy_.DebugString();
+  result << "\nnum blocking evictions: " << num_blocking_evictions_total_;
+  result << "\nblocking eviction time us (total): " << blocking_eviction_time_us_total_;
+  result << "\nblocking eviction time us (max): " << blocking_eviction_time_us_max_;
+  if (background_eviction_enabled_) {
+    result << "\nnum background evictions: " << num_background_evictions_total_;
+    result << "\nbytes evicted in background: " << bytes_evicted_in_background_total_;
+    result << "\nbackground eviction time us (total): "
+           << background_eviction_time_us_total_;
+    result << "\nbackground eviction time us (max): "
+           << background_eviction_time_us_max_;
+  }
+  if (external_store_) {
+    result << "\nnum objects spilled: " << num_objects_spilled_total_;
+    result << "\nbytes spilled: " << num_bytes_spilled_total_;
+    result << "\nnum objects restored: " << num_objects_restored_total_;
+    result << "\nbytes restored: " << num_bytes_restored_total_;
+    result << "\nbytes being spilled: " << num_bytes_spilling_;
+  }
+  return result.str();
+}
+
 void PlasmaStore::ConnectClient(const boost::system::error_code &error) {
   if (!error) {
     // Accept a new local client and dispatch it to the node manager.
@@ -764,6 +1083,71 @@ void PlasmaStore::DisconnectClient(const std::shared_ptr<Client> &client) {
     // Remove notification for this client from global map.
     notification_clients_.erase(client);
   }
+
+#ifndef _WIN32
+  client->channel_doorbell.reset();
+#endif
+  client->channel.reset();
+}
+
+int64_t PlasmaStore::CreateChannel(const std::shared_ptr<Client> &client) {
+  const int64_t capacity = RayConfig::instance().plasma_channel_capacity();
+  if (capacity <= 0 || client->channel || !PlasmaChannel::IsSupported()) {
+    return 0;
+  }
+  Status status = PlasmaChannel::Create(capacity, &client->channel);
+  if (!status.ok()) {
+    RAY_LOG(WARNING) << "Failed to create a shared memory channel for client " << client
+                     << ", falling back to the socket: " << status.ToString();
+    return 0;
+  }
+#ifndef _WIN32
+  client->channel_doorbell.reset(new boost::asio::posix::stream_descriptor(
+      io_context_, dup(client->channel->doorbell_fd())));
+#endif
+  return capacity;
+}
+
+void PlasmaStore::WaitForChannelDoorbell(const std::shared_ptr<Client> &client) {
+#ifndef _WIN32
+  std::weak_ptr<Client> weak_client = client;
+  client->channel_doorbell->async_read_some(
+      boost::asio::buffer(&client->channel_doorbell_value,
+                          sizeof(client->channel_doorbell_value)),
+      [this, weak_client](const boost::system::error_code &error, size_t) {
+        auto client = weak_client.lock();
+        // The channel is closed when the client disconnects.
+        if (error || !client || !client->channel) {
+          return;
+        }
+        ProcessChannelRequests(client);
+        // Ask to be woken up for the next request, then handle any request
+        // that was posted without ringing the doorbell before that.
+        client->channel->ArmDoorbell();
+        ProcessChannelRequests(client);
+        WaitForChannelDoorbell(client);
+      });
+#endif
+}
+
+void PlasmaStore::ProcessChannelRequests(const std::shared_ptr<Client> &client) {
+  ChannelMessage request;
+  while (client->channel->PopRequest(&request)) {
+    const ObjectID object_id = ObjectID::FromBinary(std::string(
+        reinterpret_cast<const char*>(request.object_id), sizeof(request.object_id)));
+    switch (static_cast<fb::MessageType>(request.type)) {
+      case fb::MessageType::PlasmaReleaseRequest:
+        ReleaseObject(object_id, client);
+        break;
+      case fb::MessageType::PlasmaContainsRequest:
+        client->channel->PushReply(
+            request, ContainsObject(object_id) == ObjectStatus::OBJECT_FOUND ? 1 : 0);
+        break;
+      default:
+        RAY_LOG(WARNING) << "Ignoring request of type " << request.type
+                         << " on the channel of client " << client;
+    }
+  }
 }
 
 /// Send notifications about sealed objects to the subscribers. This is called
@@ -855,6 +1239,12 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
   ObjectID object_id;
   PlasmaObject object = {};
 
+  // Handle the requests that the client sent over its channel before this
+  // message first, so that all requests are handled in order.
+  if (client->channel) {
+    ProcessChannelRequests(client);
+  }
+
   // Process the different types of requests.
   switch (type) {
     case fb::MessageType::PlasmaCreateRequest: {
@@ -875,6 +1265,38 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
         RAY_RETURN_NOT_OK(client->SendFd(object.store_fd));
       }
     } break;
+    case fb::MessageType::PlasmaCreateBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      bool evict_if_full;
+      std::vector<int64_t> data_sizes;
+      std::vector<int64_t> metadata_sizes;
+      RAY_RETURN_NOT_OK(ReadCreateBatchRequest(input, input_size, &object_ids,
+                                               &evict_if_full, &data_sizes,
+                                               &metadata_sizes));
+      std::vector<PlasmaObject> objects(object_ids.size());
+      std::vector<PlasmaError> error_codes;
+      error_codes.reserve(object_ids.size());
+      // Like for Get replies, each file descriptor is only sent once.
+      std::unordered_set<MEMFD_TYPE> fds_to_send;
+      std::vector<MEMFD_TYPE> store_fds;
+      std::vector<int64_t> mmap_sizes;
+      for (size_t i = 0; i < object_ids.size(); i++) {
+        PlasmaError error_code =
+            CreateObject(object_ids[i], evict_if_full, data_sizes[i], metadata_sizes[i],
+                         /*device_num=*/0, client, &objects[i]);
+        error_codes.push_back(error_code);
+        if (error_code == PlasmaError::OK &&
+            fds_to_send.insert(objects[i].store_fd).second) {
+          store_fds.push_back(objects[i].store_fd);
+          mmap_sizes.push_back(GetMmapSize(objects[i].store_fd));
+        }
+      }
+      RAY_RETURN_NOT_OK(SendCreateBatchReply(client, object_ids, objects, error_codes,
+                                             store_fds, mmap_sizes));
+      for (MEMFD_TYPE store_fd : store_fds) {
+        RAY_RETURN_NOT_OK(client->SendFd(store_fd));
+      }
+    } break;
     case fb::MessageType::PlasmaAbortRequest: {
       RAY_RETURN_NOT_OK(ReadAbortRequest(input, input_size, &object_id));
       RAY_CHECK(AbortObject(object_id, client) == 1) << "To abort an object, the only "
@@ -892,6 +1314,13 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
       RAY_RETURN_NOT_OK(ReadReleaseRequest(input, input_size, &object_id));
       ReleaseObject(object_id, client);
     } break;
+    case fb::MessageType::PlasmaReleaseBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      RAY_RETURN_NOT_OK(ReadReleaseBatchRequest(input, input_size, &object_ids));
+      for (const auto& id : object_ids) {
+        ReleaseObject(id, client);
+      }
+    } break;
     case fb::MessageType::PlasmaDeleteRequest: {
       std::vector<ObjectID> object_ids;
       std::vector<PlasmaError> error_codes;
@@ -915,6 +1344,13 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
       SealObjects({object_id});
       RAY_RETURN_NOT_OK(SendSealReply(client, object_id, PlasmaError::OK));
     } break;
+    case fb::MessageType::PlasmaSealBatchRequest: {
+      std::vector<ObjectID> object_ids;
+      RAY_RETURN_NOT_OK(ReadSealBatchRequest(input, input_size, &object_ids));
+      SealObjects(object_ids);
+      RAY_RETURN_NOT_OK(SendSealBatchReply(
+          client, object_ids, std::vector<PlasmaError>(object_ids.size(), PlasmaError::OK)));
+    } break;
     case fb::MessageType::PlasmaEvictRequest: {
       // This code path should only be used for testing.
       int64_t num_bytes;
@@ -935,7 +1371,14 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
       SubscribeToUpdates(client);
       break;
     case fb::MessageType::PlasmaConnectRequest: {
-      RAY_RETURN_NOT_OK(SendConnectReply(client, PlasmaAllocator::GetFootprintLimit()));
+      const int64_t channel_capacity = CreateChannel(client);
+      RAY_RETURN_NOT_OK(SendConnectReply(client, PlasmaAllocator::GetFootprintLimit(),
+                                         channel_capacity));
+      if (channel_capacity > 0) {
+        RAY_RETURN_NOT_OK(client->SendFd(client->channel->memory_fd()));
+        RAY_RETURN_NOT_OK(client->SendFd(client->channel->doorbell_fd()));
+        WaitForChannelDoorbell(client);
+      }
     } break;
     case fb::MessageType::PlasmaDisconnectClient:
       RAY_LOG(DEBUG) << "Disconnecting client on fd " << client;
@@ -953,7 +1396,7 @@ Status PlasmaStore::ProcessMessage(const std::shared_ptr<Client> &client,
                                                             : PlasmaError::OutOfMemory));
     } break;
     case fb::MessageType::PlasmaGetDebugStringRequest: {
-      RAY_RETURN_NOT_OK(SendGetDebugStringReply(client, eviction_policy_.DebugString()));
+      RAY_RETURN_NOT_OK(SendGetDebugStringReply(client, DebugString()));
     } break;
     default:
       // This code should be unreachable.
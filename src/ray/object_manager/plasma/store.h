@@ -18,8 +18,10 @@
 #pragma once
 
 #include <deque>
+#include <list>
 #include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -150,6 +152,21 @@ class PlasmaStore {
   /// \param client The client making this request.
   void ReleaseObject(const ObjectID& object_id, const std::shared_ptr<Client> &client);
 
+  /// Pin the primary copies of objects on behalf of the raylet, so that they
+  /// are not evicted. If there is an external store, pinned objects may still be
+  /// spilled: once an object has been written, its pin moves to the copy in the
+  /// external store and its memory is freed. That copy is kept until the object
+  /// is deleted. Objects that are not sealed are skipped.
+  ///
+  /// \param object_ids The objects to pin.
+  void PinObjects(const std::vector<ObjectID>& object_ids);
+
+  /// Release pins taken with PinObjects. Objects that are not pinned, for
+  /// example because they have been spilled, are skipped.
+  ///
+  /// \param object_ids The objects to unpin.
+  void UnpinObjects(const std::vector<ObjectID>& object_ids);
+
   /// Subscribe a file descriptor to updates about new sealed objects.
   ///
   /// \param client The client making this request.
@@ -168,9 +185,18 @@ class PlasmaStore {
   void SendNotifications(
     const std::shared_ptr<Client> &client, const std::vector<ObjectInfoT> &object_info);
 
+  /// Handle all of the requests that a client has posted to its shared memory
+  /// channel.
+  ///
+  /// \param client The client whose requests to handle.
+  void ProcessChannelRequests(const std::shared_ptr<Client> &client);
+
   Status ProcessMessage(const std::shared_ptr<Client> &client, plasma::flatbuf::MessageType type,
                         const std::vector<uint8_t> &message);
 
+  /// Return a summary of the eviction policy and spilling state.
+  std::string DebugString() const;
+
   void SetNotificationListener(
       const std::shared_ptr<ray::ObjectStoreNotificationManager> &notification_listener) {
     notification_listener_ = notification_listener;
@@ -215,6 +241,38 @@ class PlasmaStore {
 
   void EraseFromObjectTable(const ObjectID& object_id);
 
+  /// Schedule background eviction if it is enabled and the memory in use is
+  /// above the eviction high watermark.
+  void ScheduleBackgroundEvictionIfNeeded();
+
+  /// Evict one batch of objects towards the eviction low watermark, and
+  /// schedule the next batch if the low watermark has not been reached yet.
+  void EvictObjectsInBackground();
+
+  /// Spill objects to the external store in the background if the memory in
+  /// use is above the spilling high watermark. Objects are chosen by the
+  /// eviction policy first, then from the primary copies pinned by the raylet,
+  /// oldest pin first. They are held until the write completes, at which point
+  /// their memory is freed.
+  ///
+  /// \param num_bytes_required If positive, spill at least this many bytes even
+  /// if the memory in use is below the high watermark, because an allocation of
+  /// this size failed.
+  void SpillObjectsIfNeeded(int64_t num_bytes_required = 0);
+
+  /// Drop the raylet's pin of an object.
+  ///
+  /// \param object_id The pinned object.
+  /// \param entry The object's table entry.
+  void ReleasePin(const ObjectID& object_id, ObjectTableEntry* entry);
+
+  /// Called on the main thread once a batch of objects has been written to
+  /// the external store.
+  ///
+  /// \param object_ids The objects that were spilled.
+  /// \param status The result of writing the objects.
+  void OnObjectsSpilled(const std::vector<ObjectID>& object_ids, const Status& status);
+
   uint8_t* AllocateMemory(size_t size, bool evict_if_full, MEMFD_TYPE* fd, int64_t* map_size,
                           ptrdiff_t* offset, const std::shared_ptr<Client> &client, bool is_create);
 #ifdef PLASMA_CUDA
@@ -227,6 +285,19 @@ class PlasmaStore {
   // Start listening for clients.
   void DoAccept();
 
+  /// Create the shared memory channel for a client, if it is enabled.
+  ///
+  /// \param client The client to create the channel for.
+  /// \return The number of messages in each ring of the channel, or 0 if no
+  /// channel was created.
+  int64_t CreateChannel(const std::shared_ptr<Client> &client);
+
+  /// Wait for the client to ring the doorbell of its channel, then handle
+  /// its requests.
+  ///
+  /// \param client The client whose doorbell to wait for.
+  void WaitForChannelDoorbell(const std::shared_ptr<Client> &client);
+
   // A reference to the asio io context.
   boost::asio::io_service& io_context_;
   /// The name of the socket this object store listens on.
@@ -249,9 +320,49 @@ class PlasmaStore {
 
   std::unordered_set<ObjectID> deletion_cache_;
 
+  /// Whether objects are evicted in the background between the eviction
+  /// watermarks. This is disabled when objects are spilled instead.
+  bool background_eviction_enabled_;
+  /// Fractions of the memory limit that start and stop background eviction.
+  float eviction_high_watermark_;
+  float eviction_low_watermark_;
+  /// Whether a background eviction step is queued on the event loop.
+  bool background_eviction_scheduled_ = false;
+  /// Eviction statistics for the debug string. Times are in microseconds.
+  /// Each eviction is also recorded in the plasma eviction metrics.
+  int64_t num_background_evictions_total_ = 0;
+  int64_t bytes_evicted_in_background_total_ = 0;
+  int64_t background_eviction_time_us_total_ = 0;
+  int64_t background_eviction_time_us_max_ = 0;
+  int64_t num_blocking_evictions_total_ = 0;
+  int64_t blocking_eviction_time_us_total_ = 0;
+  int64_t blocking_eviction_time_us_max_ = 0;
+
   /// Manages worker threads for handling asynchronous/multi-threaded requests
   /// for reading/writing data to/from external store.
   std::shared_ptr<ExternalStore> external_store_;
+  /// The objects that have a copy in the external store. These do not need to
+  /// be written again when they are evicted.
+  std::unordered_set<ObjectID> spilled_objects_;
+  /// The primary copies pinned by the raylet, oldest pin first. Each pin holds
+  /// a reference to the object.
+  std::list<ObjectID> pinned_objects_;
+  std::unordered_map<ObjectID, std::list<ObjectID>::iterator> pinned_object_index_;
+  /// The number of bytes currently being written to the external store.
+  int64_t num_bytes_spilling_ = 0;
+  /// Fractions of the memory limit that start and stop background spilling.
+  float spill_high_watermark_;
+  float spill_low_watermark_;
+  /// Spill statistics for the debug string.
+  int64_t num_objects_spilled_total_ = 0;
+  int64_t num_bytes_spilled_total_ = 0;
+  int64_t num_objects_restored_total_ = 0;
+  int64_t num_bytes_restored_total_ = 0;
+  /// The event loop and thread that objects are written to the external store
+  /// on, so that large writes do not block the store's main loop.
+  boost::asio::io_service spill_service_;
+  std::unique_ptr<boost::asio::io_service::work> spill_work_;
+  std::thread spill_thread_;
 #ifdef PLASMA_CUDA
   arrow::cuda::CudaDeviceManager* manager_;
 #endif
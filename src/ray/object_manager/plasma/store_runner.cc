@@ -123,6 +123,22 @@ void PlasmaStoreRunner::Stop() {
   main_service_.stop();
 }
 
+void PlasmaStoreRunner::PinObjects(const std::vector<ObjectID> &object_ids) {
+  main_service_.post([this, object_ids]() {
+    if (store_) {
+      store_->PinObjects(object_ids);
+    }
+  });
+}
+
+void PlasmaStoreRunner::UnpinObjects(const std::vector<ObjectID> &object_ids) {
+  main_service_.post([this, object_ids]() {
+    if (store_) {
+      store_->UnpinObjects(object_ids);
+    }
+  });
+}
+
 void PlasmaStoreRunner::Shutdown() {
   absl::MutexLock lock(&store_runner_mutex_);
   if (store_) {
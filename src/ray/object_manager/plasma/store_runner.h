@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include <boost/asio.hpp>
 
@@ -21,6 +22,12 @@ class PlasmaStoreRunner {
       const std::shared_ptr<ray::ObjectStoreNotificationManager> &notification_listener) {
     store_->SetNotificationListener(notification_listener);
   }
+  /// Pin objects on behalf of the raylet so that they are not evicted. The
+  /// pins are taken on the store thread, so they may not be held yet when
+  /// this returns.
+  void PinObjects(const std::vector<ObjectID> &object_ids);
+  /// Release pins taken by PinObjects.
+  void UnpinObjects(const std::vector<ObjectID> &object_ids);
 
  private:
   void Shutdown();
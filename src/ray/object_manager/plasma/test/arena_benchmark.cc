@@ -0,0 +1,102 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how long it takes to set up the plasma store's memory and how fast
+// the first objects can be written to it, for the arena options in
+// ray_config_def.h. The allocator is global, so each configuration has to be
+// measured in a separate process, e.g.
+//
+//   arena_benchmark 4096
+//   arena_benchmark 4096 plasma_prefault_memory=1
+//   arena_benchmark 4096 plasma_prefault_memory=1 plasma_transparent_huge_pages=1
+//   arena_benchmark 4096 plasma_prefault_memory=1 plasma_numa_policy=interleave
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/plasma/plasma.h"
+#include "ray/object_manager/plasma/plasma_allocator.h"
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0] << " <memory in MB> [<config>=<value> ...]"
+              << std::endl;
+    return 1;
+  }
+  const int64_t memory = std::stoll(argv[1]) * 1024 * 1024;
+  std::unordered_map<std::string, std::string> config;
+  for (int i = 2; i < argc; i++) {
+    std::string arg = argv[i];
+    auto pos = arg.find('=');
+    config[arg.substr(0, pos)] = pos == std::string::npos ? "1" : arg.substr(pos + 1);
+  }
+  RayConfig::instance().initialize(config);
+
+  plasma::PlasmaStoreInfo store_info;
+#ifdef __linux__
+  store_info.directory = "/dev/shm";
+#else
+  store_info.directory = "/tmp";
+#endif
+  store_info.hugepages_enabled = false;
+  plasma::plasma_config = &store_info;
+  plasma::PlasmaAllocator::SetFootprintLimit(memory);
+
+  // Map the arena the same way the store does at startup.
+  auto start = Clock::now();
+  const int64_t arena_size = memory - 256 * sizeof(size_t);
+  void *arena = plasma::PlasmaAllocator::Memalign(plasma::kBlockSize, arena_size);
+  if (arena == nullptr) {
+    std::cerr << "Failed to allocate " << memory << " bytes" << std::endl;
+    return 1;
+  }
+  plasma::PlasmaAllocator::Free(arena, arena_size);
+  const double startup_seconds = SecondsSince(start);
+
+  // Fill 90% of the store with 1 MB objects, like the first tasks on a fresh
+  // node would. The second pass writes to memory that has already been
+  // faulted in, for comparison.
+  const int64_t object_size = 1024 * 1024;
+  const int64_t num_objects = memory * 9 / 10 / object_size;
+  std::vector<double> throughputs;
+  for (int pass = 0; pass < 2; pass++) {
+    std::vector<void *> objects;
+    start = Clock::now();
+    for (int64_t i = 0; i < num_objects; i++) {
+      void *object = plasma::PlasmaAllocator::Memalign(plasma::kBlockSize, object_size);
+      std::memset(object, static_cast<int>(i), object_size);
+      objects.push_back(object);
+    }
+    throughputs.push_back(num_objects * object_size / SecondsSince(start) / 1e9);
+    for (void *object : objects) {
+      plasma::PlasmaAllocator::Free(object, object_size);
+    }
+  }
+
+  std::cout << "startup time: " << startup_seconds << "s" << std::endl;
+  std::cout << "first fill throughput: " << throughputs[0] << " GB/s" << std::endl;
+  std::cout << "second fill throughput: " << throughputs[1] << " GB/s" << std::endl;
+  return 0;
+}
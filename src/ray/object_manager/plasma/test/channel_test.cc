@@ -0,0 +1,142 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/channel.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "ray/object_manager/plasma/plasma_generated.h"
+#include "ray/util/logging.h"
+
+namespace plasma {
+
+const int64_t kRelease = static_cast<int64_t>(flatbuf::MessageType::PlasmaReleaseRequest);
+const int64_t kContains =
+    static_cast<int64_t>(flatbuf::MessageType::PlasmaContainsRequest);
+
+/// A store and a client end of the same channel. The client maps the channel
+/// a second time, the same way it would in another process.
+class ChannelTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    if (!PlasmaChannel::IsSupported()) {
+      GTEST_SKIP();
+    }
+    ASSERT_TRUE(PlasmaChannel::Create(4, &store_).ok());
+    ASSERT_TRUE(PlasmaChannel::Open(dup(store_->memory_fd()), dup(store_->doorbell_fd()),
+                                    &client_)
+                    .ok());
+    // Let the test check whether the doorbell was rung without blocking.
+    fcntl(store_->doorbell_fd(), F_SETFL, O_NONBLOCK);
+  }
+
+  bool DoorbellRung() {
+    uint64_t value;
+    return read(store_->doorbell_fd(), &value, sizeof(value)) == sizeof(value);
+  }
+
+  ObjectID PopObjectId() {
+    ChannelMessage request;
+    EXPECT_TRUE(store_->PopRequest(&request));
+    return ObjectID::FromBinary(std::string(reinterpret_cast<char *>(request.object_id),
+                                            sizeof(request.object_id)));
+  }
+
+  std::unique_ptr<PlasmaChannel> store_;
+  std::unique_ptr<PlasmaChannel> client_;
+};
+
+TEST_F(ChannelTest, RequestsArriveInOrder) {
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3; i++) {
+    object_ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(client_->Post(kRelease, object_ids.back()));
+  }
+  for (const auto &object_id : object_ids) {
+    ASSERT_EQ(PopObjectId(), object_id);
+  }
+  ChannelMessage request;
+  ASSERT_FALSE(store_->PopRequest(&request));
+}
+
+TEST_F(ChannelTest, PostFailsWhenFull) {
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(client_->Post(kRelease, ObjectID::FromRandom()));
+  }
+  ASSERT_FALSE(client_->Post(kRelease, ObjectID::FromRandom()));
+  PopObjectId();
+  ASSERT_TRUE(client_->Post(kRelease, ObjectID::FromRandom()));
+}
+
+TEST_F(ChannelTest, DoorbellIsOnlyRungWhenArmed) {
+  ASSERT_FALSE(DoorbellRung());
+  ASSERT_TRUE(client_->Post(kRelease, ObjectID::FromRandom()));
+  ASSERT_TRUE(DoorbellRung());
+  // The store has not asked to be woken up again yet.
+  ASSERT_TRUE(client_->Post(kRelease, ObjectID::FromRandom()));
+  ASSERT_FALSE(DoorbellRung());
+  store_->ArmDoorbell();
+  ASSERT_TRUE(client_->Post(kRelease, ObjectID::FromRandom()));
+  ASSERT_TRUE(DoorbellRung());
+}
+
+TEST_F(ChannelTest, CallReturnsReply) {
+  const int num_calls = 10000;
+  std::atomic<bool> done(false);
+  std::thread store_thread([this, &done]() {
+    ChannelMessage request;
+    while (!done) {
+      if (store_->PopRequest(&request)) {
+        store_->PushReply(request, request.object_id[0]);
+      }
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_calls; i++) {
+    const ObjectID object_id = ObjectID::FromRandom();
+    int64_t result;
+    ASSERT_TRUE(
+        client_->Call(kContains, object_id, []() { return true; }, &result).ok());
+    ASSERT_EQ(result, object_id.Data()[0]);
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  RAY_LOG(INFO) << "Round trip latency: "
+                << std::chrono::duration<double, std::micro>(elapsed).count() / num_calls
+                << "us";
+
+  done = true;
+  store_thread.join();
+}
+
+TEST_F(ChannelTest, CallFailsWhenStoreIsGone) {
+  int64_t result;
+  auto status = client_->Call(kContains, ObjectID::FromRandom(),
+                              []() { return false; }, &result);
+  ASSERT_TRUE(status.IsIOError());
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
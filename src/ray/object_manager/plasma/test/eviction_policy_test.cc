@@ -0,0 +1,270 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/eviction_policy.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+/// Replays a trace of plasma store events against an eviction policy and
+/// counts how often an accessed object was still in memory. Each line of a
+/// trace is one of:
+///
+///   create <name> <size>
+///   begin <name>
+///   end <name>
+///   delete <name>
+///
+/// Beginning to access an object that was evicted counts as a miss, and the
+/// object is fetched again the same way the store restores evicted objects.
+class TraceReplayer {
+ public:
+  TraceReplayer(const std::string &policy, int64_t capacity)
+      : capacity_(capacity), policy_(&store_info_, capacity, policy) {}
+
+  void Create(const std::string &name, int64_t size) {
+    const ObjectID object_id = ObjectID::FromRandom();
+    ids_[name] = object_id;
+    sizes_[object_id] = size;
+    AddObject(object_id, /*is_create=*/true);
+  }
+
+  void Begin(const std::string &name) {
+    const ObjectID &object_id = ids_.at(name);
+    num_accesses_++;
+    if (store_info_.objects.count(object_id) > 0) {
+      num_hits_++;
+    } else {
+      AddObject(object_id, /*is_create=*/false);
+    }
+    policy_.BeginObjectAccess(object_id);
+  }
+
+  void End(const std::string &name) { policy_.EndObjectAccess(ids_.at(name)); }
+
+  void Delete(const std::string &name) {
+    const ObjectID object_id = ids_.at(name);
+    if (store_info_.objects.count(object_id) > 0) {
+      policy_.RemoveObject(object_id);
+      RemoveObject(object_id);
+    }
+    ids_.erase(name);
+    sizes_.erase(object_id);
+  }
+
+  void Replay(std::istream &trace) {
+    std::string line;
+    while (std::getline(trace, line)) {
+      std::istringstream tokens(line);
+      std::string event, name;
+      int64_t size;
+      tokens >> event >> name;
+      if (event == "create") {
+        tokens >> size;
+        Create(name, size);
+      } else if (event == "begin") {
+        Begin(name);
+      } else if (event == "end") {
+        End(name);
+      } else if (event == "delete") {
+        Delete(name);
+      }
+    }
+  }
+
+  double HitRate() const {
+    return num_accesses_ == 0 ? 0 : static_cast<double>(num_hits_) / num_accesses_;
+  }
+
+  bool Contains(const std::string &name) const {
+    return store_info_.objects.count(ids_.at(name)) > 0;
+  }
+
+ private:
+  void AddObject(const ObjectID &object_id, bool is_create) {
+    const int64_t size = sizes_[object_id];
+    if (used_ + size > capacity_) {
+      std::vector<ObjectID> objects_to_evict;
+      policy_.ChooseObjectsToEvict(used_ + size - capacity_, &objects_to_evict);
+      for (const auto &evicted_id : objects_to_evict) {
+        RemoveObject(evicted_id);
+      }
+    }
+    auto entry = std::unique_ptr<ObjectTableEntry>(new ObjectTableEntry());
+    entry->data_size = size;
+    entry->metadata_size = 0;
+    store_info_.objects.emplace(object_id, std::move(entry));
+    used_ += size;
+    policy_.ObjectCreated(object_id, nullptr, is_create);
+  }
+
+  void RemoveObject(const ObjectID &object_id) {
+    used_ -= sizes_[object_id];
+    store_info_.objects.erase(object_id);
+  }
+
+  const int64_t capacity_;
+  PlasmaStoreInfo store_info_;
+  EvictionPolicy policy_;
+  std::unordered_map<std::string, ObjectID> ids_;
+  std::unordered_map<ObjectID, int64_t> sizes_;
+  int64_t used_ = 0;
+  int64_t num_accesses_ = 0;
+  int64_t num_hits_ = 0;
+};
+
+const std::vector<std::string> kPolicies = {"lru", "gdsf", "lfuda", "cost_aware"};
+
+/// A large object that is read repeatedly while bursts of small objects that
+/// are read once are created.
+std::string MixedWorkloadTrace() {
+  std::stringstream trace;
+  trace << "create large 50\n";
+  for (int i = 0; i < 20; i++) {
+    trace << "begin large\nend large\n";
+    for (int j = 0; j < 6; j++) {
+      std::string name = "small-" + std::to_string(i) + "-" + std::to_string(j);
+      trace << "create " << name << " 10\n";
+      trace << "begin " << name << "\nend " << name << "\n";
+    }
+  }
+  return trace.str();
+}
+
+TEST(EvictionPolicyTest, LRUEvictsLeastRecentlyUsed) {
+  TraceReplayer replayer("lru", 30);
+  replayer.Create("a", 10);
+  replayer.Create("b", 10);
+  replayer.Create("c", 10);
+  replayer.Begin("a");
+  replayer.End("a");
+  replayer.Create("d", 10);
+  ASSERT_TRUE(replayer.Contains("a"));
+  ASSERT_FALSE(replayer.Contains("b"));
+  ASSERT_TRUE(replayer.Contains("c"));
+  ASSERT_TRUE(replayer.Contains("d"));
+}
+
+TEST(EvictionPolicyTest, GDSFEvictsLargeObjectsFirst) {
+  TraceReplayer replayer("gdsf", 40);
+  replayer.Create("small", 10);
+  replayer.Create("large", 30);
+  replayer.Create("new", 10);
+  ASSERT_TRUE(replayer.Contains("small"));
+  ASSERT_FALSE(replayer.Contains("large"));
+  ASSERT_TRUE(replayer.Contains("new"));
+}
+
+TEST(EvictionPolicyTest, LFUDAAgesOutOldObjects) {
+  TraceReplayer replayer("lfuda", 20);
+  replayer.Create("old", 10);
+  for (int i = 0; i < 3; i++) {
+    replayer.Begin("old");
+    replayer.End("old");
+  }
+  // Each new object evicts the previous one and raises the inflation value,
+  // until new objects outrank the formerly popular one.
+  for (int i = 0; i < 5; i++) {
+    replayer.Create("new-" + std::to_string(i), 10);
+  }
+  ASSERT_FALSE(replayer.Contains("old"));
+  ASSERT_TRUE(replayer.Contains("new-4"));
+}
+
+TEST(EvictionPolicyTest, CostAwareKeepsRefetchedObjects) {
+  TraceReplayer replayer("cost_aware", 20);
+  replayer.Create("expensive", 10);
+  replayer.Create("other", 10);
+  replayer.Create("filler", 10);
+  // The expensive object was evicted and has to be fetched again.
+  ASSERT_FALSE(replayer.Contains("expensive"));
+  replayer.Begin("expensive");
+  replayer.End("expensive");
+  replayer.Create("new", 10);
+  ASSERT_TRUE(replayer.Contains("expensive"));
+  ASSERT_TRUE(replayer.Contains("new"));
+}
+
+TEST(EvictionPolicyTest, CostAwareAccountsForSize) {
+  const int64_t unit = kObjectFetchOverheadBytes;
+  TraceReplayer replayer("cost_aware", 5 * unit);
+  replayer.Create("small", unit);
+  replayer.Create("large", 4 * unit);
+  // Both objects were accessed once, but the large one is cheaper to fetch
+  // again per byte, so it is evicted first even though it is newer.
+  replayer.Create("new", unit);
+  ASSERT_TRUE(replayer.Contains("small"));
+  ASSERT_FALSE(replayer.Contains("large"));
+
+  // Once the large object had to be fetched again, it outranks the small
+  // objects that were not.
+  replayer.Begin("large");
+  replayer.End("large");
+  ASSERT_FALSE(replayer.Contains("small"));
+  replayer.Create("newer", unit);
+  ASSERT_TRUE(replayer.Contains("large"));
+  ASSERT_FALSE(replayer.Contains("new"));
+}
+
+TEST(EvictionPolicyTest, RegisterPolicy) {
+  ObjectCaches::Register("test", [](const std::string &name, int64_t capacity) {
+    return std::unique_ptr<ObjectCache>(new LRUCache(name, capacity));
+  });
+  auto cache = ObjectCaches::Create("test", "test cache", 100);
+  ASSERT_EQ(cache->Capacity(), 100);
+}
+
+TEST(EvictionPolicyTest, MixedWorkloadHitRate) {
+  std::unordered_map<std::string, double> hit_rates;
+  for (const auto &policy : kPolicies) {
+    TraceReplayer replayer(policy, 100);
+    std::istringstream trace(MixedWorkloadTrace());
+    replayer.Replay(trace);
+    hit_rates[policy] = replayer.HitRate();
+    RAY_LOG(INFO) << policy << " hit rate: " << hit_rates[policy];
+  }
+  ASSERT_GT(hit_rates["lfuda"], hit_rates["lru"]);
+  ASSERT_GT(hit_rates["cost_aware"], hit_rates["lru"]);
+}
+
+/// Compare the policies on a recorded trace, given by the
+/// PLASMA_EVICTION_TRACE and PLASMA_EVICTION_TRACE_CAPACITY environment
+/// variables.
+TEST(EvictionPolicyTest, ReplayRecordedTrace) {
+  const char *path = std::getenv("PLASMA_EVICTION_TRACE");
+  const char *capacity = std::getenv("PLASMA_EVICTION_TRACE_CAPACITY");
+  if (path == nullptr || capacity == nullptr) {
+    return;
+  }
+  for (const auto &policy : kPolicies) {
+    TraceReplayer replayer(policy, std::stoll(capacity));
+    std::ifstream trace(path);
+    ASSERT_TRUE(trace.good()) << path;
+    replayer.Replay(trace);
+    RAY_LOG(INFO) << policy << " hit rate: " << replayer.HitRate();
+  }
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/file_system_store.h"
+
+#include <sys/stat.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/util/filesystem.h"
+
+namespace plasma {
+
+class FileSystemStoreTest : public ::testing::Test {
+ public:
+  FileSystemStoreTest()
+      : directory_(ray::JoinPaths(ray::GetUserTempDir(),
+                                  "plasma-spill-test-" + ObjectID::FromRandom().Hex())) {
+  }
+
+  void SetUp() override {
+    store_.reset(new FileSystemStore());
+    ASSERT_TRUE(store_->Connect("file://" + directory_).ok());
+  }
+
+  void TearDown() override {
+    // Destroying the store removes its remaining spill files.
+    store_.reset();
+    rmdir(directory_.c_str());
+  }
+
+ protected:
+  /// Spill the given objects in a single batch.
+  Status Put(const std::vector<ObjectID> &ids, const std::vector<std::string> &data) {
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    for (const auto &value : data) {
+      buffers.push_back(std::make_shared<Buffer>(
+          reinterpret_cast<const uint8_t *>(value.data()), value.size()));
+    }
+    return store_->Put(ids, buffers);
+  }
+
+  /// Restore an object of the given size, or return the empty string if the
+  /// object could not be restored.
+  std::string Get(const ObjectID &id, size_t size) {
+    std::string value(size, '\0');
+    std::vector<std::shared_ptr<Buffer>> buffers = {std::make_shared<Buffer>(
+        reinterpret_cast<const uint8_t *>(value.data()), value.size())};
+    if (!store_->Get({id}, buffers).ok()) {
+      return "";
+    }
+    return value;
+  }
+
+  /// Return the number of spill files in the directory.
+  int NumSpillFiles() {
+    int num_files = 0;
+    struct stat info;
+    for (int i = 0; i < 16; i++) {
+      const std::string path =
+          ray::JoinPaths(directory_, "plasma-spill-" + std::to_string(i));
+      if (stat(path.c_str(), &info) == 0) {
+        num_files++;
+      }
+    }
+    return num_files;
+  }
+
+  std::string directory_;
+  std::unique_ptr<FileSystemStore> store_;
+};
+
+TEST(FileSystemStoreConnectTest, TestMalformedEndpoint) {
+  FileSystemStore store;
+  ASSERT_FALSE(store.Connect("file://").ok());
+  ASSERT_FALSE(store.Connect("s3://bucket").ok());
+}
+
+TEST_F(FileSystemStoreTest, TestPutGet) {
+  const ObjectID a = ObjectID::FromRandom();
+  const ObjectID b = ObjectID::FromRandom();
+  ASSERT_TRUE(Put({a, b}, {"hello", "world!"}).ok());
+  // Objects spilled together share a file.
+  ASSERT_EQ(NumSpillFiles(), 1);
+  ASSERT_EQ(Get(b, 6), "world!");
+  ASSERT_EQ(Get(a, 5), "hello");
+}
+
+TEST_F(FileSystemStoreTest, TestGetUnknownObject) {
+  ASSERT_TRUE(Put({ObjectID::FromRandom()}, {"hello"}).ok());
+  std::string value(5, '\0');
+  std::vector<std::shared_ptr<Buffer>> buffers = {std::make_shared<Buffer>(
+      reinterpret_cast<const uint8_t *>(value.data()), value.size())};
+  ASSERT_TRUE(store_->Get({ObjectID::FromRandom()}, buffers).IsObjectNotFound());
+}
+
+TEST_F(FileSystemStoreTest, TestMultipleBatches) {
+  std::vector<ObjectID> ids;
+  for (int i = 0; i < 3; i++) {
+    ids.push_back(ObjectID::FromRandom());
+    ASSERT_TRUE(Put({ids.back()}, {"batch" + std::to_string(i)}).ok());
+  }
+  ASSERT_EQ(NumSpillFiles(), 3);
+  for (int i = 2; i >= 0; i--) {
+    ASSERT_EQ(Get(ids[i], 6), "batch" + std::to_string(i));
+  }
+}
+
+TEST_F(FileSystemStoreTest, TestRespill) {
+  const ObjectID a = ObjectID::FromRandom();
+  ASSERT_TRUE(Put({a}, {"first"}).ok());
+  ASSERT_TRUE(Put({a}, {"again"}).ok());
+  // Only the newest copy is kept.
+  ASSERT_EQ(NumSpillFiles(), 1);
+  ASSERT_EQ(Get(a, 5), "again");
+}
+
+TEST_F(FileSystemStoreTest, TestDelete) {
+  const ObjectID a = ObjectID::FromRandom();
+  const ObjectID b = ObjectID::FromRandom();
+  ASSERT_TRUE(Put({a, b}, {"hello", "world"}).ok());
+  // The file is kept until every object in it has been deleted.
+  ASSERT_TRUE(store_->Delete({a}).ok());
+  ASSERT_EQ(NumSpillFiles(), 1);
+  ASSERT_EQ(Get(a, 5), "");
+  ASSERT_EQ(Get(b, 5), "world");
+  ASSERT_TRUE(store_->Delete({b}).ok());
+  ASSERT_EQ(NumSpillFiles(), 0);
+  // Deleting an object that is not spilled is a no-op.
+  ASSERT_TRUE(store_->Delete({a}).ok());
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,59 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/plasma/malloc.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace plasma {
+
+TEST(ParseNumaNodeListTest, TestNodesAndRanges) {
+  std::vector<unsigned long> mask;
+  ASSERT_TRUE(ParseNumaNodeList("0", &mask));
+  ASSERT_EQ(mask, std::vector<unsigned long>({0x1}));
+
+  mask.clear();
+  ASSERT_TRUE(ParseNumaNodeList("0-1,3", &mask));
+  ASSERT_EQ(mask, std::vector<unsigned long>({0xb}));
+
+  mask.clear();
+  ASSERT_TRUE(ParseNumaNodeList("2-2", &mask));
+  ASSERT_EQ(mask, std::vector<unsigned long>({0x4}));
+}
+
+TEST(ParseNumaNodeListTest, TestNodesAcrossWords) {
+  constexpr int kBitsPerWord = 8 * sizeof(unsigned long);
+  std::vector<unsigned long> mask;
+  ASSERT_TRUE(ParseNumaNodeList("1," + std::to_string(kBitsPerWord + 2), &mask));
+  ASSERT_EQ(mask, std::vector<unsigned long>({0x2, 0x4}));
+}
+
+TEST(ParseNumaNodeListTest, TestMalformedEntries) {
+  for (const std::string list :
+       {"", ",", "0,", ",0", "0,,1", "a", "0a", "0-", "-1", "1-0", "0-1-2", "0:1",
+        " 0", "0 ", "1024", "99999999999"}) {
+    std::vector<unsigned long> mask;
+    ASSERT_FALSE(ParseNumaNodeList(list, &mask)) << "\"" << list << "\"";
+  }
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
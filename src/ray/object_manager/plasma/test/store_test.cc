@@ -0,0 +1,202 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/common/ray_config.h"
+#include "ray/object_manager/plasma/client.h"
+#include "ray/object_manager/plasma/store_runner.h"
+#include "ray/stats/stats.h"
+#include "ray/util/filesystem.h"
+
+namespace plasma {
+
+constexpr int64_t kStoreMemory = 10 * 1024 * 1024;
+constexpr int64_t kObjectSize = 1024 * 1024;
+
+class PlasmaStoreTest : public ::testing::Test {
+ public:
+  PlasmaStoreTest() {
+    socket_name_ = ray::JoinPaths(ray::GetUserTempDir(),
+                                  "plasma-store-test-" + ObjectID::FromRandom().Hex());
+  }
+
+  void TearDown() override {
+    RAY_CHECK_OK(client_.Disconnect());
+    plasma_store_runner->Stop();
+    store_thread_.join();
+    plasma_store_runner.reset();
+  }
+
+ protected:
+  /// Start the store and connect the client to it.
+  void StartStore(const std::string &external_store_endpoint) {
+    plasma_store_runner.reset(new PlasmaStoreRunner(socket_name_, kStoreMemory,
+                                                    /*hugepages_enabled=*/false,
+                                                    /*plasma_directory=*/"",
+                                                    external_store_endpoint));
+    store_thread_ = std::thread(&PlasmaStoreRunner::Start, plasma_store_runner.get());
+    ASSERT_TRUE(client_.Connect(socket_name_, "", 0, /*num_retries=*/50).ok());
+  }
+
+  /// Create and seal an object filled with the given byte, retrying while the
+  /// store is full.
+  Status CreateAndSeal(const ObjectID &object_id, uint8_t value) {
+    std::shared_ptr<Buffer> data;
+    Status status;
+    for (int i = 0; i < 100; i++) {
+      status = client_.Create(object_id, kObjectSize, nullptr, 0, &data);
+      if (!status.IsObjectStoreFull()) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    RAY_RETURN_NOT_OK(status);
+    memset(data->mutable_data(), value, kObjectSize);
+    RAY_RETURN_NOT_OK(client_.Seal(object_id));
+    return client_.Release(object_id);
+  }
+
+  /// Get an object, retrying while the store is too full to restore it.
+  Status Get(const ObjectID &object_id, std::vector<ObjectBuffer> *results) {
+    for (int i = 0; i < 100; i++) {
+      RAY_RETURN_NOT_OK(client_.Get({object_id}, /*timeout_ms=*/0, results));
+      if ((*results)[0].data != nullptr) {
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return Status::OK();
+  }
+
+  std::string socket_name_;
+  std::thread store_thread_;
+  PlasmaClient client_;
+};
+
+class PlasmaStoreSpillTest : public PlasmaStoreTest {
+ public:
+  PlasmaStoreSpillTest() {
+    directory_ = ray::JoinPaths(ray::GetUserTempDir(),
+                                "plasma-spill-test-" + ObjectID::FromRandom().Hex());
+  }
+
+  void SetUp() override { StartStore("file://" + directory_); }
+
+  void TearDown() override {
+    PlasmaStoreTest::TearDown();
+    rmdir(directory_.c_str());
+  }
+
+ protected:
+  std::string directory_;
+};
+
+TEST_F(PlasmaStoreSpillTest, TestSpillPinnedObjects) {
+  // Create and pin three times as many objects as fit in the store. Pinned
+  // objects cannot be evicted, so every create after the store fills up only
+  // succeeds once pinned objects have been spilled.
+  std::vector<ObjectID> object_ids;
+  for (int i = 0; i < 3 * kStoreMemory / kObjectSize; i++) {
+    const ObjectID object_id = ObjectID::FromRandom();
+    ASSERT_TRUE(CreateAndSeal(object_id, static_cast<uint8_t>(i)).ok());
+    plasma_store_runner->PinObjects({object_id});
+    object_ids.push_back(object_id);
+  }
+
+  // Every object is restored with the bytes that it was created with.
+  for (size_t i = 0; i < object_ids.size(); i++) {
+    std::vector<ObjectBuffer> results;
+    ASSERT_TRUE(Get(object_ids[i], &results).ok());
+    ASSERT_NE(results[0].data, nullptr);
+    ASSERT_EQ(results[0].data->size(), kObjectSize);
+    const std::string expected(kObjectSize, static_cast<char>(i));
+    ASSERT_EQ(memcmp(results[0].data->data(), expected.data(), kObjectSize), 0);
+  }
+  plasma_store_runner->UnpinObjects(object_ids);
+}
+
+class PlasmaStoreEvictionTest : public PlasmaStoreTest {
+ public:
+  void SetUp() override {
+    // Stats are initialized once for all tests, so that the metric views stay
+    // registered. Metrics are told apart by their tags.
+    ray::stats::StatsConfig::instance().SetReportInterval(absl::Milliseconds(100));
+    ray::stats::StatsConfig::instance().SetHarvestInterval(absl::Milliseconds(50));
+    ray::stats::Init({}, /*metrics_agent_port=*/10054,
+                     std::make_shared<ray::stats::StdoutExporterClient>());
+  }
+
+  void TearDown() override {
+    PlasmaStoreTest::TearDown();
+    RayConfig::instance().initialize({{"plasma_background_eviction_enabled", "false"}});
+  }
+
+ protected:
+  /// Return the number of evictions of the given type that have been recorded
+  /// in the eviction latency metric, waiting until there is at least one.
+  int64_t NumEvictionsRecorded(const std::string &type) {
+    for (int i = 0; i < 50; i++) {
+      for (const auto &view : opencensus::stats::StatsExporter::GetViewData()) {
+        if (view.first.name() != "plasma_eviction_latency") {
+          continue;
+        }
+        for (const auto &row : view.second.distribution_data()) {
+          for (size_t j = 0; j < view.first.columns().size(); j++) {
+            if (view.first.columns()[j].name() == "ValueType" && row.first[j] == type) {
+              return row.second.count();
+            }
+          }
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    return 0;
+  }
+};
+
+TEST_F(PlasmaStoreEvictionTest, TestBlockingEvictionMetrics) {
+  StartStore("");
+  for (int i = 0; i < 2 * kStoreMemory / kObjectSize; i++) {
+    ASSERT_TRUE(CreateAndSeal(ObjectID::FromRandom(), static_cast<uint8_t>(i)).ok());
+  }
+  // Once the store is full, every create has to evict objects first.
+  ASSERT_GT(NumEvictionsRecorded("blocking"), 0);
+}
+
+TEST_F(PlasmaStoreEvictionTest, TestBackgroundEvictionMetrics) {
+  RayConfig::instance().initialize({{"plasma_background_eviction_enabled", "true"}});
+  StartStore("");
+  for (int i = 0; i < kStoreMemory / kObjectSize; i++) {
+    ASSERT_TRUE(CreateAndSeal(ObjectID::FromRandom(), static_cast<uint8_t>(i)).ok());
+  }
+  // The store filled up past the high watermark, so objects were evicted in
+  // the background.
+  ASSERT_GT(NumEvictionsRecorded("background"), 0);
+}
+
+}  // namespace plasma
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,91 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/pull_chunk_tracker.h"
+
+#include <algorithm>
+
+namespace ray {
+
+bool PullChunkTracker::IsInFlight(const InFlight &request,
+                                  const std::vector<ClientID> &sources,
+                                  int64_t now_ms) const {
+  return request.deadline_ms > now_ms &&
+         std::find(sources.begin(), sources.end(), request.source) != sources.end();
+}
+
+std::vector<PullChunkTracker::Request> PullChunkTracker::NextRequests(
+    const std::vector<ClientID> &sources, size_t max_sources,
+    const std::vector<uint64_t> *missing_chunks, int64_t now_ms, int64_t deadline_ms) {
+  std::vector<Request> requests;
+  const size_t num_sources = std::min(sources.size(), std::max<size_t>(max_sources, 1));
+  if (num_sources == 0) {
+    return requests;
+  }
+
+  if (missing_chunks == nullptr) {
+    // The number of chunks is not known yet, so split the chunks by index
+    // modulo the number of sources.
+    if (stripes_.empty()) {
+      stripes_.resize(num_sources);
+    }
+    // Move the stripes that expired, or whose source is gone, to the sources
+    // in order. The number of stripes cannot change, since chunks from the
+    // first requests may still arrive.
+    size_t next_source = 0;
+    for (size_t i = 0; i < stripes_.size(); i++) {
+      if (IsInFlight(stripes_[i], sources, now_ms)) {
+        continue;
+      }
+      stripes_[i] = {sources[next_source++ % num_sources], deadline_ms};
+      Request request;
+      request.source = stripes_[i].source;
+      request.stripe_index = i;
+      request.num_stripes = stripes_.size();
+      requests.push_back(request);
+    }
+    return requests;
+  }
+
+  // A chunk that was not requested by index was requested as part of a stripe.
+  std::vector<uint64_t> chunks_to_request;
+  for (uint64_t chunk_index : *missing_chunks) {
+    auto it = chunks_.find(chunk_index);
+    if (it != chunks_.end()) {
+      if (IsInFlight(it->second, sources, now_ms)) {
+        continue;
+      }
+    } else if (!stripes_.empty() &&
+               IsInFlight(stripes_[chunk_index % stripes_.size()], sources, now_ms)) {
+      continue;
+    }
+    chunks_to_request.push_back(chunk_index);
+  }
+
+  // Spread the chunks across the sources, so that each source sends a
+  // disjoint subset of them.
+  const size_t num_requests = std::min(num_sources, chunks_to_request.size());
+  for (size_t i = 0; i < num_requests; i++) {
+    Request request;
+    request.source = sources[i];
+    for (size_t j = i; j < chunks_to_request.size(); j += num_requests) {
+      request.chunk_indices.push_back(chunks_to_request[j]);
+      chunks_[chunks_to_request[j]] = {sources[i], deadline_ms};
+    }
+    requests.push_back(request);
+  }
+  return requests;
+}
+
+}  // namespace ray
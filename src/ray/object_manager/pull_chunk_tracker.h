@@ -0,0 +1,75 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "ray/common/id.h"
+
+namespace ray {
+
+/// Decides which chunks of an object to request from which nodes, when the
+/// object is pulled from several nodes at once. It remembers which source each
+/// chunk was requested from and until when, so that a retry only requests the
+/// chunks whose request expired or whose source no longer has the object.
+class PullChunkTracker {
+ public:
+  /// A request for a part of an object.
+  struct Request {
+    /// The node to request the chunks from.
+    ClientID source;
+    /// If num_stripes > 0, the chunks whose index modulo num_stripes equals
+    /// stripe_index are requested. Otherwise, the chunks in chunk_indices.
+    uint64_t stripe_index = 0;
+    uint64_t num_stripes = 0;
+    std::vector<uint64_t> chunk_indices;
+  };
+
+  /// Choose the requests to send next, and record them as in flight.
+  ///
+  /// \param sources The nodes that have the object, in the order to use them.
+  /// \param max_sources The maximum number of nodes to request new stripes
+  /// or chunks from.
+  /// \param missing_chunks The chunks that have not been received yet, or
+  /// nullptr if no chunk has been received and the number of chunks is unknown.
+  /// \param now_ms The current time.
+  /// \param deadline_ms The time at which the returned requests expire.
+  /// \return The requests to send. Chunks that are still in flight from a
+  /// source in sources are not requested again.
+  std::vector<Request> NextRequests(const std::vector<ClientID> &sources,
+                                    size_t max_sources,
+                                    const std::vector<uint64_t> *missing_chunks,
+                                    int64_t now_ms, int64_t deadline_ms);
+
+ private:
+  struct InFlight {
+    ClientID source;
+    int64_t deadline_ms;
+  };
+
+  /// Whether a request is still expected to be served.
+  bool IsInFlight(const InFlight &request, const std::vector<ClientID> &sources,
+                  int64_t now_ms) const;
+
+  /// The stripes that were requested before the number of chunks was known,
+  /// indexed by stripe index.
+  std::vector<InFlight> stripes_;
+  /// The chunks that were requested by index.
+  std::unordered_map<uint64_t, InFlight> chunks_;
+};
+
+}  // namespace ray
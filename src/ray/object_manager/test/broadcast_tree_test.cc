@@ -0,0 +1,109 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ray/object_manager/object_manager.h"
+
+namespace ray {
+
+std::vector<ClientID> RandomClientIds(int num_clients) {
+  std::vector<ClientID> client_ids;
+  for (int i = 0; i < num_clients; i++) {
+    client_ids.push_back(ClientID::FromRandom());
+  }
+  return client_ids;
+}
+
+/// Send a chunk through the broadcast tree the way the holder and every
+/// receiver split it, and return the number of hops to each node.
+std::unordered_map<ClientID, int> Broadcast(const std::vector<ClientID> &client_ids,
+                                            int fan_out) {
+  std::unordered_map<ClientID, int> hops;
+  std::vector<std::pair<std::vector<ClientID>, int>> pending = {{client_ids, 0}};
+  while (!pending.empty()) {
+    auto forward_client_ids = pending.back().first;
+    int depth = pending.back().second;
+    pending.pop_back();
+    for (const auto &subtree : SplitBroadcastTree(forward_client_ids, fan_out)) {
+      // Every node receives the chunk exactly once.
+      EXPECT_EQ(hops.count(subtree.front()), 0);
+      hops[subtree.front()] = depth + 1;
+      pending.push_back(
+          {std::vector<ClientID>(subtree.begin() + 1, subtree.end()), depth + 1});
+    }
+  }
+  return hops;
+}
+
+TEST(BroadcastTreeTest, TestSplit) {
+  auto client_ids = RandomClientIds(5);
+  auto subtrees = SplitBroadcastTree(client_ids, 2);
+  ASSERT_EQ(subtrees.size(), 2);
+  // The subtrees are nearly equal in size and keep the order of the nodes.
+  ASSERT_EQ(subtrees[0],
+            std::vector<ClientID>(client_ids.begin(), client_ids.begin() + 2));
+  ASSERT_EQ(subtrees[1],
+            std::vector<ClientID>(client_ids.begin() + 2, client_ids.end()));
+
+  // There are never more subtrees than nodes.
+  subtrees = SplitBroadcastTree(client_ids, 8);
+  ASSERT_EQ(subtrees.size(), 5);
+  for (size_t i = 0; i < subtrees.size(); i++) {
+    ASSERT_EQ(subtrees[i], std::vector<ClientID>({client_ids[i]}));
+  }
+
+  // A fan-out below 1 is treated as a chain.
+  ASSERT_EQ(SplitBroadcastTree(client_ids, 0).size(), 1);
+  ASSERT_TRUE(SplitBroadcastTree({}, 2).empty());
+}
+
+TEST(BroadcastTreeTest, TestForwardingReachesEveryNode) {
+  for (int fan_out : {1, 2, 3}) {
+    for (int num_clients : {1, 2, 7, 15, 100}) {
+      auto client_ids = RandomClientIds(num_clients);
+      auto hops = Broadcast(client_ids, fan_out);
+      ASSERT_EQ(hops.size(), client_ids.size());
+      for (const auto &client_id : client_ids) {
+        ASSERT_EQ(hops.count(client_id), 1);
+      }
+    }
+  }
+}
+
+TEST(BroadcastTreeTest, TestForwardingDepth) {
+  auto client_ids = RandomClientIds(15);
+  auto max_hops = [](const std::unordered_map<ClientID, int> &hops) {
+    int max = 0;
+    for (const auto &entry : hops) {
+      max = std::max(max, entry.second);
+    }
+    return max;
+  };
+  // A fan-out of 1 gives a chain, and a larger fan-out a tree of logarithmic
+  // depth.
+  ASSERT_EQ(max_hops(Broadcast(client_ids, 1)), 15);
+  ASSERT_EQ(max_hops(Broadcast(client_ids, 2)), 4);
+  ASSERT_EQ(max_hops(Broadcast(client_ids, 4)), 2);
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
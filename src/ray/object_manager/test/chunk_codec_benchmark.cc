@@ -0,0 +1,161 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+// Measures how well and how fast object chunks compress with the codecs
+// supported by the object manager, for payloads that are typical for Ray
+// objects. Compression pays off when the network is slower than
+// "throughput * (1 - ratio)", e.g.
+//
+//   chunk_codec_benchmark zlib
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ray/object_manager/chunk_codec.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr size_t kChunkSize = 1000000;
+
+/// A pickled numpy array of random float64 values, which hardly compresses.
+std::vector<uint8_t> RandomFloats() {
+  std::mt19937_64 gen(0);
+  std::normal_distribution<double> distribution;
+  std::vector<uint8_t> chunk(kChunkSize);
+  for (size_t i = 0; i + sizeof(double) <= chunk.size(); i += sizeof(double)) {
+    double value = distribution(gen);
+    std::memcpy(&chunk[i], &value, sizeof(double));
+  }
+  return chunk;
+}
+
+/// A pickled numpy array of float32 image data with a limited value range.
+std::vector<uint8_t> ImageFloats() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> chunk(kChunkSize);
+  for (size_t i = 0; i + sizeof(float) <= chunk.size(); i += sizeof(float)) {
+    float value = distribution(gen) / 255.0f;
+    std::memcpy(&chunk[i], &value, sizeof(float));
+  }
+  return chunk;
+}
+
+/// An Arrow int64 column of sorted keys, e.g. timestamps.
+std::vector<uint8_t> ArrowSortedInts() {
+  std::vector<uint8_t> chunk(kChunkSize);
+  int64_t value = 1590000000000;
+  for (size_t i = 0; i + sizeof(int64_t) <= chunk.size(); i += sizeof(int64_t)) {
+    value += i % 7;
+    std::memcpy(&chunk[i], &value, sizeof(int64_t));
+  }
+  return chunk;
+}
+
+/// An Arrow dictionary-encoded column with a validity bitmap of mostly ones.
+std::vector<uint8_t> ArrowDictionary() {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> distribution(0, 15);
+  std::vector<uint8_t> chunk(kChunkSize, 0xff);
+  for (size_t i = kChunkSize / 8; i + sizeof(int32_t) <= chunk.size();
+       i += sizeof(int32_t)) {
+    int32_t index = distribution(gen);
+    std::memcpy(&chunk[i], &index, sizeof(int32_t));
+  }
+  return chunk;
+}
+
+/// Text, e.g. a pickled list of log lines.
+std::vector<uint8_t> Text() {
+  const std::vector<std::string> words = {"error", "worker", "task", "object", "node",
+                                          "the",   "a",      "is",   "failed", "ok"};
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<size_t> distribution(0, words.size() - 1);
+  std::string text;
+  while (text.size() < kChunkSize) {
+    text += words[distribution(gen)];
+    text += distribution(gen) == 0 ? "\n" : " ";
+  }
+  return std::vector<uint8_t>(text.begin(), text.begin() + kChunkSize);
+}
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ray::rpc::CompressionCodec codec;
+  if (argc != 2 || !ray::ParseCompressionCodec(argv[1], &codec).ok() ||
+      codec == ray::rpc::NO_COMPRESSION) {
+    std::cerr << "Usage: " << argv[0] << " <codec>" << std::endl;
+    return 1;
+  }
+  const std::vector<std::pair<std::string, std::vector<uint8_t>>> payloads = {
+      {"numpy random float64", RandomFloats()},
+      {"numpy image float32", ImageFloats()},
+      {"arrow sorted int64", ArrowSortedInts()},
+      {"arrow dictionary", ArrowDictionary()},
+      {"text", Text()},
+  };
+  const int kIterations = 20;
+  for (const auto &payload : payloads) {
+    const auto &chunk = payload.second;
+    auto start = Clock::now();
+    bool compressible = false;
+    for (int i = 0; i < kIterations; i++) {
+      compressible = ray::IsCompressible(chunk.data(), chunk.size(), 0.8);
+    }
+    const double sample_seconds = SecondsSince(start) / kIterations;
+
+    std::string compressed;
+    start = Clock::now();
+    for (int i = 0; i < kIterations; i++) {
+      if (!ray::CompressChunk(codec, chunk.data(), chunk.size(), &compressed).ok()) {
+        std::cerr << "Failed to compress " << payload.first << std::endl;
+        return 1;
+      }
+    }
+    const double compress_seconds = SecondsSince(start) / kIterations;
+
+    std::vector<uint8_t> decompressed(chunk.size());
+    start = Clock::now();
+    for (int i = 0; i < kIterations; i++) {
+      if (!ray::DecompressChunk(codec, compressed, decompressed.data(),
+                                decompressed.size())
+               .ok()) {
+        std::cerr << "Failed to decompress " << payload.first << std::endl;
+        return 1;
+      }
+    }
+    const double decompress_seconds = SecondsSince(start) / kIterations;
+
+    std::cout << payload.first << ": ratio "
+              << static_cast<double>(compressed.size()) / chunk.size()
+              << ", sampled as " << (compressible ? "compressible" : "incompressible")
+              << " in " << sample_seconds * 1e6 << "us, compress "
+              << chunk.size() / compress_seconds / 1e6 << " MB/s, decompress "
+              << chunk.size() / decompress_seconds / 1e6 << " MB/s" << std::endl;
+  }
+  return 0;
+}
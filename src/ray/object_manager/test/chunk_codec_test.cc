@@ -0,0 +1,96 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/chunk_codec.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+std::vector<uint8_t> TextChunk(size_t size) {
+  const std::string words = "the quick brown fox jumps over the lazy dog ";
+  std::vector<uint8_t> chunk(size);
+  for (size_t i = 0; i < size; i++) {
+    chunk[i] = words[i % words.size()];
+  }
+  return chunk;
+}
+
+std::vector<uint8_t> RandomChunk(size_t size) {
+  std::mt19937 gen(0);
+  std::vector<uint8_t> chunk(size);
+  for (auto &byte : chunk) {
+    byte = static_cast<uint8_t>(gen());
+  }
+  return chunk;
+}
+
+TEST(ChunkCodecTest, ParseCodec) {
+  rpc::CompressionCodec codec;
+  ASSERT_TRUE(ParseCompressionCodec("", &codec).ok());
+  ASSERT_EQ(codec, rpc::NO_COMPRESSION);
+  ASSERT_TRUE(ParseCompressionCodec("zlib", &codec).ok());
+  ASSERT_EQ(codec, rpc::ZLIB);
+  ASSERT_TRUE(ParseCompressionCodec("lzma", &codec).IsInvalid());
+}
+
+TEST(ChunkCodecTest, RoundTrip) {
+  auto chunk = TextChunk(1000000);
+  std::string compressed;
+  ASSERT_TRUE(CompressChunk(rpc::ZLIB, chunk.data(), chunk.size(), &compressed).ok());
+  ASSERT_LT(compressed.size(), chunk.size() / 10);
+  std::vector<uint8_t> decompressed(chunk.size());
+  ASSERT_TRUE(DecompressChunk(rpc::ZLIB, compressed, decompressed.data(),
+                              decompressed.size())
+                  .ok());
+  ASSERT_EQ(chunk, decompressed);
+}
+
+TEST(ChunkCodecTest, DetectCompressibility) {
+  ASSERT_TRUE(IsCompressible(TextChunk(1000000).data(), 1000000, 0.8));
+  ASSERT_FALSE(IsCompressible(RandomChunk(1000000).data(), 1000000, 0.8));
+  // Chunks smaller than a sample are sampled as a whole.
+  ASSERT_TRUE(IsCompressible(TextChunk(100).data(), 100, 0.8));
+  ASSERT_FALSE(IsCompressible(nullptr, 0, 0.8));
+}
+
+TEST(ChunkCodecTest, RejectCorruptChunk) {
+  auto chunk = TextChunk(10000);
+  std::string compressed;
+  ASSERT_TRUE(CompressChunk(rpc::ZLIB, chunk.data(), chunk.size(), &compressed).ok());
+  std::vector<uint8_t> decompressed(chunk.size());
+  // The chunk is truncated.
+  ASSERT_TRUE(DecompressChunk(rpc::ZLIB, compressed.substr(0, compressed.size() / 2),
+                              decompressed.data(), decompressed.size())
+                  .IsIOError());
+  // The chunk decompresses to a different size than expected.
+  ASSERT_TRUE(DecompressChunk(rpc::ZLIB, compressed, decompressed.data(),
+                              decompressed.size() - 1)
+                  .IsIOError());
+  // Uncompressed chunks must have the expected size.
+  ASSERT_TRUE(DecompressChunk(rpc::NO_COMPRESSION, std::string(10, 'a'),
+                              decompressed.data(), 11)
+                  .IsIOError());
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
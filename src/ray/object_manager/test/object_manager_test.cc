@@ -186,6 +186,8 @@ class TestObjectManager : public TestObjectManagerBase {
 
   std::unique_ptr<boost::asio::deadline_timer> timer;
 
+  bool rest_of_object_pushed = false;
+
   void WaitConnections() {
     node_id_1 = gcs_client_1->Nodes().GetSelfId();
     node_id_2 = gcs_client_2->Nodes().GetSelfId();
@@ -419,7 +421,37 @@ class TestObjectManager : public TestObjectManagerBase {
         }));
   }
 
-  void TestWaitComplete() { main_service.stop(); }
+  void TestWaitComplete() { TestDeferredPartialPush(); }
+
+  /// Push some of the chunks of an object before the object is local. The push
+  /// waits for the object to be created, and must still send only those chunks.
+  void TestDeferredPartialPush() {
+    ObjectID object_id = ObjectID::FromRandom();
+    RAY_CHECK_OK(server2->object_manager_.SubscribeObjAdded(
+        [this, object_id](const object_manager::protocol::ObjectInfoT &object_info) {
+          if (ObjectID::FromBinary(object_info.object_id) == object_id) {
+            // The object is only complete once the other chunks were pushed.
+            ASSERT_TRUE(rest_of_object_pushed);
+            main_service.stop();
+          }
+        }));
+
+    server1->object_manager_.Push(
+        object_id, node_id_2, [](uint64_t chunk_index) { return chunk_index == 0; },
+        {});
+    WriteDataToClient(client1, 3 * object_chunk_size, object_id);
+
+    // Push the rest of the chunks once the first one had time to arrive. If the
+    // deferred push had sent the whole object, it would already be complete.
+    timer.reset(new boost::asio::deadline_timer(main_service));
+    timer->expires_from_now(boost::posix_time::milliseconds(500));
+    timer->async_wait([this, object_id](const boost::system::error_code &error) {
+      rest_of_object_pushed = true;
+      server1->object_manager_.Push(
+          object_id, node_id_2, [](uint64_t chunk_index) { return chunk_index != 0; },
+          {});
+    });
+  }
 
   void TestConnections() {
     RAY_LOG(DEBUG) << "\n"
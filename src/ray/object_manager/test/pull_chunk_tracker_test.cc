@@ -0,0 +1,130 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/object_manager/pull_chunk_tracker.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace ray {
+
+constexpr int64_t kTimeoutMs = 100;
+
+class PullChunkTrackerTest : public ::testing::Test {
+ public:
+  PullChunkTrackerTest() {
+    for (int i = 0; i < 6; i++) {
+      nodes_.push_back(ClientID::FromRandom());
+    }
+  }
+
+ protected:
+  std::vector<PullChunkTracker::Request> NextRequests(
+      const std::vector<ClientID> &sources,
+      const std::vector<uint64_t> *missing_chunks = nullptr) {
+    return tracker_.NextRequests(sources, /*max_sources=*/4, missing_chunks, now_ms_,
+                                 now_ms_ + kTimeoutMs);
+  }
+
+  PullChunkTracker tracker_;
+  std::vector<ClientID> nodes_;
+  int64_t now_ms_ = 0;
+};
+
+TEST_F(PullChunkTrackerTest, TestStripes) {
+  // Before the number of chunks is known, each source is asked for a stripe.
+  auto requests = NextRequests({nodes_[0], nodes_[1], nodes_[2]});
+  ASSERT_EQ(requests.size(), 3);
+  for (size_t i = 0; i < requests.size(); i++) {
+    ASSERT_EQ(requests[i].source, nodes_[i]);
+    ASSERT_EQ(requests[i].stripe_index, i);
+    ASSERT_EQ(requests[i].num_stripes, 3);
+    ASSERT_TRUE(requests[i].chunk_indices.empty());
+  }
+  // The stripes are in flight, so they are not requested again.
+  ASSERT_TRUE(NextRequests({nodes_[0], nodes_[1], nodes_[2]}).empty());
+}
+
+TEST_F(PullChunkTrackerTest, TestMaxSources) {
+  auto requests = NextRequests(nodes_);
+  ASSERT_EQ(requests.size(), 4);
+  for (size_t i = 0; i < requests.size(); i++) {
+    ASSERT_EQ(requests[i].source, nodes_[i]);
+    ASSERT_EQ(requests[i].num_stripes, 4);
+  }
+}
+
+TEST_F(PullChunkTrackerTest, TestRetryStripeOfFailedSource) {
+  ASSERT_EQ(NextRequests({nodes_[0], nodes_[1], nodes_[2]}).size(), 3);
+  // The second source no longer has the object, so only its stripe is
+  // requested again, from another source.
+  auto requests = NextRequests({nodes_[0], nodes_[2]});
+  ASSERT_EQ(requests.size(), 1);
+  ASSERT_EQ(requests[0].source, nodes_[0]);
+  ASSERT_EQ(requests[0].stripe_index, 1);
+  ASSERT_EQ(requests[0].num_stripes, 3);
+
+  // Once the requests expire, every stripe is requested again.
+  now_ms_ += kTimeoutMs;
+  ASSERT_EQ(NextRequests({nodes_[0], nodes_[2]}).size(), 3);
+}
+
+TEST_F(PullChunkTrackerTest, TestRetryExpiredChunks) {
+  ASSERT_EQ(NextRequests({nodes_[0], nodes_[1]}).size(), 2);
+  // The missing chunks were requested as part of the stripes and are still in
+  // flight.
+  std::vector<uint64_t> missing_chunks = {1, 2, 3, 4, 5};
+  ASSERT_TRUE(NextRequests({nodes_[0], nodes_[1]}, &missing_chunks).empty());
+
+  // After the stripe requests expire, only the missing chunks are requested,
+  // spread across the sources.
+  now_ms_ += kTimeoutMs;
+  auto requests = NextRequests({nodes_[0], nodes_[1]}, &missing_chunks);
+  ASSERT_EQ(requests.size(), 2);
+  ASSERT_EQ(requests[0].source, nodes_[0]);
+  ASSERT_EQ(requests[0].num_stripes, 0);
+  ASSERT_EQ(requests[0].chunk_indices, std::vector<uint64_t>({1, 3, 5}));
+  ASSERT_EQ(requests[1].source, nodes_[1]);
+  ASSERT_EQ(requests[1].chunk_indices, std::vector<uint64_t>({2, 4}));
+  ASSERT_TRUE(NextRequests({nodes_[0], nodes_[1]}, &missing_chunks).empty());
+
+  // Once some of them have arrived and the rest expire, only the rest are
+  // requested again.
+  now_ms_ += kTimeoutMs;
+  missing_chunks = {4};
+  requests = NextRequests({nodes_[0], nodes_[1]}, &missing_chunks);
+  ASSERT_EQ(requests.size(), 1);
+  ASSERT_EQ(requests[0].chunk_indices, std::vector<uint64_t>({4}));
+}
+
+TEST_F(PullChunkTrackerTest, TestRetryChunksOfFailedSource) {
+  std::vector<uint64_t> missing_chunks = {0, 1, 2, 3};
+  ASSERT_EQ(NextRequests({nodes_[0], nodes_[1]}, &missing_chunks).size(), 2);
+  // The chunks of the first source are requested again from a new source as
+  // soon as the first source no longer has the object.
+  auto requests = NextRequests({nodes_[1], nodes_[2]}, &missing_chunks);
+  ASSERT_EQ(requests.size(), 2);
+  ASSERT_EQ(requests[0].source, nodes_[1]);
+  ASSERT_EQ(requests[0].chunk_indices, std::vector<uint64_t>({0}));
+  ASSERT_EQ(requests[1].source, nodes_[2]);
+  ASSERT_EQ(requests[1].chunk_indices, std::vector<uint64_t>({2}));
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -203,6 +203,20 @@ int main(int argc, char *argv[]) {
         object_manager_config.object_store_memory = object_store_memory;
         object_manager_config.plasma_directory = plasma_directory;
         object_manager_config.huge_pages = huge_pages;
+        object_manager_config.max_chunks_in_flight_per_node =
+            RayConfig::instance().object_manager_max_chunks_in_flight_per_node();
+        object_manager_config.max_pull_sources =
+            RayConfig::instance().object_manager_max_pull_sources();
+        object_manager_config.broadcast_batch_ms =
+            RayConfig::instance().object_manager_broadcast_batch_ms();
+        object_manager_config.broadcast_fan_out =
+            RayConfig::instance().object_manager_broadcast_fan_out();
+        object_manager_config.compression_codec =
+            RayConfig::instance().object_manager_compression_codec();
+        object_manager_config.compression_min_ratio =
+            RayConfig::instance().object_manager_compression_min_ratio();
+        object_manager_config.object_spilling_directory =
+            RayConfig::instance().object_spilling_directory();
 
         int num_cpus = static_cast<int>(static_resource_conf["CPU"]);
         object_manager_config.rpc_service_threads_number =
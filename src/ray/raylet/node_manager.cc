@@ -23,6 +23,7 @@
 #include "ray/common/id.h"
 #include "ray/common/status.h"
 #include "ray/gcs/pb_util.h"
+#include "ray/object_manager/plasma/store_runner.h"
 #include "ray/raylet/format/node_manager_generated.h"
 #include "ray/stats/stats.h"
 #include "ray/util/sample.h"
@@ -165,9 +166,17 @@ NodeManager::NodeManager(boost::asio::io_service &io_service,
           io_service, config.num_initial_workers, config.maximum_startup_concurrency,
           config.min_worker_port, config.max_worker_port, gcs_client_,
           config.worker_commands, config.raylet_config,
+          /*fork_server_socket_name=*/
+          RayConfig::instance().worker_fork_server_enabled() &&
+                  !config.session_dir.empty()
+              ? config.session_dir + "/sockets/worker_fork_server_" +
+                    self_node_id.Hex().substr(0, 8)
+              : "",
           /*starting_worker_timeout_callback=*/
           [this]() { this->DispatchTasks(this->local_queues_.GetReadyTasksByClass()); }),
-      scheduling_policy_(local_queues_),
+      scheduling_policy_(local_queues_,
+                         RayConfig::instance().scheduler_spread_threshold(),
+                         RayConfig::instance().scheduler_spread_num_samples()),
       reconstruction_policy_(
           io_service_,
           [this](const TaskID &task_id, const ObjectID &required_object_id) {
@@ -482,6 +491,14 @@ void NodeManager::Heartbeat() {
     last_debug_dump_at_ms_ = now_ms;
   }
 
+  // Keep a buffer of idle workers sized from recent demand, and kill the
+  // prestarted workers that it no longer needs. The actual cleanup for these
+  // workers is done when we receive the DisconnectClient message from them.
+  for (const auto &worker : worker_pool_.MaintainIdleWorkers(now_ms)) {
+    worker->MarkDead();
+    KillWorker(worker);
+  }
+
   // Evict all copies of freed objects from the cluster.
   if (free_objects_period_ > 0 &&
       static_cast<int64_t>(now_ms - last_free_objects_at_ms_) > free_objects_period_) {
@@ -1608,12 +1625,11 @@ void NodeManager::ProcessWaitForDirectActorCallArgsRequestMessage(
       FlatbufferToObjectReference(*message->object_ids(), *message->owner_addresses());
   AsyncResolveObjects(client, refs, TaskID::Nil(), /*ray_get=*/false,
                       /*mark_worker_blocked*/ false);
-  // Reply to the client once a location has been found for all arguments.
-  // NOTE(swang): ObjectManager::Wait currently returns as soon as any location
-  // has been found, so the object may still be on a remote node when the
-  // client receives the reply.
+  // Reply to the client once all arguments are local. The actor waits for the
+  // arguments of its queued tasks ahead of time, so waiting until they are
+  // local lets the fetches overlap with the tasks ahead of them.
   ray::Status status = object_manager_.Wait(
-      object_ids, -1, object_ids.size(), false,
+      object_ids, -1, object_ids.size(), /*wait_local=*/true,
       [this, client, tag](std::vector<ObjectID> found, std::vector<ObjectID> remaining) {
         RAY_CHECK(remaining.empty());
         std::shared_ptr<WorkerInterface> worker =
@@ -1728,6 +1744,10 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
     RAY_CHECK_OK(gcs_client_->Tasks().AsyncAdd(data, nullptr));
   }
 
+  // Start workers for this task and the tasks that the owner has queued behind
+  // it, so that their lease requests do not each wait for a new worker process.
+  worker_pool_.PrestartWorkers(task.GetTaskSpecification(), request.backlog_size());
+
   if (new_scheduler_enabled_) {
     auto task_spec = task.GetTaskSpecification();
     cluster_task_manager_->QueueTask(task, reply, [send_reply_callback]() {
@@ -1794,6 +1814,14 @@ void NodeManager::HandleRequestWorkerLease(const rpc::RequestWorkerLeaseRequest
     reply->set_canceled(true);
     send_reply_callback(Status::OK(), nullptr, nullptr);
   });
+  if (request.arg_bytes_by_node_size() > 0) {
+    std::unordered_map<ClientID, int64_t> arg_bytes_by_node;
+    for (const auto &arg_bytes : request.arg_bytes_by_node()) {
+      arg_bytes_by_node[ClientID::FromBinary(arg_bytes.node_id())] +=
+          arg_bytes.num_bytes();
+    }
+    task.SetArgBytesByNode(std::move(arg_bytes_by_node));
+  }
   SubmitTask(task, Lineage());
 }
 
@@ -3511,13 +3539,26 @@ void NodeManager::HandlePinObjectIDs(const rpc::PinObjectIDsRequest &request,
     for (const auto &object_id_binary : request.object_ids()) {
       object_ids.push_back(ObjectID::FromBinary(object_id_binary));
     }
+    if (plasma::plasma_store_runner != nullptr &&
+        !RayConfig::instance().object_spilling_directory().empty()) {
+      // Let the store hold the pins, so that it can spill the objects and move
+      // the pins to the spilled copies when it runs out of memory. A null entry
+      // marks a pin held by the store.
+      plasma::plasma_store_runner->PinObjects(object_ids);
+      for (const auto &object_id : object_ids) {
+        RAY_LOG(DEBUG) << "Pinning object " << object_id;
+        pinned_objects_.emplace(object_id, nullptr);
+      }
+      object_ids.clear();
+    }
     std::vector<plasma::ObjectBuffer> plasma_results;
     // TODO(swang): This `Get` has a timeout of 0, so the plasma store will not
     // block when serving the request. However, if the plasma store is under
     // heavy load, then this request can still block the NodeManager event loop
     // since we must wait for the plasma store's reply. We should consider using
     // an `AsyncGet` instead.
-    if (!store_client_.Get(object_ids, /*timeout_ms=*/0, &plasma_results).ok()) {
+    if (!object_ids.empty() &&
+        !store_client_.Get(object_ids, /*timeout_ms=*/0, &plasma_results).ok()) {
       RAY_LOG(WARNING) << "Failed to get objects to be pinned from object store.";
       // TODO(suquark): Maybe "Status::ObjectNotFound" is more accurate here.
       send_reply_callback(Status::Invalid("Failed to get objects."), nullptr, nullptr);
@@ -3528,8 +3569,8 @@ void NodeManager::HandlePinObjectIDs(const rpc::PinObjectIDsRequest &request,
     // unpinned by responding to the WaitForObjectEviction message.
     // TODO(edoakes): we should be batching these requests instead of sending one per
     // pinned object.
-    for (int64_t i = 0; i < request.object_ids().size(); i++) {
-      ObjectID object_id = ObjectID::FromBinary(request.object_ids(i));
+    for (size_t i = 0; i < object_ids.size(); i++) {
+      const ObjectID &object_id = object_ids[i];
 
       if (plasma_results[i].data == nullptr) {
         RAY_LOG(ERROR) << "Plasma object " << object_id
@@ -3565,7 +3606,13 @@ void NodeManager::HandlePinObjectIDs(const rpc::PinObjectIDsRequest &request,
                              << object_id;
           }
           RAY_LOG(DEBUG) << "Unpinning object " << object_id;
-          pinned_objects_.erase(object_id);
+          auto pinned = pinned_objects_.find(object_id);
+          if (pinned != pinned_objects_.end()) {
+            if (pinned->second == nullptr && plasma::plasma_store_runner != nullptr) {
+              plasma::plasma_store_runner->UnpinObjects({object_id});
+            }
+            pinned_objects_.erase(pinned);
+          }
 
           // Try to evict all copies of the object from the cluster.
           if (free_objects_period_ >= 0) {
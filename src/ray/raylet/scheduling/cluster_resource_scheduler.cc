@@ -14,6 +14,8 @@
 
 #include "ray/raylet/scheduling/cluster_resource_scheduler.h"
 
+#include <algorithm>
+
 std::string VectorToString(const std::vector<FixedPoint> &vector) {
   std::stringstream buffer;
 
@@ -421,6 +423,79 @@ bool TaskResourceInstances::operator==(const TaskResourceInstances &other) {
   return true;
 }
 
+constexpr size_t PredefinedResourceTable::kBlockSize;
+
+void PredefinedResourceTable::AddOrUpdateNode(int64_t node_id,
+                                              const NodeResources &resources) {
+  auto it = node_slots_.find(node_id);
+  size_t slot;
+  if (it == node_slots_.end()) {
+    slot = node_ids_.size();
+    node_slots_.emplace(node_id, slot);
+    node_ids_.push_back(node_id);
+    if (slot == available_[0].size()) {
+      for (auto &column : available_) {
+        column.resize(slot + kBlockSize, 0);
+      }
+    }
+  } else {
+    slot = it->second;
+  }
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    available_[i][slot] = i < resources.predefined_resources.size()
+                              ? resources.predefined_resources[i].available.Raw()
+                              : 0;
+  }
+}
+
+void PredefinedResourceTable::RemoveNode(int64_t node_id) {
+  auto it = node_slots_.find(node_id);
+  if (it == node_slots_.end()) {
+    return;
+  }
+  // Move the node in the last slot into the freed slot.
+  size_t slot = it->second;
+  size_t last = node_ids_.size() - 1;
+  if (slot != last) {
+    node_ids_[slot] = node_ids_[last];
+    node_slots_[node_ids_[slot]] = slot;
+    for (auto &column : available_) {
+      column[slot] = column[last];
+    }
+  }
+  node_ids_.pop_back();
+  node_slots_.erase(node_id);
+}
+
+void PredefinedResourceTable::GetFeasibleNodes(const TaskRequest &task_req, size_t block,
+                                               std::vector<int64_t> *node_ids) const {
+  const size_t begin = block * kBlockSize;
+  if (begin >= node_ids_.size()) {
+    return;
+  }
+  // Flag the slots that lack a hard requested resource. The loop always covers
+  // a whole block, and checks available < demand by the sign bit of the
+  // difference, which the compiler can vectorize with baseline SSE2.
+  uint64_t infeasible[kBlockSize] = {0};
+  for (size_t i = 0; i < PredefinedResources_MAX; i++) {
+    const auto &request = task_req.predefined_resources[i];
+    if (request.soft || request.demand <= 0) {
+      continue;
+    }
+    const int64_t demand = request.demand.Raw();
+    const int64_t *available = available_[i].data() + begin;
+    for (size_t j = 0; j < kBlockSize; j++) {
+      infeasible[j] |= static_cast<uint64_t>(available[j] - demand) >> 63;
+    }
+  }
+  const size_t end = std::min(node_ids_.size() - begin, kBlockSize);
+  for (size_t j = 0; j < end; j++) {
+    if (!infeasible[j]) {
+      node_ids->push_back(node_ids_[begin + j]);
+    }
+  }
+}
+
 ClusterResourceScheduler::ClusterResourceScheduler(
     int64_t local_node_id, const NodeResources &local_node_resources)
     : local_node_id_(local_node_id) {
@@ -479,6 +554,7 @@ void ClusterResourceScheduler::AddOrUpdateNode(int64_t node_id,
     SetPredefinedResources(node_resources, &resources);
     SetCustomResources(node_resources.custom_resources, &resources.custom_resources);
   }
+  predefined_table_.AddOrUpdateNode(node_id, node_resources);
 }
 
 bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
@@ -489,6 +565,7 @@ bool ClusterResourceScheduler::RemoveNode(int64_t node_id) {
   } else {
     it->second.custom_resources.clear();
     nodes_.erase(it);
+    predefined_table_.RemoveNode(node_id);
     string_to_int_map_.Remove(node_id);
     return true;
   }
@@ -592,23 +669,33 @@ int64_t ClusterResourceScheduler::GetBestSchedulableNode(const TaskRequest &task
     }
   }
 
-  for (const auto &node : nodes_) {
-    // Return -1 if node not schedulable. otherwise return the number
-    // of soft constraint violations.
-    int64_t violations;
-
-    if ((violations = IsSchedulable(task_req, node.first, node.second)) == -1) {
-      continue;
-    }
+  // Only fully check the nodes that have enough of the predefined resources that
+  // the task hard requires. Scan the nodes a block at a time so that we can stop
+  // early once we find a node that satisfies all constraints.
+  std::vector<int64_t> candidates;
+  for (size_t block = 0; block < predefined_table_.NumBlocks(); block++) {
+    candidates.clear();
+    predefined_table_.GetFeasibleNodes(task_req, block, &candidates);
+    for (int64_t node_id : candidates) {
+      auto it = nodes_.find(node_id);
+      RAY_CHECK(it != nodes_.end());
+      // Return -1 if node not schedulable. otherwise return the number
+      // of soft constraint violations.
+      int64_t violations;
+
+      if ((violations = IsSchedulable(task_req, it->first, it->second)) == -1) {
+        continue;
+      }
 
-    // Update the node with the smallest number of soft constraints violated.
-    if (min_violations > violations) {
-      min_violations = violations;
-      best_node = node.first;
-    }
-    if (violations == 0) {
-      *total_violations = 0;
-      return best_node;
+      // Update the node with the smallest number of soft constraints violated.
+      if (min_violations > violations) {
+        min_violations = violations;
+        best_node = it->first;
+      }
+      if (violations == 0) {
+        *total_violations = 0;
+        return best_node;
+      }
     }
   }
   *total_violations = min_violations;
@@ -658,6 +745,7 @@ bool ClusterResourceScheduler::SubtractNodeAvailableResources(
           std::max(FixedPoint(0), it->second.available - task_req_custom_resource.demand);
     }
   }
+  predefined_table_.AddOrUpdateNode(node_id, resources);
   return true;
 }
 
@@ -690,6 +778,7 @@ bool ClusterResourceScheduler::AddNodeAvailableResources(int64_t node_id,
           it->second.available + task_req_custom_resource.demand, it->second.total);
     }
   }
+  predefined_table_.AddOrUpdateNode(node_id, resources);
   return true;
 }
 
@@ -769,6 +858,7 @@ void ClusterResourceScheduler::UpdateResourceCapacity(const std::string &client_
       it->second.custom_resources.emplace(resource_id, resource_capacity);
     }
   }
+  predefined_table_.AddOrUpdateNode(client_id, it->second);
 }
 
 void ClusterResourceScheduler::DeleteResource(const std::string &client_id_string,
@@ -1043,6 +1133,7 @@ void ClusterResourceScheduler::UpdateLocalAvailableResourcesFromResourceInstance
       }
     }
   }
+  predefined_table_.AddOrUpdateNode(local_node_id_, it_local_node->second);
 }
 
 void ClusterResourceScheduler::FreeTaskResourceInstances(
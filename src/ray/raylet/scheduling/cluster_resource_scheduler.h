@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <array>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -176,6 +177,53 @@ class NodeResourceInstances {
   std::string DebugString(StringIdMap string_to_int_map) const;
 };
 
+/// Available capacities of the predefined resources of every node in the
+/// cluster, stored as one contiguous array per resource (structure of arrays).
+/// Checking the predefined resources of a task request against all nodes is
+/// then a sequential pass over a few arrays of integers, which the compiler can
+/// vectorize, instead of a hash map walk that touches a separate heap
+/// allocation for every node.
+class PredefinedResourceTable {
+ public:
+  /// Number of node slots that GetFeasibleNodes checks at a time.
+  static constexpr size_t kBlockSize = 256;
+
+  /// Add a new node or overwrite the available resources of an existing node.
+  ///
+  /// \param node_id: Node ID.
+  /// \param resources: Up to date resources of the node.
+  void AddOrUpdateNode(int64_t node_id, const NodeResources &resources);
+
+  /// Remove a node from the table. This is a no-op if the node is unknown.
+  ///
+  /// \param node_id: Node ID.
+  void RemoveNode(int64_t node_id);
+
+  /// Number of blocks of kBlockSize slots that hold the nodes in the table.
+  size_t NumBlocks() const { return (node_ids_.size() + kBlockSize - 1) / kBlockSize; }
+
+  /// Find the nodes in the given block whose available predefined resources
+  /// satisfy all hard predefined demands of the task request. This is only a
+  /// filter: custom resources, soft demands and placement hints still have to
+  /// be checked with ClusterResourceScheduler::IsSchedulable.
+  ///
+  /// \param task_req: Task request to be scheduled.
+  /// \param block: Index of the block of slots to check.
+  /// \param[out] node_ids: IDs of the nodes that pass the filter, in slot order.
+  void GetFeasibleNodes(const TaskRequest &task_req, size_t block,
+                        std::vector<int64_t> *node_ids) const;
+
+ private:
+  /// Node ID stored in each slot.
+  std::vector<int64_t> node_ids_;
+  /// Slot of each node ID.
+  absl::flat_hash_map<int64_t, size_t> node_slots_;
+  /// For each predefined resource, the raw fixed point available capacity of
+  /// the node in each slot. The columns are padded to a multiple of kBlockSize
+  /// so that a whole block can always be read.
+  std::array<std::vector<int64_t>, PredefinedResources_MAX> available_;
+};
+
 /// Class encapsulating the cluster resources and the logic to assign
 /// tasks to nodes based on the task's constraints and the available
 /// resources at those nodes.
@@ -183,6 +231,9 @@ class ClusterResourceScheduler {
   /// List of nodes in the clusters and their resources organized as a map.
   /// The key of the map is the node ID.
   absl::flat_hash_map<int64_t, NodeResources> nodes_;
+  /// Available predefined resources of the nodes in nodes_, laid out for fast
+  /// scans. This must be updated whenever the resources in nodes_ change.
+  PredefinedResourceTable predefined_table_;
   /// Identifier of local node.
   int64_t local_node_id_;
   /// Resources of local node.
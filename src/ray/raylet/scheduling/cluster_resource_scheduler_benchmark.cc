@@ -0,0 +1,112 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures how long the cluster resource scheduler takes to pick a node for a
+// task on synthetic clusters of 1k, 5k and 10k nodes, e.g.
+//
+//   cluster_resource_scheduler_benchmark 10000
+//
+// where the argument is the number of scheduling decisions per measurement.
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ray/raylet/scheduling/cluster_resource_scheduler.h"
+
+namespace ray {
+
+NodeResources MakeNodeResources(double cpus, double available_cpus, double gpus,
+                                double available_gpus) {
+  NodeResources resources;
+  resources.predefined_resources.resize(PredefinedResources_MAX);
+  resources.predefined_resources[CPU].total = cpus;
+  resources.predefined_resources[CPU].available = available_cpus;
+  resources.predefined_resources[MEM].total = 64;
+  resources.predefined_resources[MEM].available = 64;
+  resources.predefined_resources[GPU].total = gpus;
+  resources.predefined_resources[GPU].available = available_gpus;
+  return resources;
+}
+
+TaskRequest MakeTaskRequest(double cpus, double gpus) {
+  TaskRequest task_req;
+  task_req.predefined_resources.resize(PredefinedResources_MAX);
+  for (auto &request : task_req.predefined_resources) {
+    request.demand = 0;
+    request.soft = false;
+  }
+  task_req.predefined_resources[CPU].demand = cpus;
+  task_req.predefined_resources[GPU].demand = gpus;
+  return task_req;
+}
+
+/// Build a cluster of busy 16-CPU nodes in which one in `free_cpu_every` nodes
+/// still has a free CPU and one in `gpu_every` nodes has a free CPU and GPU.
+/// The local node is busy, so every decision has to look at the rest of the
+/// cluster.
+void BuildCluster(ClusterResourceScheduler *scheduler, int num_nodes,
+                  int free_cpu_every, int gpu_every) {
+  for (int node_id = 1; node_id < num_nodes; node_id++) {
+    bool free_cpu = std::rand() % free_cpu_every == 0;
+    bool gpu = std::rand() % gpu_every == 0;
+    double available_cpus = free_cpu || gpu ? 1 : 0;
+    scheduler->AddOrUpdateNode(
+        node_id, MakeNodeResources(16, available_cpus, gpu ? 4 : 0, gpu ? 1 : 0));
+  }
+}
+
+/// Return the average time in microseconds that it takes to pick a node.
+double MicrosPerDecision(ClusterResourceScheduler *scheduler,
+                         const TaskRequest &task_req, int num_decisions) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num_decisions; i++) {
+    int64_t violations;
+    scheduler->GetBestSchedulableNode(task_req, &violations);
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         num_decisions;
+}
+
+void RunBenchmarks(int num_decisions) {
+  const auto cpu_task = MakeTaskRequest(1, 0);
+  const auto gpu_task = MakeTaskRequest(1, 1);
+  for (int num_nodes : {1000, 5000, 10000}) {
+    std::srand(num_nodes);
+    ClusterResourceScheduler scheduler(0, MakeNodeResources(16, 0, 0, 0));
+    // Most of the cluster is busy: only about 1% of the nodes can take a CPU
+    // task and about 2% of them can take a GPU task.
+    BuildCluster(&scheduler, num_nodes, /*free_cpu_every=*/100, /*gpu_every=*/50);
+    std::cout << num_nodes << " nodes:" << std::endl;
+    std::cout << "  CPU task: " << MicrosPerDecision(&scheduler, cpu_task, num_decisions)
+              << " us per decision" << std::endl;
+    std::cout << "  GPU task: " << MicrosPerDecision(&scheduler, gpu_task, num_decisions)
+              << " us per decision" << std::endl;
+    // A task that no node can run has to check the whole cluster.
+    auto infeasible_task = MakeTaskRequest(32, 0);
+    std::cout << "  infeasible task: "
+              << MicrosPerDecision(&scheduler, infeasible_task, num_decisions / 10 + 1)
+              << " us per decision" << std::endl;
+  }
+}
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  int num_decisions = argc > 1 ? std::atoi(argv[1]) : 10000;
+  ray::RunBenchmarks(num_decisions);
+  return 0;
+}
@@ -563,6 +563,114 @@ TEST_F(ClusterResourceSchedulerTest, SchedulingTaskRequestTest) {
   }
 }
 
+TEST_F(ClusterResourceSchedulerTest, SchedulingLargeClusterTest) {
+  // Check that the scheduler picks a node with the fewest violations while nodes
+  // are added, updated, allocated from and removed.
+  int num_nodes = 3000;
+  ClusterResourceScheduler cluster_resources;
+  for (int i = 0; i < num_nodes; i++) {
+    NodeResources node_resources;
+    vector<FixedPoint> pred_capacities{rand() % 12, rand() % 4, rand() % 2};
+    vector<int64_t> cust_ids{rand() % num_nodes};
+    vector<FixedPoint> cust_capacities{rand() % 5};
+    initNodeResources(node_resources, pred_capacities, cust_ids, cust_capacities);
+    cluster_resources.AddOrUpdateNode(i, node_resources);
+  }
+
+  auto check_best_node = [&cluster_resources, num_nodes](const TaskRequest &task_req) {
+    int64_t violations;
+    int64_t best_node = cluster_resources.GetBestSchedulableNode(task_req, &violations);
+    int64_t min_violations = -1;
+    for (int64_t node_id = 0; node_id < num_nodes; node_id++) {
+      NodeResources resources;
+      if (!cluster_resources.GetNodeResources(node_id, &resources)) {
+        continue;
+      }
+      int64_t v = cluster_resources.IsSchedulable(task_req, node_id, resources);
+      if (v != -1 && (min_violations == -1 || v < min_violations)) {
+        min_violations = v;
+      }
+    }
+    if (min_violations == -1) {
+      ASSERT_EQ(best_node, -1);
+    } else {
+      ASSERT_NE(best_node, -1);
+      ASSERT_EQ(violations, min_violations);
+      NodeResources resources;
+      ASSERT_TRUE(cluster_resources.GetNodeResources(best_node, &resources));
+      ASSERT_EQ(cluster_resources.IsSchedulable(task_req, best_node, resources),
+                min_violations);
+    }
+  };
+
+  for (int i = 0; i < 500; i++) {
+    TaskRequest task_req;
+    vector<FixedPoint> pred_demands{rand() % 12, rand() % 4, rand() % 2};
+    vector<bool> pred_soft{false, rand() % 4 == 0, false};
+    vector<int64_t> cust_ids;
+    vector<FixedPoint> cust_demands;
+    vector<bool> cust_soft;
+    if (rand() % 2 == 0) {
+      cust_ids.push_back(rand() % num_nodes);
+      cust_demands.push_back(rand() % 5);
+      cust_soft.push_back(rand() % 2 == 0);
+    }
+    initTaskRequest(task_req, pred_demands, pred_soft, cust_ids, cust_demands, cust_soft,
+                    EmptyIntVector);
+    check_best_node(task_req);
+
+    int64_t node_id = rand() % num_nodes;
+    switch (rand() % 4) {
+    case 0:
+      cluster_resources.SubtractNodeAvailableResources(node_id, task_req);
+      break;
+    case 1:
+      cluster_resources.AddNodeAvailableResources(node_id, task_req);
+      break;
+    case 2:
+      cluster_resources.RemoveNode(node_id);
+      break;
+    default:
+      NodeResources node_resources;
+      vector<FixedPoint> pred_capacities{rand() % 12, rand() % 4, rand() % 2};
+      initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                        EmptyFixedPointVector);
+      cluster_resources.AddOrUpdateNode(node_id, node_resources);
+      break;
+    }
+  }
+}
+
+TEST_F(ClusterResourceSchedulerTest, SchedulingUpdatedResourcesTest) {
+  // Check that allocating and freeing remote resources is reflected in the
+  // nodes that the scheduler picks.
+  ClusterResourceScheduler cluster_resources;
+  vector<FixedPoint> pred_capacities{4};
+  for (int64_t node_id = 1; node_id <= 2; node_id++) {
+    NodeResources node_resources;
+    initNodeResources(node_resources, pred_capacities, EmptyIntVector,
+                      EmptyFixedPointVector);
+    cluster_resources.AddOrUpdateNode(node_id, node_resources);
+  }
+
+  TaskRequest task_req;
+  vector<FixedPoint> pred_demands{4};
+  vector<bool> pred_soft{false};
+  initTaskRequest(task_req, pred_demands, pred_soft, EmptyIntVector,
+                  EmptyFixedPointVector, EmptyBoolVector, EmptyIntVector);
+  int64_t violations;
+  ASSERT_TRUE(cluster_resources.SubtractNodeAvailableResources(1, task_req));
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, &violations), 2);
+  ASSERT_TRUE(cluster_resources.SubtractNodeAvailableResources(2, task_req));
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, &violations), -1);
+  ASSERT_TRUE(cluster_resources.AddNodeAvailableResources(1, task_req));
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, &violations), 1);
+  ASSERT_TRUE(cluster_resources.RemoveNode(1));
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, &violations), -1);
+  ASSERT_TRUE(cluster_resources.AddNodeAvailableResources(2, task_req));
+  ASSERT_EQ(cluster_resources.GetBestSchedulableNode(task_req, &violations), 2);
+}
+
 TEST_F(ClusterResourceSchedulerTest, GetLocalAvailableResourcesTest) {
   // Create cluster resources containing local node.
   NodeResources node_resources;
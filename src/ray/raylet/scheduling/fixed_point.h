@@ -38,5 +38,8 @@ class FixedPoint {
 
   double Double();
 
+  /// The underlying integer representation, in units of 1 / RESOURCE_UNIT_SCALING.
+  int64_t Raw() const { return i_; }
+
   friend std::ostream &operator<<(std::ostream &out, const FixedPoint &ru);
 };
@@ -18,14 +18,44 @@
 #include <chrono>
 #include <random>
 
+#include "ray/stats/stats.h"
 #include "ray/util/logging.h"
 
 namespace ray {
 
 namespace raylet {
 
-SchedulingPolicy::SchedulingPolicy(const SchedulingQueue &scheduling_queue)
+namespace {
+
+/// The highest fraction of any resource that the task needs that is in use on
+/// the node, counting the tasks queued there. Tasks that need no resources are
+/// compared by CPU.
+double NodeUtilization(const SchedulingResources &node, const ResourceSet &demand) {
+  auto resources = demand.GetResourceMap();
+  if (resources.empty()) {
+    resources.emplace(kCPU_ResourceLabel, 0);
+  }
+  double utilization = 0;
+  for (const auto &resource : resources) {
+    double total = node.GetTotalResources().GetResource(resource.first).ToDouble();
+    if (total <= 0) {
+      continue;
+    }
+    double used = total -
+                  node.GetAvailableResources().GetResource(resource.first).ToDouble() +
+                  node.GetLoadResources().GetResource(resource.first).ToDouble();
+    utilization = std::max(utilization, used / total);
+  }
+  return utilization;
+}
+
+}  // namespace
+
+SchedulingPolicy::SchedulingPolicy(const SchedulingQueue &scheduling_queue,
+                                   double spread_threshold, int64_t spread_num_samples)
     : scheduling_queue_(scheduling_queue),
+      spread_threshold_(spread_threshold),
+      spread_num_samples_(std::max<int64_t>(spread_num_samples, 1)),
       gen_(std::chrono::high_resolution_clock::now().time_since_epoch().count()) {}
 
 std::unordered_map<TaskID, ClientID> SchedulingPolicy::Schedule(
@@ -79,12 +109,8 @@ std::unordered_map<TaskID, ClientID> SchedulingPolicy::Schedule(
     }
 
     if (!client_keys.empty()) {
-      // Choose index at random.
-      // Initialize a uniform integer distribution over the key space.
-      // TODO(atumanov): change uniform random to discrete, weighted by resource capacity.
-      std::uniform_int_distribution<int> distribution(0, client_keys.size() - 1);
-      int client_key_index = distribution(gen_);
-      const ClientID &dst_client_id = client_keys[client_key_index];
+      const ClientID dst_client_id =
+          PickAvailableNode(t, client_keys, cluster_resources, local_client_id);
       decision[task_id] = dst_client_id;
       // Update dst_client_id's load to keep track of remote task load until
       // the next heartbeat.
@@ -133,6 +159,75 @@ std::unordered_map<TaskID, ClientID> SchedulingPolicy::Schedule(
   return decision;
 }
 
+ClientID SchedulingPolicy::PickAvailableNode(
+    const Task &task, const std::vector<ClientID> &candidates,
+    const std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
+    const ClientID &local_client_id) {
+  // Prefer the node that stores the most bytes of the task's arguments, so
+  // that they do not need to be transferred.
+  const auto &arg_bytes_by_node = task.ArgBytesByNode();
+  std::vector<ClientID> best_nodes;
+  int64_t best_bytes = 0;
+  if (!arg_bytes_by_node.empty()) {
+    for (const auto &node_id : candidates) {
+      auto it = arg_bytes_by_node.find(node_id);
+      if (it == arg_bytes_by_node.end() || it->second <= 0 ||
+          it->second < best_bytes) {
+        continue;
+      }
+      if (it->second > best_bytes) {
+        best_bytes = it->second;
+        best_nodes.clear();
+      }
+      best_nodes.push_back(node_id);
+    }
+  }
+  if (!best_nodes.empty()) {
+    RAY_LOG(DEBUG) << "Placing task " << task.GetTaskSpecification().TaskId()
+                   << " on one of " << best_nodes.size() << " nodes that store "
+                   << best_bytes << " bytes of its arguments";
+    stats::TaskArgBytesPlacedLocally().Record(best_bytes);
+    std::uniform_int_distribution<size_t> distribution(0, best_nodes.size() - 1);
+    return best_nodes[distribution(gen_)];
+  }
+
+  // None of the nodes is known to store the arguments. Pack the task onto a
+  // node that is not too busy yet, so that the other nodes stay idle and can be
+  // scaled down. Prefer the local node, which saves a spillback.
+  const auto &demand = task.GetTaskSpecification().GetRequiredPlacementResources();
+  std::vector<double> utilization;
+  utilization.reserve(candidates.size());
+  int64_t pack_index = -1;
+  for (size_t i = 0; i < candidates.size(); i++) {
+    utilization.push_back(NodeUtilization(cluster_resources.at(candidates[i]), demand));
+    if (utilization[i] >= spread_threshold_) {
+      continue;
+    }
+    if (candidates[i] == local_client_id) {
+      return local_client_id;
+    }
+    if (pack_index == -1 || utilization[i] > utilization[pack_index]) {
+      pack_index = i;
+    }
+  }
+  if (pack_index != -1) {
+    return candidates[pack_index];
+  }
+
+  // All candidates are busy. Spread the task to the least utilized of a few
+  // random candidates, which avoids piling onto one node without having to
+  // compare all of them.
+  std::uniform_int_distribution<size_t> distribution(0, candidates.size() - 1);
+  size_t spread_index = distribution(gen_);
+  for (int64_t i = 1; i < spread_num_samples_; i++) {
+    size_t sample = distribution(gen_);
+    if (utilization[sample] < utilization[spread_index]) {
+      spread_index = sample;
+    }
+  }
+  return candidates[spread_index];
+}
+
 bool SchedulingPolicy::ScheduleBundle(
     std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
     const ClientID &local_client_id, const ray::BundleSpecification &bundle_spec) {
@@ -33,8 +33,12 @@ class SchedulingPolicy {
   ///
   /// \param scheduling_queue: reference to a scheduler queues object for access to
   /// tasks.
+  /// \param spread_threshold: Utilization below which tasks are packed onto a
+  /// node rather than spread across the cluster.
+  /// \param spread_num_samples: Number of random nodes to compare when spreading.
   /// \return Void.
-  SchedulingPolicy(const SchedulingQueue &scheduling_queue);
+  SchedulingPolicy(const SchedulingQueue &scheduling_queue, double spread_threshold,
+                   int64_t spread_num_samples);
 
   /// \brief Perform a scheduling operation, given a set of cluster resources and
   /// producing a mapping of tasks to raylets.
@@ -74,8 +78,29 @@ class SchedulingPolicy {
   virtual ~SchedulingPolicy();
 
  private:
+  /// Pick the node to place a task on among nodes that have the resources
+  /// available for it. This is the node that stores the most bytes of the
+  /// task's arguments. If none of them is known to store any, the node is
+  /// chosen by utilization: pack onto the local node or the busiest node below
+  /// the spread threshold, or else spread with power-of-k choices.
+  ///
+  /// \param task The task to place.
+  /// \param candidates The nodes that can run the task now. Must not be empty.
+  /// \param cluster_resources The resources and load of each candidate node.
+  /// \param local_client_id The ID of the local node.
+  /// \return The chosen node.
+  ClientID PickAvailableNode(
+      const Task &task, const std::vector<ClientID> &candidates,
+      const std::unordered_map<ClientID, SchedulingResources> &cluster_resources,
+      const ClientID &local_client_id);
+
   /// An immutable reference to the scheduling task queues.
   const SchedulingQueue &scheduling_queue_;
+  /// Tasks are packed onto nodes whose utilization is below this fraction and
+  /// spread once all candidates reach it.
+  const double spread_threshold_;
+  /// The number of random candidates to compare when spreading tasks.
+  const int64_t spread_num_samples_;
   /// Internally maintained random number generator.
   std::mt19937_64 gen_;
 };
@@ -0,0 +1,142 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/raylet/scheduling_policy.h"
+
+#include "gtest/gtest.h"
+#include "ray/common/task/task_util.h"
+#include "ray/common/test_util.h"
+
+namespace ray {
+
+namespace raylet {
+
+class SchedulingPolicyTest : public ::testing::Test {
+ public:
+  // Spread by comparing enough random nodes that the least utilized one is
+  // found.
+  SchedulingPolicyTest()
+      : policy_(queue_, /*spread_threshold=*/0.5, /*spread_num_samples=*/100) {
+    SetNodeCapacity(1);
+  }
+
+  /// Reset the cluster to three idle nodes with the given number of CPUs.
+  void SetNodeCapacity(double num_cpus) {
+    node_ids_.clear();
+    cluster_resources_.clear();
+    for (int i = 0; i < 3; i++) {
+      const auto node_id = ClientID::FromRandom();
+      node_ids_.push_back(node_id);
+      cluster_resources_[node_id] = SchedulingResources(
+          ResourceSet(std::unordered_map<std::string, double>({{"CPU", num_cpus}})));
+    }
+  }
+
+  Task ExampleTask(const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) {
+    TaskSpecBuilder builder;
+    rpc::Address address;
+    builder.SetCommonTaskSpec(RandomTaskId(), Language::PYTHON,
+                              FunctionDescriptorBuilder::BuildPython("", "", "", ""),
+                              JobID::Nil(), RandomTaskId(), 0, RandomTaskId(), address,
+                              1, {{"CPU", 1}}, {{"CPU", 1}});
+    builder.AddArg(TaskArgByReference(ObjectID::FromRandom(), address));
+    Task task(builder.Build(), TaskExecutionSpecification(rpc::TaskExecutionSpec()));
+    task.SetArgBytesByNode(arg_bytes_by_node);
+    return task;
+  }
+
+  /// Schedule a single task and return the node that it was placed on.
+  ClientID ScheduleTask(const Task &task) {
+    const auto task_id = task.GetTaskSpecification().TaskId();
+    queue_.QueueTasks({task}, TaskState::PLACEABLE);
+    auto decision = policy_.Schedule(cluster_resources_, node_ids_[0]);
+    Task removed;
+    RAY_CHECK(queue_.RemoveTask(task_id, &removed));
+    RAY_CHECK(decision.count(task_id) == 1);
+    return decision[task_id];
+  }
+
+ protected:
+  SchedulingQueue queue_;
+  SchedulingPolicy policy_;
+  std::vector<ClientID> node_ids_;
+  std::unordered_map<ClientID, SchedulingResources> cluster_resources_;
+};
+
+TEST_F(SchedulingPolicyTest, TestPlaceTaskNearArguments) {
+  const std::unordered_map<ClientID, int64_t> arg_bytes_by_node(
+      {{node_ids_[1], 100}, {node_ids_[2], 200}});
+  // The task goes to the node that stores the most bytes of its arguments.
+  ASSERT_EQ(ScheduleTask(ExampleTask(arg_bytes_by_node)), node_ids_[2]);
+  // That node is now busy, so the next task goes to the node that stores the
+  // next most bytes.
+  ASSERT_EQ(ScheduleTask(ExampleTask(arg_bytes_by_node)), node_ids_[1]);
+  // Once neither node has capacity, the task goes to the remaining node.
+  ASSERT_EQ(ScheduleTask(ExampleTask(arg_bytes_by_node)), node_ids_[0]);
+}
+
+TEST_F(SchedulingPolicyTest, TestUnknownArgumentLocations) {
+  // Nodes that are not candidates are ignored.
+  const std::unordered_map<ClientID, int64_t> arg_bytes_by_node(
+      {{ClientID::FromRandom(), 100}});
+  std::unordered_set<ClientID> placed;
+  for (int i = 0; i < 3; i++) {
+    placed.insert(ScheduleTask(ExampleTask(arg_bytes_by_node)));
+  }
+  // Each task used up one node's capacity, so the tasks are spread out.
+  ASSERT_EQ(placed.size(), 3);
+}
+
+TEST_F(SchedulingPolicyTest, TestPackBeforeSpread) {
+  SetNodeCapacity(4);
+  // Tasks are packed onto the local node until it reaches the threshold.
+  ASSERT_EQ(ScheduleTask(ExampleTask({})), node_ids_[0]);
+  ASSERT_EQ(ScheduleTask(ExampleTask({})), node_ids_[0]);
+  // Then onto one other node.
+  const auto packed_node = ScheduleTask(ExampleTask({}));
+  ASSERT_NE(packed_node, node_ids_[0]);
+  ASSERT_EQ(ScheduleTask(ExampleTask({})), packed_node);
+  // Then onto the last idle node.
+  const auto last_node = ScheduleTask(ExampleTask({}));
+  ASSERT_NE(last_node, node_ids_[0]);
+  ASSERT_NE(last_node, packed_node);
+  ASSERT_EQ(ScheduleTask(ExampleTask({})), last_node);
+  // All nodes are at the threshold, so the rest of the tasks are spread out.
+  std::unordered_set<ClientID> placed;
+  for (int i = 0; i < 3; i++) {
+    placed.insert(ScheduleTask(ExampleTask({})));
+  }
+  ASSERT_EQ(placed.size(), 3);
+}
+
+TEST_F(SchedulingPolicyTest, TestSpreadByLoad) {
+  SetNodeCapacity(4);
+  // Every node is above the threshold, counting the tasks queued there.
+  const std::vector<double> loads = {3, 2, 3};
+  for (size_t i = 0; i < loads.size(); i++) {
+    cluster_resources_[node_ids_[i]].SetLoadResources(
+        ResourceSet(std::unordered_map<std::string, double>({{"CPU", loads[i]}})));
+  }
+  // The task goes to the least loaded node.
+  ASSERT_EQ(ScheduleTask(ExampleTask({})), node_ids_[1]);
+}
+
+}  // namespace raylet
+
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,8 +14,15 @@
 
 #include "ray/raylet/worker_pool.h"
 
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstring>
 
 #include "ray/common/constants.h"
 #include "ray/common/network_util.h"
@@ -61,12 +68,14 @@ WorkerPool::WorkerPool(boost::asio::io_service &io_service, int num_workers,
                        int max_worker_port, std::shared_ptr<gcs::GcsClient> gcs_client,
                        const WorkerCommandMap &worker_commands,
                        const std::unordered_map<std::string, std::string> &raylet_config,
+                       const std::string &fork_server_socket_name,
                        std::function<void()> starting_worker_timeout_callback)
     : io_service_(&io_service),
       maximum_startup_concurrency_(maximum_startup_concurrency),
       gcs_client_(std::move(gcs_client)),
       raylet_config_(raylet_config),
-      starting_worker_timeout_callback_(starting_worker_timeout_callback) {
+      starting_worker_timeout_callback_(starting_worker_timeout_callback),
+      fork_server_socket_name_(fork_server_socket_name) {
   RAY_CHECK(maximum_startup_concurrency > 0);
 #ifndef _WIN32
   // Ignore SIGCHLD signals. If we don't do this, then worker processes will
@@ -111,6 +120,10 @@ WorkerPool::WorkerPool(boost::asio::io_service &io_service, int num_workers,
       free_ports_->push(port);
     }
   }
+#ifdef _WIN32
+  // Forking workers is not supported on Windows.
+  fork_server_socket_name_.clear();
+#endif
   Start(num_workers);
 }
 
@@ -138,10 +151,18 @@ WorkerPool::~WorkerPool() {
       procs_to_kill.insert(starting_worker.first);
     }
   }
+  if (!fork_server_.IsNull()) {
+    procs_to_kill.insert(fork_server_);
+  }
   for (Process proc : procs_to_kill) {
     proc.Kill();
     // NOTE: Avoid calling Wait() here. It fails with ECHILD, as SIGCHLD is disabled.
   }
+#ifndef _WIN32
+  if (fork_server_fd_ != -1) {
+    close(fork_server_fd_);
+  }
+#endif
 }
 
 uint32_t WorkerPool::Size(const Language &language) const {
@@ -241,7 +262,20 @@ Process WorkerPool::StartWorkerProcess(const Language &language,
         << " placeholder is not found in worker command.";
   }
 
-  Process proc = StartProcess(worker_command_args);
+  Process proc;
+  if (language == Language::PYTHON && dynamic_options.empty() &&
+      !fork_server_socket_name_.empty()) {
+    if (fork_server_.IsNull()) {
+      // The fork server is started along with the first Python worker, which is
+      // started by exec while the fork server imports Ray.
+      StartForkServer(worker_command_args);
+    } else {
+      proc = ForkWorkerProcess();
+    }
+  }
+  if (proc.IsNull()) {
+    proc = StartProcess(worker_command_args);
+  }
   RAY_LOG(DEBUG) << "Started worker process of " << workers_to_start
                  << " worker(s) with pid " << proc.GetId();
   MonitorStartingWorkerProcess(proc, language);
@@ -265,6 +299,7 @@ void WorkerPool::MonitorStartingWorkerProcess(const Process &proc,
         if (it != state.starting_worker_processes.end()) {
           RAY_LOG(INFO) << "Some workers of the worker process(" << proc.GetId()
                         << ") have not registered to raylet within timeout.";
+          state.prestarting_processes.erase(proc);
           state.starting_worker_processes.erase(it);
           starting_worker_timeout_callback_();
         }
@@ -297,6 +332,83 @@ Process WorkerPool::StartProcess(const std::vector<std::string> &worker_command_
   return child;
 }
 
+void WorkerPool::StartForkServer(const std::vector<std::string> &worker_command_args) {
+  std::vector<std::string> args = worker_command_args;
+  args.push_back("--fork-server-socket=" + fork_server_socket_name_);
+  fork_server_ = StartProcess(args);
+  RAY_LOG(INFO) << "Started Python worker fork server with pid " << fork_server_.GetId()
+                << " on socket " << fork_server_socket_name_;
+}
+
+Process WorkerPool::ForkWorkerProcess() {
+#ifdef _WIN32
+  return Process();
+#else
+  if (fork_server_socket_name_.empty()) {
+    return Process();
+  }
+  if (fork_server_fd_ == -1) {
+    // The fork server listens once it has imported Ray. Until then, workers are
+    // started by exec.
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, fork_server_socket_name_.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+      return Process();
+    }
+    if (connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) != 0) {
+      close(fd);
+      return Process();
+    }
+    // Forking takes milliseconds. Don't block the event loop for long if the
+    // fork server hangs.
+    struct timeval timeout = {1, 0};
+    RAY_CHECK(setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0);
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    RAY_CHECK(setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one)) == 0);
+#endif
+    fork_server_fd_ = fd;
+    RAY_LOG(INFO) << "Connected to the Python worker fork server";
+  }
+
+  // Each request is a single byte, and the reply is the pid of the new worker.
+#ifdef MSG_NOSIGNAL
+  const int send_flags = MSG_NOSIGNAL;
+#else
+  const int send_flags = 0;
+#endif
+  const char request = 'F';
+  int32_t pid = -1;
+  size_t received = 0;
+  bool ok = send(fork_server_fd_, &request, sizeof(request), send_flags) == 1;
+  while (ok && received < sizeof(pid)) {
+    ssize_t n =
+        recv(fork_server_fd_, reinterpret_cast<char *>(&pid) + received,
+             sizeof(pid) - received, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    ok = n > 0;
+    received += ok ? n : 0;
+  }
+  if (!ok || pid <= 0) {
+    RAY_LOG(WARNING) << "Failed to fork a worker from the Python worker fork server: "
+                     << strerror(errno) << ". Starting new workers by exec instead.";
+    close(fork_server_fd_);
+    fork_server_fd_ = -1;
+    fork_server_socket_name_.clear();
+    // The fork server may be hung, and it is not used anymore.
+    fork_server_.Kill();
+    fork_server_ = Process();
+    return Process();
+  }
+  return Process::FromPid(pid);
+#endif
+}
+
 Status WorkerPool::GetNextFreePort(int *port) {
   if (!free_ports_) {
     *port = 0;
@@ -339,8 +451,12 @@ Status WorkerPool::RegisterWorker(const std::shared_ptr<WorkerInterface> &worker
   RAY_LOG(DEBUG) << "Registering worker with pid " << pid << ", port: " << *port;
   worker->SetAssignedPort(*port);
   worker->SetProcess(it->first);
+  if (state.prestarting_processes.count(it->first) > 0) {
+    state.prestarted_workers.emplace(worker, 0);
+  }
   it->second--;
   if (it->second == 0) {
+    state.prestarting_processes.erase(it->first);
     state.starting_worker_processes.erase(it);
   }
 
@@ -397,6 +513,10 @@ void WorkerPool::PushWorker(const std::shared_ptr<WorkerInterface> &worker) {
     // Put the worker to the corresponding idle pool.
     if (worker->GetActorId().IsNil()) {
       state.idle.insert(worker);
+      auto prestarted_it = state.prestarted_workers.find(worker);
+      if (prestarted_it != state.prestarted_workers.end()) {
+        prestarted_it->second = current_time_ms();
+      }
     } else {
       state.idle_actor[worker->GetActorId()] = worker;
     }
@@ -437,9 +557,29 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
       worker = std::move(*state.idle.begin());
       state.idle.erase(state.idle.begin());
     } else {
+      const TaskID &task_id = task_spec.TaskId();
+      if (RayConfig::instance().max_prestarted_idle_workers() > 0) {
+        // The caller retries until a worker is found, so count each task once.
+        state.missed_tasks.insert(task_id);
+      }
       // There are no more non-actor workers available to execute this task.
-      // Start a new worker process.
-      proc = StartWorkerProcess(task_spec.GetLanguage());
+      // Start a new worker process, unless a worker started ahead of demand is
+      // already on its way for it. Each of those workers covers one task.
+      auto &waiting_tasks = state.tasks_waiting_for_prestarted_workers;
+      const size_t num_prestarting_workers = NumPrestartingWorkers(state);
+      if (num_prestarting_workers == 0) {
+        // Drop tasks that stopped waiting, e.g. because their lease was canceled.
+        waiting_tasks.clear();
+      }
+      if (waiting_tasks.count(task_id) == 0 &&
+          waiting_tasks.size() < num_prestarting_workers) {
+        waiting_tasks.insert(task_id);
+      } else if (waiting_tasks.count(task_id) == 0 ||
+                 waiting_tasks.size() > num_prestarting_workers) {
+        // More tasks are waiting than prestarted workers are on their way.
+        waiting_tasks.erase(task_id);
+        proc = StartWorkerProcess(task_spec.GetLanguage());
+      }
     }
   } else {
     // Code path of actor task.
@@ -454,10 +594,116 @@ std::shared_ptr<WorkerInterface> WorkerPool::PopWorker(
   if (worker == nullptr && proc.IsValid()) {
     WarnAboutSize();
   }
+  if (worker != nullptr) {
+    state.prestarted_workers.erase(worker);
+    state.tasks_waiting_for_prestarted_workers.erase(task_spec.TaskId());
+  }
 
   return worker;
 }
 
+void WorkerPool::PrestartWorkers(const TaskSpecification &task_spec,
+                                 int64_t backlog_size) {
+  const int64_t max_prestarted = RayConfig::instance().max_prestarted_idle_workers();
+  if (max_prestarted <= 0 || task_spec.IsActorTask() ||
+      (task_spec.IsActorCreationTask() && !task_spec.DynamicWorkerOptions().empty())) {
+    return;
+  }
+  PrestartIdleWorkers(task_spec.GetLanguage(), std::min(backlog_size, max_prestarted));
+}
+
+size_t WorkerPool::NumPrestartingWorkers(const State &state) const {
+  size_t num_workers = 0;
+  for (const auto &proc : state.prestarting_processes) {
+    auto it = state.starting_worker_processes.find(proc);
+    if (it != state.starting_worker_processes.end()) {
+      num_workers += it->second;
+    }
+  }
+  // Workers that have registered but not been pushed yet are still on their way.
+  for (const auto &entry : state.prestarted_workers) {
+    if (entry.second == 0) {
+      num_workers++;
+    }
+  }
+  return num_workers;
+}
+
+void WorkerPool::PrestartIdleWorkers(const Language &language, int64_t num_workers) {
+  auto &state = GetStateForLanguage(language);
+  int64_t num_usable_workers = state.idle.size();
+  for (const auto &entry : state.starting_worker_processes) {
+    if (state.dedicated_workers_to_tasks.count(entry.first) == 0) {
+      num_usable_workers += entry.second;
+    }
+  }
+  while (num_usable_workers < num_workers) {
+    Process proc = StartWorkerProcess(language);
+    if (proc.IsNull()) {
+      // Too many workers are starting already.
+      break;
+    }
+    RAY_LOG(DEBUG) << "Prestarted worker process with pid " << proc.GetId();
+    state.prestarting_processes.insert(proc);
+    num_usable_workers += state.num_workers_per_process;
+  }
+}
+
+std::vector<std::shared_ptr<WorkerInterface>> WorkerPool::MaintainIdleWorkers(
+    int64_t now_ms) {
+  std::vector<std::shared_ptr<WorkerInterface>> idle_workers_to_kill;
+  const int64_t max_prestarted = RayConfig::instance().max_prestarted_idle_workers();
+  const int64_t period_ms = RayConfig::instance().worker_demand_period_ms();
+  if (max_prestarted <= 0 || now_ms - demand_period_start_ms_ < period_ms) {
+    return idle_workers_to_kill;
+  }
+  demand_period_start_ms_ = now_ms;
+  const int64_t idle_timeout_ms =
+      RayConfig::instance().prestarted_worker_idle_timeout_ms();
+  // Remember demand for as long as prestarted workers may stay idle.
+  const size_t num_periods = std::max<int64_t>(1, idle_timeout_ms / period_ms);
+
+  for (auto &entry : states_by_lang_) {
+    auto &state = entry.second;
+    // Keep as many idle workers as tasks missed the pool in the busiest recent
+    // period.
+    state.missed_pops.push_back(state.missed_tasks.size());
+    state.missed_tasks.clear();
+    while (state.missed_pops.size() > num_periods) {
+      state.missed_pops.pop_front();
+    }
+    int64_t demand = 0;
+    for (int64_t missed : state.missed_pops) {
+      demand = std::max(demand, missed);
+    }
+    demand = std::min(demand, max_prestarted);
+    PrestartIdleWorkers(entry.first, demand);
+
+    if (state.num_workers_per_process != 1) {
+      // Killing a worker would kill the other workers in its process too.
+      continue;
+    }
+    // Only kill workers that have never run a task, since other workers may own
+    // objects.
+    for (auto it = state.prestarted_workers.begin();
+         it != state.prestarted_workers.end() &&
+         static_cast<int64_t>(state.idle.size()) > demand;) {
+      const auto &worker = it->first;
+      if (it->second == 0 || now_ms - it->second < idle_timeout_ms ||
+          state.idle.count(worker) == 0) {
+        it++;
+        continue;
+      }
+      RAY_LOG(DEBUG) << "Killing prestarted worker " << worker->WorkerId()
+                     << " that has been idle for " << now_ms - it->second << " ms";
+      state.idle.erase(worker);
+      idle_workers_to_kill.push_back(worker);
+      it = state.prestarted_workers.erase(it);
+    }
+  }
+  return idle_workers_to_kill;
+}
+
 bool WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker) {
   auto &state = GetStateForLanguage(worker->GetLanguage());
   RAY_CHECK(RemoveWorker(state.registered_workers, worker));
@@ -467,6 +713,7 @@ bool WorkerPool::DisconnectWorker(const std::shared_ptr<WorkerInterface> &worker
           {stats::WorkerPidKey, std::to_string(worker->GetProcess().GetId())}});
 
   MarkPortAsFree(worker->AssignedPort());
+  state.prestarted_workers.erase(worker);
   return RemoveWorker(state.idle, worker);
 }
 
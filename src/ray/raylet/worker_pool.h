@@ -17,6 +17,7 @@
 #include <inttypes.h>
 
 #include <boost/asio/io_service.hpp>
+#include <deque>
 #include <queue>
 #include <unordered_map>
 #include <unordered_set>
@@ -83,6 +84,9 @@ class WorkerPool : public WorkerPoolInterface {
   /// \param worker_commands The commands used to start the worker process, grouped by
   /// language.
   /// \param raylet_config The raylet config list of this node.
+  /// \param fork_server_socket_name The path of the socket on which a Python worker
+  /// fork server should listen. If empty, no fork server is started and all workers
+  /// are started by exec'ing the worker command.
   /// \param starting_worker_timeout_callback The callback that will be triggered once
   /// it times out to start a worker.
   WorkerPool(boost::asio::io_service &io_service, int num_workers,
@@ -90,6 +94,7 @@ class WorkerPool : public WorkerPoolInterface {
              std::shared_ptr<gcs::GcsClient> gcs_client,
              const WorkerCommandMap &worker_commands,
              const std::unordered_map<std::string, std::string> &raylet_config,
+             const std::string &fork_server_socket_name,
              std::function<void()> starting_worker_timeout_callback);
 
   /// Destructor responsible for freeing a set of workers owned by this class.
@@ -154,6 +159,27 @@ class WorkerPool : public WorkerPoolInterface {
   /// such worker exists.
   std::shared_ptr<WorkerInterface> PopWorker(const TaskSpecification &task_spec);
 
+  /// Start workers ahead of demand for tasks like the given one, so that the
+  /// owner's queued tasks do not each wait for a new worker process. This keeps
+  /// up to backlog_size idle or starting workers, capped by
+  /// max_prestarted_idle_workers.
+  ///
+  /// \param task_spec The task that a worker lease was requested for.
+  /// \param backlog_size The number of tasks that the owner has queued with the
+  /// same resource shape, including this one.
+  void PrestartWorkers(const TaskSpecification &task_spec, int64_t backlog_size);
+
+  /// Size the buffer of prestarted idle workers from recent demand. This should be
+  /// called periodically. It starts workers if the pool has fewer idle workers than
+  /// PopWorker missed during recent demand periods, and picks prestarted workers
+  /// that have been idle for longer than prestarted_worker_idle_timeout_ms, and that
+  /// recent demand does not call for, to be killed.
+  ///
+  /// \param now_ms The current time in milliseconds.
+  /// \return The idle workers to kill. They have been removed from the pool, and the
+  /// caller is responsible for killing them.
+  std::vector<std::shared_ptr<WorkerInterface>> MaintainIdleWorkers(int64_t now_ms);
+
   /// Return the current size of the worker pool for the requested language. Counts only
   /// idle workers.
   ///
@@ -222,6 +248,14 @@ class WorkerPool : public WorkerPoolInterface {
   /// \return An object representing the started worker process.
   virtual Process StartProcess(const std::vector<std::string> &worker_command_args);
 
+  /// Ask the Python worker fork server to fork a new worker process. The new
+  /// process runs the Python worker command, without dynamic options.
+  ///
+  /// \return An object representing the forked worker process, or a null process
+  /// if the fork server is disabled, not ready yet, or failed. In that case, the
+  /// caller should start the worker process with StartProcess instead.
+  virtual Process ForkWorkerProcess();
+
   /// Push an warning message to user if worker pool is getting to big.
   virtual void WarnAboutSize();
 
@@ -251,6 +285,23 @@ class WorkerPool : public WorkerPoolInterface {
     std::unordered_map<Process, TaskID> dedicated_workers_to_tasks;
     /// A map for speeding up looking up the pending worker for the given task.
     std::unordered_map<TaskID, Process> tasks_to_dedicated_workers;
+    /// Worker processes that were started ahead of demand and have not
+    /// registered all their workers yet.
+    std::unordered_set<Process> prestarting_processes;
+    /// Workers that were started ahead of demand and have never been popped,
+    /// mapped to the time in ms at which they became idle, or 0 if they have not
+    /// been pushed yet.
+    std::unordered_map<std::shared_ptr<WorkerInterface>, int64_t> prestarted_workers;
+    /// The number of distinct non-actor tasks for which PopWorker found no idle
+    /// worker in each of the recent, completed demand periods, oldest first.
+    std::deque<int64_t> missed_pops;
+    /// The non-actor tasks for which PopWorker found no idle worker in the
+    /// current demand period.
+    std::unordered_set<TaskID> missed_tasks;
+    /// Tasks that found no idle worker and are waiting for a prestarted worker
+    /// instead of starting a new process. Each prestarted worker that has not
+    /// been pushed yet covers one of them.
+    std::unordered_set<TaskID> tasks_waiting_for_prestarted_workers;
     /// We'll push a warning to the user every time a multiple of this many
     /// worker processes has been started.
     int multiple_for_warning;
@@ -273,6 +324,28 @@ class WorkerPool : public WorkerPoolInterface {
   /// for a given language.
   State &GetStateForLanguage(const Language &language);
 
+  /// Start worker processes until the pool has at least the given number of idle
+  /// and starting non-actor workers of a language, or until the startup
+  /// concurrency limit is reached.
+  ///
+  /// \param language The language of the workers to start.
+  /// \param num_workers The number of idle and starting workers to have.
+  void PrestartIdleWorkers(const Language &language, int64_t num_workers);
+
+  /// Return the number of workers that were started ahead of demand and have not
+  /// been pushed to the pool yet.
+  ///
+  /// \param state The pool state of a language.
+  size_t NumPrestartingWorkers(const State &state) const;
+
+  /// Start the Python worker fork server. It listens on fork_server_socket_name_
+  /// once it has imported Ray. This is called along with the first Python worker.
+  /// If the constructor starts that worker, the fork server is started by
+  /// WorkerPool::StartProcess even if a subclass overrides it.
+  ///
+  /// \param worker_command_args The command with which Python workers are started.
+  void StartForkServer(const std::vector<std::string> &worker_command_args);
+
   /// Start a timer to monitor the starting worker process.
   ///
   /// If any workers in this process don't register within the timeout
@@ -306,6 +379,15 @@ class WorkerPool : public WorkerPoolInterface {
   std::unordered_map<std::string, std::string> raylet_config_;
   /// The callback that will be triggered once it times out to start a worker.
   std::function<void()> starting_worker_timeout_callback_;
+  /// The time in ms at which the current demand period started.
+  int64_t demand_period_start_ms_ = 0;
+  /// The path of the socket on which the Python worker fork server listens.
+  /// Empty if the fork server is disabled.
+  std::string fork_server_socket_name_;
+  /// The Python worker fork server process.
+  Process fork_server_;
+  /// Our connection to the fork server, or -1 if we have not connected yet.
+  int fork_server_fd_ = -1;
   FRIEND_TEST(WorkerPoolTest, InitialWorkerProcessCount);
 };
 
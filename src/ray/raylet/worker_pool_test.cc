@@ -17,6 +17,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ray/common/constants.h"
+#include "ray/common/ray_config.h"
 #include "ray/raylet/node_manager.h"
 #include "ray/util/process.h"
 
@@ -39,9 +40,10 @@ class WorkerPoolMock : public WorkerPool {
               {"dummy_java_worker_command", "RAY_WORKER_RAYLET_CONFIG_PLACEHOLDER"}}}) {}
 
   explicit WorkerPoolMock(boost::asio::io_service &io_service,
-                          const WorkerCommandMap &worker_commands)
+                          const WorkerCommandMap &worker_commands,
+                          const std::string &fork_server_socket_name = "")
       : WorkerPool(io_service, 0, MAXIMUM_STARTUP_CONCURRENCY, 0, 0, nullptr,
-                   worker_commands, {}, []() {}),
+                   worker_commands, {}, fork_server_socket_name, []() {}),
         last_worker_process_() {
     states_by_lang_[ray::Language::JAVA].num_workers_per_process =
         NUM_WORKERS_PER_PROCESS_JAVA;
@@ -62,6 +64,13 @@ class WorkerPoolMock : public WorkerPool {
     return last_worker_process_;
   }
 
+  Process ForkWorkerProcess() override {
+    pid_t pid = static_cast<pid_t>(PID_MAX_LIMIT + 1 + worker_commands_by_proc_.size());
+    last_worker_process_ = Process::FromPid(pid);
+    worker_commands_by_proc_[last_worker_process_] = {"forked"};
+    return last_worker_process_;
+  }
+
   void WarnAboutSize() override {}
 
   Process LastStartedWorkerProcess() const { return last_worker_process_; }
@@ -125,9 +134,19 @@ class WorkerPoolTest : public ::testing::Test {
     return worker;
   }
 
-  void SetWorkerCommands(const WorkerCommandMap &worker_commands) {
-    worker_pool_ =
-        std::unique_ptr<WorkerPoolMock>(new WorkerPoolMock(io_service_, worker_commands));
+  /// Register a worker of the given process and add it to the idle pool.
+  std::shared_ptr<WorkerInterface> RegisterAndPushWorker(Process proc) {
+    auto worker = CreateWorker(Process());
+    int port;
+    RAY_CHECK_OK(worker_pool_->RegisterWorker(worker, proc.GetId(), &port));
+    worker_pool_->PushWorker(worker);
+    return worker;
+  }
+
+  void SetWorkerCommands(const WorkerCommandMap &worker_commands,
+                         const std::string &fork_server_socket_name = "") {
+    worker_pool_ = std::unique_ptr<WorkerPoolMock>(
+        new WorkerPoolMock(io_service_, worker_commands, fork_server_socket_name));
   }
 
   void TestStartupWorkerProcessCount(Language language, int num_workers_per_process,
@@ -342,6 +361,196 @@ TEST_F(WorkerPoolTest, StartWorkerWithDynamicOptionsCommand) {
                  "-Dray.raylet.config.num_workers_per_process_java=1", "test_op_1"}));
 }
 
+TEST_F(WorkerPoolTest, StartPythonWorkersFromForkServer) {
+  const std::string socket_name = "/tmp/dummy_fork_server_socket";
+  const std::vector<std::string> py_worker_command = {"dummy_py_worker_command"};
+  const std::vector<std::string> forked = {"forked"};
+  SetWorkerCommands(
+      {{Language::PYTHON, py_worker_command},
+       {Language::JAVA,
+        {"dummy_java_worker_command", "RAY_WORKER_RAYLET_CONFIG_PLACEHOLDER"}}},
+      socket_name);
+
+  // The first Python worker is started by exec, right after the fork server.
+  worker_pool_->StartWorkerProcess(Language::PYTHON);
+  ASSERT_EQ(worker_pool_->GetWorkerCommand(worker_pool_->LastStartedWorkerProcess()),
+            py_worker_command);
+  Process fork_server = Process::FromPid(static_cast<pid_t>(PID_MAX_LIMIT + 1));
+  ASSERT_EQ(worker_pool_->GetWorkerCommand(fork_server),
+            std::vector<std::string>(
+                {"dummy_py_worker_command", "--fork-server-socket=" + socket_name}));
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+
+  // Later Python workers are forked.
+  worker_pool_->StartWorkerProcess(Language::PYTHON);
+  ASSERT_EQ(worker_pool_->GetWorkerCommand(worker_pool_->LastStartedWorkerProcess()),
+            forked);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+
+  // Workers with dynamic options and workers of other languages are started by exec.
+  worker_pool_->StartWorkerProcess(Language::PYTHON, {"test_op"});
+  ASSERT_NE(worker_pool_->GetWorkerCommand(worker_pool_->LastStartedWorkerProcess()),
+            forked);
+  worker_pool_->StartWorkerProcess(Language::JAVA);
+  ASSERT_NE(worker_pool_->GetWorkerCommand(worker_pool_->LastStartedWorkerProcess()),
+            forked);
+}
+
+class WorkerPoolPrestartTest : public WorkerPoolTest {
+ public:
+  void SetUp() override {
+    RayConfig::instance().initialize({{"max_prestarted_idle_workers", "4"},
+                                      {"worker_demand_period_ms", "1000"},
+                                      {"prestarted_worker_idle_timeout_ms", "10000"}});
+  }
+
+  void TearDown() override {
+    RayConfig::instance().initialize({{"max_prestarted_idle_workers", "0"}});
+  }
+
+  /// The process that the mock pool started n-th, counting from 0.
+  Process NthStartedProcess(int n) {
+    return Process::FromPid(static_cast<pid_t>(PID_MAX_LIMIT + 1 + n));
+  }
+
+  /// A normal task with a task ID of its own.
+  TaskSpecification NewTaskSpec() {
+    rpc::TaskSpec message;
+    message.set_language(Language::PYTHON);
+    message.set_type(TaskType::NORMAL_TASK);
+    message.set_task_id(TaskID::ForFakeTask().Binary());
+    return TaskSpecification(std::move(message));
+  }
+};
+
+TEST_F(WorkerPoolPrestartTest, PrestartWorkersForBacklog) {
+  const auto task_spec = ExampleTaskSpec();
+  // Actor tasks run on their actor's worker, so nothing is prestarted for them.
+  const auto job_id = JobID::FromInt(1);
+  worker_pool_->PrestartWorkers(
+      ExampleTaskSpec(ActorID::Of(job_id, TaskID::ForDriverTask(job_id), 1)), 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 0);
+
+  worker_pool_->PrestartWorkers(task_spec, 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  // Starting workers count toward the backlog.
+  worker_pool_->PrestartWorkers(task_spec, 2);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  // A PopWorker miss waits for the prestarted workers instead of starting another.
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), nullptr);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  // Idle workers count toward the backlog too.
+  RegisterAndPushWorker(NthStartedProcess(0));
+  worker_pool_->PrestartWorkers(task_spec, 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  // The number of prestarted workers is capped.
+  worker_pool_->PrestartWorkers(task_spec, 100);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+}
+
+TEST_F(WorkerPoolPrestartTest, KillIdlePrestartedWorkers) {
+  const auto task_spec = ExampleTaskSpec();
+  int64_t now_ms = current_time_ms();
+  ASSERT_TRUE(worker_pool_->MaintainIdleWorkers(now_ms).empty());
+
+  // A worker started on demand, and two started ahead of demand.
+  worker_pool_->StartWorkerProcess(Language::PYTHON);
+  worker_pool_->PrestartWorkers(task_spec, 3);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 3);
+  auto worker = RegisterAndPushWorker(NthStartedProcess(0));
+  RegisterAndPushWorker(NthStartedProcess(1));
+  RegisterAndPushWorker(NthStartedProcess(2));
+
+  // Prestarted workers are kept until they have been idle for the timeout.
+  now_ms += 1000;
+  ASSERT_TRUE(worker_pool_->MaintainIdleWorkers(now_ms).empty());
+  now_ms += 10000;
+  auto killed = worker_pool_->MaintainIdleWorkers(now_ms);
+  ASSERT_EQ(killed.size(), 2);
+  ASSERT_EQ(std::count(killed.begin(), killed.end(), worker), 0);
+  ASSERT_EQ(worker_pool_->Size(Language::PYTHON), 1);
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), worker);
+}
+
+TEST_F(WorkerPoolPrestartTest, PrestartWorkersForRecentDemand) {
+  const auto task_spec = NewTaskSpec();
+  int64_t now_ms = current_time_ms();
+  worker_pool_->MaintainIdleWorkers(now_ms);
+
+  // A burst of two tasks misses the pool.
+  const auto task_spec_2 = NewTaskSpec();
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec), nullptr);
+  ASSERT_EQ(worker_pool_->PopWorker(task_spec_2), nullptr);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  RegisterAndPushWorker(NthStartedProcess(0));
+  RegisterAndPushWorker(NthStartedProcess(1));
+  ASSERT_NE(worker_pool_->PopWorker(task_spec), nullptr);
+  ASSERT_NE(worker_pool_->PopWorker(task_spec_2), nullptr);
+
+  // The pool keeps two idle workers ready for the next burst.
+  now_ms += 1000;
+  worker_pool_->MaintainIdleWorkers(now_ms);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  RegisterAndPushWorker(NthStartedProcess(2));
+  RegisterAndPushWorker(NthStartedProcess(3));
+  now_ms += 1000;
+  worker_pool_->MaintainIdleWorkers(now_ms);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 0);
+
+  // They are not killed while the burst is recent, even if they stay idle.
+  now_ms += 10000;
+  ASSERT_TRUE(worker_pool_->MaintainIdleWorkers(now_ms).empty());
+  // Once the burst is older than the idle timeout, they are.
+  size_t num_killed = 0;
+  for (int i = 0; i < 10; i++) {
+    now_ms += 1000;
+    num_killed += worker_pool_->MaintainIdleWorkers(now_ms).size();
+  }
+  ASSERT_EQ(num_killed, 2);
+  ASSERT_EQ(worker_pool_->Size(Language::PYTHON), 0);
+}
+
+TEST_F(WorkerPoolPrestartTest, StartWorkersForTasksNotCoveredByPrestarted) {
+  worker_pool_->PrestartWorkers(NewTaskSpec(), 2);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  // The first two tasks that miss the pool wait for the prestarted workers.
+  std::vector<TaskSpecification> task_specs;
+  for (int i = 0; i < 4; i++) {
+    task_specs.push_back(NewTaskSpec());
+  }
+  ASSERT_EQ(worker_pool_->PopWorker(task_specs[0]), nullptr);
+  ASSERT_EQ(worker_pool_->PopWorker(task_specs[1]), nullptr);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  // Retrying a waiting task does not start a worker either.
+  ASSERT_EQ(worker_pool_->PopWorker(task_specs[0]), nullptr);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 2);
+  // Tasks beyond the prestarted workers start workers on demand.
+  ASSERT_EQ(worker_pool_->PopWorker(task_specs[2]), nullptr);
+  ASSERT_EQ(worker_pool_->PopWorker(task_specs[3]), nullptr);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 4);
+}
+
+TEST_F(WorkerPoolPrestartTest, CountRetriedPopsOnce) {
+  int64_t now_ms = current_time_ms();
+  worker_pool_->MaintainIdleWorkers(now_ms);
+  worker_pool_->PrestartWorkers(NewTaskSpec(), 1);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+
+  // The same task is retried many times while it waits for a worker.
+  const auto task_spec = NewTaskSpec();
+  for (int i = 0; i < 5; i++) {
+    ASSERT_EQ(worker_pool_->PopWorker(task_spec), nullptr);
+  }
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+  RegisterAndPushWorker(NthStartedProcess(0));
+  ASSERT_NE(worker_pool_->PopWorker(task_spec), nullptr);
+
+  // Only one task missed the pool, so only one worker is kept ready.
+  now_ms += 1000;
+  worker_pool_->MaintainIdleWorkers(now_ms);
+  ASSERT_EQ(worker_pool_->NumWorkerProcessesStarting(), 1);
+}
+
 }  // namespace raylet
 
 }  // namespace ray
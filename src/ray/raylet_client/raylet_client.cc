@@ -298,9 +298,17 @@ Status raylet::RayletClient::SetResource(const std::string &resource_name,
 
 Status raylet::RayletClient::RequestWorkerLease(
     const TaskSpecification &resource_spec,
-    const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback) {
+    const rpc::ClientCallback<rpc::RequestWorkerLeaseReply> &callback,
+    int64_t backlog_size,
+    const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) {
   rpc::RequestWorkerLeaseRequest request;
   request.mutable_resource_spec()->CopyFrom(resource_spec.GetMessage());
+  request.set_backlog_size(backlog_size);
+  for (const auto &entry : arg_bytes_by_node) {
+    auto arg_bytes = request.add_arg_bytes_by_node();
+    arg_bytes->set_node_id(entry.first.Binary());
+    arg_bytes->set_num_bytes(entry.second);
+  }
   return grpc_client_->RequestWorkerLease(request, callback);
 }
 
@@ -59,10 +59,17 @@ class WorkerLeaseInterface {
  public:
   /// Requests a worker from the raylet. The callback will be sent via gRPC.
   /// \param resource_spec Resources that should be allocated for the worker.
+  /// \param callback The callback to call with the reply.
+  /// \param backlog_size The number of tasks that the caller has queued with the same
+  /// scheduling class, including this one.
+  /// \param arg_bytes_by_node The number of bytes of the task's plasma arguments
+  /// that are stored on each node, as far as the caller knows.
   /// \return ray::Status
   virtual ray::Status RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
-      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback) = 0;
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
+      int64_t backlog_size,
+      const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) = 0;
 
   /// Returns a worker to the raylet.
   /// \param worker_port The local port of the worker on the raylet node.
@@ -320,8 +327,9 @@ class RayletClient : public PinObjectsInterface,
   /// Implements WorkerLeaseInterface.
   ray::Status RequestWorkerLease(
       const ray::TaskSpecification &resource_spec,
-      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback)
-      override;
+      const ray::rpc::ClientCallback<ray::rpc::RequestWorkerLeaseReply> &callback,
+      int64_t backlog_size,
+      const std::unordered_map<ClientID, int64_t> &arg_bytes_by_node) override;
 
   /// Implements WorkerLeaseInterface.
   ray::Status ReturnWorker(int worker_port, const WorkerID &worker_id,
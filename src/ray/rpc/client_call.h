@@ -220,6 +220,9 @@ class ClientCallManager {
     return call;
   }
 
+  /// Get the main event loop, to which the callback functions are posted.
+  boost::asio::io_service &GetMainService() { return main_service_; }
+
  private:
   /// This function runs in a background thread. It keeps polling events from the
   /// `CompletionQueue`, and dispatches the event to the callbacks via the `ClientCall`
@@ -22,6 +22,9 @@
 
 #include <grpcpp/grpcpp.h>
 
+#include <algorithm>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -29,6 +32,8 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/hash/hash.h"
+#include "ray/common/id.h"
+#include "ray/common/ray_config.h"
 #include "ray/common/status.h"
 #include "ray/rpc/grpc_client.h"
 #include "ray/util/logging.h"
@@ -219,7 +224,12 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   /// \param[in] port Port of the worker server.
   /// \param[in] client_call_manager The `ClientCallManager` used for managing requests.
   CoreWorkerClient(const rpc::Address &address, ClientCallManager &client_call_manager)
-      : addr_(address) {
+      : addr_(address),
+        max_batch_size_(
+            std::max<int64_t>(RayConfig::instance().max_push_task_batch_size(), 1)),
+        max_batch_bytes_(RayConfig::instance().max_push_task_batch_bytes()),
+        batch_linger_us_(RayConfig::instance().push_task_batch_linger_us()),
+        batch_timer_(client_call_manager.GetMainService()) {
     grpc_client_ =
         std::unique_ptr<GrpcClient<CoreWorkerService>>(new GrpcClient<CoreWorkerService>(
             addr_.ip_address(), addr_.port(), client_call_manager));
@@ -259,15 +269,23 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
       // processing this request. We could also set it to max_finished_seq_no_,
       // but we just set it to the default of -1 to avoid taking the lock.
       request->set_client_processed_up_to(-1);
-      return INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, callback,
-                             grpc_client_);
+      return CallPushTask(*request, callback);
     }
 
+    bool send_now = true;
     {
       absl::MutexLock lock(&mutex_);
+      send_queue_bytes_ += RequestSizeInBytes(*request);
       send_queue_.push_back(std::make_pair(std::move(request), callback));
+      if (max_batch_size_ > 1 && !IsBatchFull(send_queue_.size(), send_queue_bytes_)) {
+        // Wait for more tasks to batch with this one.
+        ScheduleFlush();
+        send_now = false;
+      }
+    }
+    if (send_now) {
+      SendRequests();
     }
-    SendRequests();
     return ray::Status::OK();
   }
 
@@ -275,7 +293,24 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
                              const ClientCallback<PushTaskReply> &callback) override {
     request->set_sequence_number(-1);
     request->set_client_processed_up_to(-1);
-    return INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, callback, grpc_client_);
+    if (max_batch_size_ == 1) {
+      return CallPushTask(*request, callback);
+    }
+
+    bool send_now = true;
+    {
+      absl::MutexLock lock(&mutex_);
+      normal_send_queue_bytes_ += RequestSizeInBytes(*request);
+      normal_send_queue_.push_back(std::make_pair(std::move(request), callback));
+      if (!IsBatchFull(normal_send_queue_.size(), normal_send_queue_bytes_)) {
+        ScheduleFlush();
+        send_now = false;
+      }
+    }
+    if (send_now) {
+      SendNormalTasks();
+    }
+    return ray::Status::OK();
   }
 
   /// Send as many pending tasks as possible. This method is thread-safe.
@@ -288,32 +323,27 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     auto this_ptr = this->shared_from_this();
 
     while (!send_queue_.empty() && rpc_bytes_in_flight_ < kMaxBytesInFlight) {
-      auto pair = std::move(*send_queue_.begin());
-      send_queue_.pop_front();
-
-      auto request = std::move(pair.first);
-      auto callback = pair.second;
-      int64_t task_size = RequestSizeInBytes(*request);
-      int64_t seq_no = request->sequence_number();
-      request->set_client_processed_up_to(max_finished_seq_no_);
-      rpc_bytes_in_flight_ += task_size;
-
-      auto rpc_callback = [this, this_ptr, seq_no, task_size, callback](
-                              Status status, const rpc::PushTaskReply &reply) {
+      int64_t batch_bytes = 0;
+      auto batch = TakeBatch(&send_queue_, &send_queue_bytes_, &batch_bytes);
+      int64_t seq_no = -1;
+      for (auto &entry : batch) {
+        entry.first->set_client_processed_up_to(max_finished_seq_no_);
+        seq_no = std::max(seq_no, entry.first->sequence_number());
+      }
+      rpc_bytes_in_flight_ += batch_bytes;
+
+      auto on_reply = [this, this_ptr, seq_no, batch_bytes]() {
         {
           absl::MutexLock lock(&mutex_);
           if (seq_no > max_finished_seq_no_) {
             max_finished_seq_no_ = seq_no;
           }
-          rpc_bytes_in_flight_ -= task_size;
+          rpc_bytes_in_flight_ -= batch_bytes;
           RAY_CHECK(rpc_bytes_in_flight_ >= 0);
         }
         SendRequests();
-        callback(status, reply);
       };
-
-      RAY_UNUSED(INVOKE_RPC_CALL(CoreWorkerService, PushTask, *request, rpc_callback,
-                                 grpc_client_));
+      SendBatch(std::move(batch), on_reply);
     }
 
     if (!send_queue_.empty()) {
@@ -321,7 +351,133 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
     }
   }
 
+ protected:
+  /// Send one task in a PushTask request. This is virtual for testing.
+  virtual ray::Status CallPushTask(const PushTaskRequest &request,
+                                   const ClientCallback<PushTaskReply> &callback) {
+    return INVOKE_RPC_CALL(CoreWorkerService, PushTask, request, callback,
+                           grpc_client_);
+  }
+
+  /// Send a batch of tasks in a PushTasks request. This is virtual for testing.
+  virtual ray::Status CallPushTasks(const PushTasksRequest &request,
+                                    const ClientCallback<PushTasksReply> &callback) {
+    return INVOKE_RPC_CALL(CoreWorkerService, PushTasks, request, callback,
+                           grpc_client_);
+  }
+
  private:
+  typedef std::deque<
+      std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>>
+      PushTaskQueue;
+
+  /// Whether a queue has enough tasks to send a batch without waiting for more.
+  bool IsBatchFull(size_t num_tasks, int64_t num_bytes) const {
+    return static_cast<int64_t>(num_tasks) >= max_batch_size_ ||
+           num_bytes >= max_batch_bytes_;
+  }
+
+  /// Take the next batch of tasks off the front of a queue.
+  ///
+  /// \param[in] queue The queue to take the tasks from.
+  /// \param[in] queue_bytes The estimated size of the queue, which is updated.
+  /// \param[out] batch_bytes The estimated size of the batch.
+  /// \return The batch, which has at least one task.
+  PushTaskQueue TakeBatch(PushTaskQueue *queue, int64_t *queue_bytes,
+                          int64_t *batch_bytes) EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    PushTaskQueue batch;
+    *batch_bytes = 0;
+    while (!queue->empty() && static_cast<int64_t>(batch.size()) < max_batch_size_) {
+      int64_t task_size = RequestSizeInBytes(*queue->front().first);
+      if (!batch.empty() && *batch_bytes + task_size > max_batch_bytes_) {
+        break;
+      }
+      batch.push_back(std::move(queue->front()));
+      queue->pop_front();
+      *queue_bytes -= task_size;
+      *batch_bytes += task_size;
+    }
+    return batch;
+  }
+
+  /// Send all queued normal tasks.
+  void SendNormalTasks() {
+    absl::MutexLock lock(&mutex_);
+    while (!normal_send_queue_.empty()) {
+      int64_t batch_bytes = 0;
+      auto batch =
+          TakeBatch(&normal_send_queue_, &normal_send_queue_bytes_, &batch_bytes);
+      SendBatch(std::move(batch), []() {});
+    }
+  }
+
+  /// Send the queued tasks after the linger time, unless they have been sent by
+  /// then.
+  void ScheduleFlush() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (flush_scheduled_) {
+      return;
+    }
+    flush_scheduled_ = true;
+    auto this_ptr = this->shared_from_this();
+    batch_timer_.expires_from_now(std::chrono::microseconds(batch_linger_us_));
+    batch_timer_.async_wait([this, this_ptr](const boost::system::error_code &error) {
+      {
+        absl::MutexLock lock(&mutex_);
+        flush_scheduled_ = false;
+      }
+      SendRequests();
+      SendNormalTasks();
+    });
+  }
+
+  /// Send a batch of tasks in one PushTasks request. A single task is sent in a
+  /// PushTask request instead.
+  ///
+  /// \param[in] batch The tasks to send.
+  /// \param[in] on_reply Called when the reply is received, before the callbacks of
+  /// the tasks.
+  void SendBatch(PushTaskQueue batch, const std::function<void()> &on_reply)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (batch.size() == 1) {
+      auto callback = batch.front().second;
+      auto rpc_callback = [on_reply, callback](const Status &status,
+                                               const PushTaskReply &reply) {
+        on_reply();
+        callback(status, reply);
+      };
+      RAY_UNUSED(CallPushTask(*batch.front().first, rpc_callback));
+      return;
+    }
+
+    PushTasksRequest request;
+    std::vector<ClientCallback<PushTaskReply>> callbacks;
+    for (auto &entry : batch) {
+      request.add_requests()->Swap(entry.first.get());
+      callbacks.push_back(entry.second);
+    }
+    auto rpc_callback = [on_reply, callbacks](const Status &status,
+                                              const PushTasksReply &reply) {
+      on_reply();
+      Status batch_status = status;
+      if (batch_status.ok() &&
+          reply.results_size() != static_cast<int>(callbacks.size())) {
+        batch_status = Status::IOError("Received the wrong number of task results");
+      }
+      for (size_t i = 0; i < callbacks.size(); i++) {
+        if (!batch_status.ok()) {
+          callbacks[i](batch_status, PushTaskReply());
+          continue;
+        }
+        const auto &result = reply.results(i);
+        const auto code = static_cast<StatusCode>(result.status_code());
+        callbacks[i](
+            code == StatusCode::OK ? Status::OK() : Status(code, result.status_message()),
+            result.reply());
+      }
+    };
+    RAY_UNUSED(CallPushTasks(request, rpc_callback));
+  }
+
   /// Protects against unsafe concurrent access from the callback thread.
   absl::Mutex mutex_;
 
@@ -332,14 +488,37 @@ class CoreWorkerClient : public std::enable_shared_from_this<CoreWorkerClient>,
   std::unique_ptr<GrpcClient<CoreWorkerService>> grpc_client_;
 
   /// Queue of requests to send.
-  std::deque<std::pair<std::unique_ptr<PushTaskRequest>, ClientCallback<PushTaskReply>>>
-      send_queue_ GUARDED_BY(mutex_);
+  PushTaskQueue send_queue_ GUARDED_BY(mutex_);
 
   /// The number of bytes currently in flight.
   int64_t rpc_bytes_in_flight_ GUARDED_BY(mutex_) = 0;
 
   /// The max sequence number we have processed responses for.
   int64_t max_finished_seq_no_ GUARDED_BY(mutex_) = -1;
+
+  /// The estimated size of the tasks in send_queue_.
+  int64_t send_queue_bytes_ GUARDED_BY(mutex_) = 0;
+
+  /// Queue of normal tasks to send in the next batch.
+  PushTaskQueue normal_send_queue_ GUARDED_BY(mutex_);
+
+  /// The estimated size of the tasks in normal_send_queue_.
+  int64_t normal_send_queue_bytes_ GUARDED_BY(mutex_) = 0;
+
+  /// The maximum number of tasks per request. If 1, tasks are not batched.
+  const int64_t max_batch_size_;
+
+  /// The maximum estimated size of a batch.
+  const int64_t max_batch_bytes_;
+
+  /// How long to wait for more tasks before sending a batch that is not full.
+  const int64_t batch_linger_us_;
+
+  /// Sends the queued tasks once the linger time is up.
+  boost::asio::steady_timer batch_timer_ GUARDED_BY(mutex_);
+
+  /// Whether batch_timer_ is set.
+  bool flush_scheduled_ GUARDED_BY(mutex_) = false;
 };
 
 }  // namespace rpc
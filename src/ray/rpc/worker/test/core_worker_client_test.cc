@@ -0,0 +1,267 @@
+// Copyright 2017 The Ray Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray/rpc/worker/core_worker_client.h"
+
+#include "gtest/gtest.h"
+
+namespace ray {
+namespace rpc {
+
+/// A client that records the requests that it sends, instead of sending them to
+/// a worker.
+class MockCoreWorkerClient : public CoreWorkerClient {
+ public:
+  MockCoreWorkerClient(ClientCallManager &client_call_manager)
+      : CoreWorkerClient(rpc::Address(), client_call_manager) {}
+
+  /// The sequence numbers of the tasks in each request sent so far.
+  std::vector<std::vector<int64_t>> sent;
+  /// The client_processed_up_to of the last task in each request sent so far.
+  std::vector<int64_t> processed_up_to;
+  /// The callbacks of the PushTasks requests that have not been replied to.
+  std::list<ClientCallback<PushTasksReply>> batch_callbacks;
+  /// The callbacks of the PushTask requests that have not been replied to.
+  std::list<ClientCallback<PushTaskReply>> callbacks;
+
+  bool ReplyPushTasks(const PushTasksReply &reply, Status status = Status::OK()) {
+    if (batch_callbacks.empty()) {
+      return false;
+    }
+    auto callback = batch_callbacks.front();
+    batch_callbacks.pop_front();
+    callback(status, reply);
+    return true;
+  }
+
+ protected:
+  ray::Status CallPushTask(const PushTaskRequest &request,
+                           const ClientCallback<PushTaskReply> &callback) override {
+    sent.push_back({request.sequence_number()});
+    processed_up_to.push_back(request.client_processed_up_to());
+    callbacks.push_back(callback);
+    return Status::OK();
+  }
+
+  ray::Status CallPushTasks(const PushTasksRequest &request,
+                            const ClientCallback<PushTasksReply> &callback) override {
+    std::vector<int64_t> sequence_numbers;
+    for (const auto &task : request.requests()) {
+      sequence_numbers.push_back(task.sequence_number());
+    }
+    sent.push_back(sequence_numbers);
+    processed_up_to.push_back(
+        request.requests(request.requests_size() - 1).client_processed_up_to());
+    batch_callbacks.push_back(callback);
+    return Status::OK();
+  }
+};
+
+/// Build a task whose estimated size is kBaseRequestSize plus arg_bytes.
+std::unique_ptr<PushTaskRequest> BuildRequest(int64_t sequence_number = -1,
+                                              size_t arg_bytes = 0) {
+  std::unique_ptr<PushTaskRequest> request(new PushTaskRequest());
+  request->set_sequence_number(sequence_number);
+  request->mutable_task_spec()->add_args()->set_data(std::string(arg_bytes, 'x'));
+  return request;
+}
+
+class CoreWorkerClientTest : public ::testing::Test {
+ public:
+  CoreWorkerClientTest() : client_call_manager_(io_service_) {}
+
+  void TearDown() override {
+    RayConfig::instance().initialize({{"max_push_task_batch_size", "1"},
+                                      {"max_push_task_batch_bytes", "1048576"},
+                                      {"push_task_batch_linger_us", "100"}});
+  }
+
+ protected:
+  /// Create a client with the given batching config.
+  std::shared_ptr<MockCoreWorkerClient> MakeClient(int64_t batch_size,
+                                                   int64_t batch_bytes,
+                                                   int64_t linger_us) {
+    RayConfig::instance().initialize(
+        {{"max_push_task_batch_size", std::to_string(batch_size)},
+         {"max_push_task_batch_bytes", std::to_string(batch_bytes)},
+         {"push_task_batch_linger_us", std::to_string(linger_us)}});
+    return std::make_shared<MockCoreWorkerClient>(client_call_manager_);
+  }
+
+  /// Run the event loop until the pending batch timer has fired.
+  void RunLinger() {
+    io_service_.run();
+    io_service_.reset();
+  }
+
+  /// Push a normal task and record the status and reply that it gets.
+  void PushNormalTask(const std::shared_ptr<MockCoreWorkerClient> &client,
+                      size_t arg_bytes = 0) {
+    int index = statuses_.size();
+    statuses_.push_back(Status::NotImplemented("no reply"));
+    replies_.emplace_back();
+    RAY_CHECK_OK(client->PushNormalTask(
+        BuildRequest(-1, arg_bytes),
+        [this, index](const Status &status, const PushTaskReply &reply) {
+          statuses_[index] = status;
+          replies_[index] = reply;
+        }));
+  }
+
+  boost::asio::io_service io_service_;
+  ClientCallManager client_call_manager_;
+  std::vector<Status> statuses_;
+  std::vector<PushTaskReply> replies_;
+};
+
+TEST_F(CoreWorkerClientTest, TestFlushOnBatchSize) {
+  auto client = MakeClient(/*batch_size=*/3, /*batch_bytes=*/1024 * 1024,
+                           /*linger_us=*/1000 * 1000);
+  PushNormalTask(client);
+  PushNormalTask(client);
+  ASSERT_TRUE(client->sent.empty());
+  // The third task fills the batch, so it is sent without waiting.
+  PushNormalTask(client);
+  ASSERT_EQ(client->sent.size(), 1);
+  ASSERT_EQ(client->sent[0].size(), 3);
+  ASSERT_EQ(client->batch_callbacks.size(), 1);
+
+  PushNormalTask(client);
+  ASSERT_EQ(client->sent.size(), 1);
+}
+
+TEST_F(CoreWorkerClientTest, TestFlushOnBatchBytes) {
+  const int64_t task_bytes = kBaseRequestSize + 1000;
+  auto client = MakeClient(/*batch_size=*/10, /*batch_bytes=*/2 * task_bytes,
+                           /*linger_us=*/1000 * 1000);
+  PushNormalTask(client, 1000);
+  ASSERT_TRUE(client->sent.empty());
+  // The second task brings the batch to its size limit.
+  PushNormalTask(client, 1000);
+  ASSERT_EQ(client->sent.size(), 1);
+  ASSERT_EQ(client->sent[0].size(), 2);
+
+  // A task that is larger than the limit is sent on its own.
+  PushNormalTask(client, 3 * task_bytes);
+  ASSERT_EQ(client->sent.size(), 2);
+  ASSERT_EQ(client->sent[1].size(), 1);
+  ASSERT_EQ(client->callbacks.size(), 1);
+}
+
+TEST_F(CoreWorkerClientTest, TestFlushOnLinger) {
+  auto client = MakeClient(/*batch_size=*/10, /*batch_bytes=*/1024 * 1024,
+                           /*linger_us=*/1000);
+  PushNormalTask(client);
+  ASSERT_TRUE(client->sent.empty());
+  // A single task is sent in a PushTask request once the linger time is up.
+  RunLinger();
+  ASSERT_EQ(client->sent.size(), 1);
+  ASSERT_EQ(client->callbacks.size(), 1);
+
+  PushNormalTask(client);
+  PushNormalTask(client);
+  ASSERT_EQ(client->sent.size(), 1);
+  RunLinger();
+  ASSERT_EQ(client->sent.size(), 2);
+  ASSERT_EQ(client->sent[1].size(), 2);
+  ASSERT_EQ(client->batch_callbacks.size(), 1);
+}
+
+TEST_F(CoreWorkerClientTest, TestReplyPerTask) {
+  auto client = MakeClient(/*batch_size=*/3, /*batch_bytes=*/1024 * 1024,
+                           /*linger_us=*/1000 * 1000);
+  for (int i = 0; i < 3; i++) {
+    PushNormalTask(client);
+  }
+
+  PushTasksReply reply;
+  for (int i = 0; i < 3; i++) {
+    auto result = reply.add_results();
+    result->mutable_reply()->set_handling_time_us(i);
+  }
+  reply.mutable_results(1)->set_status_code(static_cast<int>(StatusCode::IOError));
+  reply.mutable_results(1)->set_status_message("task failed");
+  reply.mutable_results(2)->mutable_reply()->set_worker_exiting(true);
+  ASSERT_TRUE(client->ReplyPushTasks(reply));
+
+  // Each task gets its own status and reply.
+  ASSERT_TRUE(statuses_[0].ok());
+  ASSERT_TRUE(statuses_[1].IsIOError());
+  ASSERT_EQ(statuses_[1].message(), "task failed");
+  ASSERT_TRUE(statuses_[2].ok());
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(replies_[i].handling_time_us(), i);
+  }
+  ASSERT_FALSE(replies_[0].worker_exiting());
+  ASSERT_TRUE(replies_[2].worker_exiting());
+}
+
+TEST_F(CoreWorkerClientTest, TestFailedBatchFailsEveryTask) {
+  auto client = MakeClient(/*batch_size=*/2, /*batch_bytes=*/1024 * 1024,
+                           /*linger_us=*/1000 * 1000);
+  for (int i = 0; i < 4; i++) {
+    PushNormalTask(client);
+  }
+  ASSERT_EQ(client->batch_callbacks.size(), 2);
+
+  // The RPC failed.
+  PushTasksReply reply;
+  reply.add_results();
+  reply.add_results();
+  ASSERT_TRUE(client->ReplyPushTasks(reply, Status::IOError("connection lost")));
+  ASSERT_TRUE(statuses_[0].IsIOError());
+  ASSERT_TRUE(statuses_[1].IsIOError());
+
+  // The reply does not have a result for every task.
+  reply.clear_results();
+  reply.add_results();
+  ASSERT_TRUE(client->ReplyPushTasks(reply));
+  ASSERT_TRUE(statuses_[2].IsIOError());
+  ASSERT_TRUE(statuses_[3].IsIOError());
+}
+
+TEST_F(CoreWorkerClientTest, TestActorTaskOrderAcrossBatches) {
+  auto client = MakeClient(/*batch_size=*/2, /*batch_bytes=*/1024 * 1024,
+                           /*linger_us=*/1000);
+  auto callback = [](const Status &status, const PushTaskReply &reply) {};
+  for (int64_t seq_no = 0; seq_no < 5; seq_no++) {
+    RAY_CHECK_OK(client->PushActorTask(BuildRequest(seq_no), /*skip_queue=*/false,
+                                       callback));
+  }
+  // The last task waits for the linger time.
+  ASSERT_EQ(client->sent, std::vector<std::vector<int64_t>>({{0, 1}, {2, 3}}));
+  RunLinger();
+  ASSERT_EQ(client->sent, std::vector<std::vector<int64_t>>({{0, 1}, {2, 3}, {4}}));
+  ASSERT_EQ(client->processed_up_to, std::vector<int64_t>({-1, -1, -1}));
+
+  // Once the first batch is done, later batches tell the actor that it does
+  // not have to wait for the tasks before it.
+  PushTasksReply reply;
+  reply.add_results();
+  reply.add_results();
+  ASSERT_TRUE(client->ReplyPushTasks(reply));
+  RAY_CHECK_OK(client->PushActorTask(BuildRequest(5), /*skip_queue=*/false, callback));
+  RAY_CHECK_OK(client->PushActorTask(BuildRequest(6), /*skip_queue=*/false, callback));
+  ASSERT_EQ(client->sent.size(), 4);
+  ASSERT_EQ(client->sent[3], std::vector<int64_t>({5, 6}));
+  ASSERT_EQ(client->processed_up_to[3], 1);
+}
+
+}  // namespace rpc
+}  // namespace ray
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
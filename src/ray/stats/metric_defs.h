@@ -46,6 +46,12 @@ static Gauge CurrentDriver("current_driver",
 static Count TaskCountReceived("task_count_received",
                                "Number of tasks received by raylet.", "pcs", {});
 
+static Sum TaskArgBytesPlacedLocally(
+    "task_arg_bytes_placed_locally",
+    "Bytes of task arguments that did not need to be transferred because the task was "
+    "placed on the node that stores them.",
+    "bytes", {});
+
 static Gauge LocalAvailableResource("local_available_resource",
                                     "The available resources on this node.", "pcs",
                                     {ResourceNameKey});
@@ -61,6 +67,16 @@ static Gauge ObjectManagerStats("object_manager_stats",
                                 "Stat the metric values of object in raylet", "pcs",
                                 {ValueTypeKey});
 
+static Histogram PlasmaEvictionLatency(
+    "plasma_eviction_latency",
+    "Time spent evicting objects from the plasma store. The ValueTypeKey tag is "
+    "blocking for evictions on the create path and background otherwise.",
+    "us", {10, 100, 1000, 10000, 100000, 1000000}, {ValueTypeKey});
+
+static Sum PlasmaBytesEvictedInBackground(
+    "plasma_bytes_evicted_in_background",
+    "Bytes evicted from the plasma store in the background.", "bytes", {});
+
 static Gauge LineageCacheStats("lineage_cache_stats",
                                "Stats the metric values of lineage cache.", "pcs",
                                {ValueTypeKey});